@@ -1,6 +1,8 @@
 
 #include <core/base_column.hpp>
 #include <core/column.hpp>
+#include <core/string_heap_column.hpp>
+#include <core/bit_packed_column.hpp>
 #include <iostream>
 
 using namespace std;
@@ -30,11 +32,9 @@ namespace CoGaDB{
 	}else if(type==FLOAT){
 		ptr=ColumnPtr(new Column<float>(name,FLOAT));
 	}else if(type==VARCHAR){
-		ptr=ColumnPtr(new Column<string>(name,VARCHAR));
+		ptr=ColumnPtr(new StringHeapColumn(name,VARCHAR));
 	}else if(type==BOOLEAN){
-		//ptr=ColumnPtr(new Column<bool>(name,BOOLEAN));
-		cout << "Fatal Error! invalid AttributeType: " << type << " for Column: " << name 
-			  << " Note: bool is currently not supported, will be added again in the future!"<< endl;
+		ptr=ColumnPtr(new BitPackedColumn(name,BOOLEAN));
 	}else{
 		cout << "Fatal Error! invalid AttributeType: " << type << " for Column: " << name << endl;
 	}
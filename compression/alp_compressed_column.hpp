@@ -0,0 +1,611 @@
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <boost/serialization/vector.hpp>
+
+#include <core/compressed_column.hpp>
+#include <core/decode_buffer.hpp>
+
+namespace CoGaDB {
+
+
+/*!
+ *  \brief     This class represents a compressed float or double column, which encodes decimal-like values as integers (adaptive lossless floating point compression).
+ *  \details   The rows are split into blocks of block_size values. For every block, an exponent e is chosen, such that most values v satisfy
+ *  v == round(v*10^e)/10^e exactly. These values are stored as integers round(v*10^e), minus the smallest integer of the block (frame of
+ *  reference), bit packed with the smallest possible bit width. All other values (e.g., NaN, infinity or values with too many decimal
+ *  digits) are stored unchanged as exceptions. Single values are decoded in constant time plus a binary search over the exceptions of
+ *  their block, decode() decodes whole blocks in tight loops, which the compiler vectorizes. Appended values are collected uncompressed
+ *  until a block is full.
+ */
+    template<class T>
+    class AlpCompressedColumn : public CompressedColumn<T> {
+    public:
+        static const unsigned int block_size = 1024;
+
+        /***************** constructors and destructor *****************/
+        AlpCompressedColumn(const std::string &name, AttributeType db_type);
+
+        virtual ~AlpCompressedColumn();
+
+        virtual bool insert(const boost::any &new_Value);
+
+        virtual bool insert(const T &new_value);
+
+        template<typename InputIterator>
+        bool insert(InputIterator first, InputIterator last);
+
+        virtual bool update(TID tid, const boost::any &new_value);
+
+        virtual bool update(PositionListPtr tid, const boost::any &new_value);
+
+        virtual bool remove(TID tid);
+
+        //assumes tid list is sorted ascending
+        virtual bool remove(PositionListPtr tid);
+
+        virtual bool clearContent();
+
+        virtual const boost::any get(TID tid);
+
+        virtual void print() const throw();
+
+        virtual size_t size() const throw();
+
+        virtual size_t getSizeinBytes() const throw();
+
+        virtual const ColumnPtr copy() const;
+
+        virtual const PositionListPtr selection(const boost::any &value_for_comparison, const ValueComparator comp);
+
+        virtual bool store(const std::string &path);
+
+        virtual bool load(const std::string &path);
+
+        virtual T &operator[](const TID index);
+
+        virtual void gather(const PositionList &tids, T *output);
+
+        virtual const PositionListPtr predicate_selection(const PredicateExpression<T> &predicate);
+
+        virtual void decodeRange(TID begin, TID end, T *output);
+
+        /*! \brief decodeRange() decodes into the output only, so several threads may call it*/
+        virtual bool supportsConcurrentReads() const;
+
+        /*! \brief returns the value on position tid*/
+        T decode(TID tid) const;
+
+        /*! \brief decodes the values on positions [begin,end) to output*/
+        void decode(TID begin, TID end, T *output) const;
+
+        /*! \brief number of values, which are stored as exceptions*/
+        size_t getNumberOfExceptions() const;
+
+    private:
+        struct Block {
+            Block() : base(0), exponent(0), bit_width(0), packed_values(), exception_positions(), exception_values() {
+            }
+
+            /*! smallest encoded integer of the block*/
+            int64_t base;
+            uint8_t exponent;
+            uint8_t bit_width;
+            /*! block_size values with bit_width bits each*/
+            std::vector<uint64_t> packed_values;
+            /*! sorted positions of the exceptions inside the block*/
+            std::vector<uint16_t> exception_positions;
+            std::vector<T> exception_values;
+
+            template<class Archive>
+            void serialize(Archive &ar, const unsigned int) {
+                ar & base;
+                ar & exponent;
+                ar & bit_width;
+                ar & packed_values;
+                ar & exception_positions;
+                ar & exception_values;
+            }
+        };
+
+        /*! \brief largest exponent, for which the integer encoding is tried*/
+        static unsigned int getMaxExponent();
+
+        static double getPowerOfTen(unsigned int exponent);
+
+        /*! \brief encodes value with exponent, returns false if value can not be restored exactly from the integer*/
+        static bool encodeValue(T value, unsigned int exponent, int64_t *encoded_value);
+
+        static T decodeValue(int64_t encoded_value, unsigned int exponent);
+
+        static uint64_t unpack(const std::vector<uint64_t> &packed_values, unsigned int bit_width, unsigned int position);
+
+        /*! \brief picks the exponent with the smallest estimated block size on a sample of the values*/
+        static unsigned int chooseExponent(const T *values, unsigned int number_of_values);
+
+        static Block compressBlock(const T *values);
+
+        static void decompressBlock(const Block &block, T *output);
+
+        /*! \brief decodes all blocks from block on into the tail and re-compresses them, used when rows are shifted*/
+        void decompressFrom(size_t block);
+
+        void compressTail();
+
+        std::vector<Block> blocks_;
+        /*! values after the last full block, not compressed yet*/
+        std::vector<T> tail_;
+        DecodeBuffer<T> decode_buffer_;
+    };
+
+    typedef AlpCompressedColumn<float> AlpCompressedFloatColumn;
+    typedef AlpCompressedColumn<double> AlpCompressedDoubleColumn;
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    template<class T>
+    const unsigned int AlpCompressedColumn<T>::block_size;
+
+    template<class T>
+    AlpCompressedColumn<T>::AlpCompressedColumn(const std::string &name, AttributeType db_type)
+            : CompressedColumn<T>(name, db_type), blocks_(), tail_(), decode_buffer_() {
+    }
+
+    template<class T>
+    AlpCompressedColumn<T>::~AlpCompressedColumn() {
+    }
+
+    template<class T>
+    unsigned int AlpCompressedColumn<T>::getMaxExponent() {
+        //a float has 7 to 8 significant decimal digits, a double 15 to 17
+        return sizeof(T) == sizeof(float) ? 10 : 18;
+    }
+
+    template<class T>
+    double AlpCompressedColumn<T>::getPowerOfTen(unsigned int exponent) {
+        //powers of ten up to 10^22 are exact in a double
+        static const double powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                               1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+        return powers_of_ten[exponent];
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::encodeValue(T value, unsigned int exponent, int64_t *encoded_value) {
+        double scaled_value = double(value) * getPowerOfTen(exponent);
+        //rejects NaN and infinity, integers up to 2^53 are exact in a double
+        if (!(std::fabs(scaled_value) < 9007199254740992.0)) return false;
+        *encoded_value = static_cast<int64_t>(std::llround(scaled_value));
+        T decoded_value = decodeValue(*encoded_value, exponent);
+        //compare the bits, so -0.0 is not encoded as 0.0
+        return std::memcmp(&decoded_value, &value, sizeof(T)) == 0;
+    }
+
+    template<class T>
+    T AlpCompressedColumn<T>::decodeValue(int64_t encoded_value, unsigned int exponent) {
+        return static_cast<T>(double(encoded_value) / getPowerOfTen(exponent));
+    }
+
+    template<class T>
+    uint64_t AlpCompressedColumn<T>::unpack(const std::vector<uint64_t> &packed_values, unsigned int bit_width, unsigned int position) {
+        if (bit_width == 0) return 0;
+        uint64_t bit_offset = uint64_t(position) * bit_width;
+        size_t word = bit_offset >> 6;
+        unsigned int shift = bit_offset & 63;
+        uint64_t value = packed_values[word] >> shift;
+        if (shift + bit_width > 64) {
+            value |= packed_values[word + 1] << (64 - shift);
+        }
+        if (bit_width == 64) return value;
+        return value & ((uint64_t(1) << bit_width) - 1);
+    }
+
+    template<class T>
+    unsigned int AlpCompressedColumn<T>::chooseExponent(const T *values, unsigned int number_of_values) {
+        const unsigned int sample_step = number_of_values < 32 ? 1 : number_of_values / 32;
+        unsigned int best_exponent = 0;
+        uint64_t best_size = std::numeric_limits<uint64_t>::max();
+        for (unsigned int exponent = 0; exponent <= getMaxExponent(); ++exponent) {
+            uint64_t number_of_exceptions = 0;
+            int64_t min_value = std::numeric_limits<int64_t>::max();
+            int64_t max_value = std::numeric_limits<int64_t>::min();
+            for (unsigned int i = 0; i < number_of_values; i += sample_step) {
+                int64_t encoded_value = 0;
+                if (encodeValue(values[i], exponent, &encoded_value)) {
+                    min_value = std::min(min_value, encoded_value);
+                    max_value = std::max(max_value, encoded_value);
+                } else {
+                    ++number_of_exceptions;
+                }
+            }
+            unsigned int bit_width = 0;
+            if (min_value < max_value) {
+                for (uint64_t range = uint64_t(max_value - min_value); range != 0; range >>= 1) ++bit_width;
+            }
+            //an exception costs its value and its position
+            uint64_t estimated_size = uint64_t(bit_width) * number_of_values / sample_step + number_of_exceptions * (sizeof(T) + 2) * 8;
+            //on ties, the smaller exponent wins
+            if (estimated_size < best_size) {
+                best_size = estimated_size;
+                best_exponent = exponent;
+            }
+        }
+        return best_exponent;
+    }
+
+    template<class T>
+    typename AlpCompressedColumn<T>::Block AlpCompressedColumn<T>::compressBlock(const T *values) {
+        Block block;
+        block.exponent = static_cast<uint8_t>(chooseExponent(values, block_size));
+
+        std::vector<int64_t> encoded_values(block_size);
+        std::vector<bool> is_exception(block_size, false);
+        int64_t min_value = std::numeric_limits<int64_t>::max();
+        int64_t max_value = std::numeric_limits<int64_t>::min();
+        for (unsigned int i = 0; i < block_size; ++i) {
+            if (encodeValue(values[i], block.exponent, &encoded_values[i])) {
+                min_value = std::min(min_value, encoded_values[i]);
+                max_value = std::max(max_value, encoded_values[i]);
+            } else {
+                is_exception[i] = true;
+                block.exception_positions.push_back(static_cast<uint16_t>(i));
+                block.exception_values.push_back(values[i]);
+            }
+        }
+        if (min_value > max_value) {
+            //every value is an exception
+            min_value = max_value = 0;
+        }
+        block.base = min_value;
+        for (uint64_t range = uint64_t(max_value - min_value); range != 0; range >>= 1) ++block.bit_width;
+
+        //exceptions are stored as base, so they do not widen the frame
+        block.packed_values.resize((uint64_t(block_size) * block.bit_width + 63) / 64, 0);
+        for (unsigned int i = 0; i < block_size && block.bit_width > 0; ++i) {
+            uint64_t value = is_exception[i] ? 0 : uint64_t(encoded_values[i] - block.base);
+            uint64_t bit_offset = uint64_t(i) * block.bit_width;
+            size_t word = bit_offset >> 6;
+            unsigned int shift = bit_offset & 63;
+            block.packed_values[word] |= value << shift;
+            if (shift + block.bit_width > 64) {
+                block.packed_values[word + 1] |= value >> (64 - shift);
+            }
+        }
+        return block;
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::decompressBlock(const Block &block, T *output) {
+        int64_t encoded_values[block_size];
+        if (block.bit_width == 0) {
+            for (unsigned int i = 0; i < block_size; ++i) encoded_values[i] = block.base;
+        } else if (block.bit_width <= 32 && 64 % block.bit_width == 0) {
+            //values never cross a word boundary, which keeps the loop free of branches
+            const unsigned int values_per_word = 64 / block.bit_width;
+            const uint64_t mask = (uint64_t(1) << block.bit_width) - 1;
+            for (unsigned int i = 0; i < block_size; ++i) {
+                uint64_t word = block.packed_values[i / values_per_word];
+                encoded_values[i] = block.base + int64_t((word >> ((i % values_per_word) * block.bit_width)) & mask);
+            }
+        } else {
+            for (unsigned int i = 0; i < block_size; ++i) {
+                encoded_values[i] = block.base + int64_t(unpack(block.packed_values, block.bit_width, i));
+            }
+        }
+        const double power_of_ten = getPowerOfTen(block.exponent);
+        for (unsigned int i = 0; i < block_size; ++i) {
+            output[i] = static_cast<T>(double(encoded_values[i]) / power_of_ten);
+        }
+        for (unsigned int i = 0; i < block.exception_positions.size(); ++i) {
+            output[block.exception_positions[i]] = block.exception_values[i];
+        }
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::compressTail() {
+        size_t offset = 0;
+        while (tail_.size() - offset >= block_size) {
+            blocks_.push_back(compressBlock(&tail_[offset]));
+            offset += block_size;
+        }
+        if (offset > 0) {
+            tail_.erase(tail_.begin(), tail_.begin() + offset);
+            //a bulk insert leaves a large buffer behind
+            if (tail_.capacity() > 2 * block_size) tail_.shrink_to_fit();
+        }
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::decompressFrom(size_t block) {
+        std::vector<T> values((blocks_.size() - block) * block_size);
+        for (size_t i = block; i < blocks_.size(); ++i) {
+            decompressBlock(blocks_[i], &values[(i - block) * block_size]);
+        }
+        values.insert(values.end(), tail_.begin(), tail_.end());
+        blocks_.resize(block);
+        tail_.swap(values);
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::insert(const boost::any &new_value) {
+        if (new_value.empty() || typeid(T) != new_value.type()) {
+            return false;
+        }
+        return insert(boost::any_cast<T>(new_value));
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::insert(const T &value) {
+        tail_.push_back(value);
+        compressTail();
+        return true;
+    }
+
+    template<class T>
+    template<typename InputIterator>
+    bool AlpCompressedColumn<T>::insert(InputIterator first, InputIterator last) {
+        tail_.insert(tail_.end(), first, last);
+        compressTail();
+        return true;
+    }
+
+    template<class T>
+    T AlpCompressedColumn<T>::decode(TID tid) const {
+        size_t block_id = tid / block_size;
+        if (block_id >= blocks_.size()) {
+            return tail_[tid - blocks_.size() * block_size];
+        }
+        const Block &block = blocks_[block_id];
+        unsigned int position = tid % block_size;
+        if (!block.exception_positions.empty()) {
+            std::vector<uint16_t>::const_iterator it = std::lower_bound(block.exception_positions.begin(),
+                                                                        block.exception_positions.end(), position);
+            if (it != block.exception_positions.end() && *it == position) {
+                return block.exception_values[it - block.exception_positions.begin()];
+            }
+        }
+        return decodeValue(block.base + int64_t(unpack(block.packed_values, block.bit_width, position)), block.exponent);
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::decode(TID begin, TID end, T *output) const {
+        T block_values[block_size];
+        TID tid = begin;
+        while (tid < end) {
+            size_t block_id = tid / block_size;
+            if (block_id >= blocks_.size()) {
+                std::copy(tail_.begin() + (tid - blocks_.size() * block_size), tail_.begin() + (end - blocks_.size() * block_size), output);
+                return;
+            }
+            TID block_begin = TID(block_id * block_size);
+            TID block_end = std::min(end, TID(block_begin + block_size));
+            if (tid == block_begin && block_end == block_begin + block_size) {
+                decompressBlock(blocks_[block_id], output);
+            } else {
+                decompressBlock(blocks_[block_id], block_values);
+                std::copy(block_values + (tid - block_begin), block_values + (block_end - block_begin), output);
+            }
+            output += block_end - tid;
+            tid = block_end;
+        }
+    }
+
+    template<class T>
+    size_t AlpCompressedColumn<T>::getNumberOfExceptions() const {
+        size_t number_of_exceptions = 0;
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            number_of_exceptions += blocks_[i].exception_positions.size();
+        }
+        return number_of_exceptions;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::update(TID tid, const boost::any &new_value) {
+        if (new_value.empty() || typeid(T) != new_value.type() || tid >= size()) {
+            return false;
+        }
+        T value = boost::any_cast<T>(new_value);
+        size_t block_id = tid / block_size;
+        if (block_id >= blocks_.size()) {
+            tail_[tid - blocks_.size() * block_size] = value;
+            return true;
+        }
+        //re-compress the block, the new value may need a different exponent
+        T values[block_size];
+        decompressBlock(blocks_[block_id], values);
+        values[tid % block_size] = value;
+        blocks_[block_id] = compressBlock(values);
+        return true;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::update(PositionListPtr tids, const boost::any &new_value) {
+        if (!tids || new_value.empty() || typeid(T) != new_value.type()) {
+            return false;
+        }
+        //an invalid TID must not leave the column partially updated
+        for (PositionList::const_iterator it = tids->begin(); it != tids->end(); ++it) {
+            if (*it >= size()) return false;
+        }
+        for (PositionList::const_iterator it = tids->begin(); it != tids->end(); ++it) {
+            if (!update(*it, new_value)) return false;
+        }
+        return true;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::remove(TID tid) {
+        if (tid >= size()) {
+            return false;
+        }
+        //all later rows move, so every block from the one of tid on is rebuilt
+        size_t block_id = tid / block_size;
+        decompressFrom(std::min(block_id, blocks_.size()));
+        tail_.erase(tail_.begin() + (tid - blocks_.size() * block_size));
+        compressTail();
+        return true;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::remove(PositionListPtr tids) {
+        if (!tids || tids->empty()) {
+            return false;
+        }
+        //all TIDs are checked before the blocks are decompressed, so an invalid TID leaves the column unchanged
+        for (size_t i = 0; i < tids->size(); ++i) {
+            if ((*tids)[i] >= size() || (i > 0 && (*tids)[i] <= (*tids)[i - 1])) return false;
+        }
+        decompressFrom(std::min(size_t((*tids)[0] / block_size), blocks_.size()));
+        TID offset = TID(blocks_.size() * block_size);
+        for (PositionList::reverse_iterator rit = tids->rbegin(); rit != tids->rend(); ++rit) {
+            tail_.erase(tail_.begin() + (*rit - offset));
+        }
+        compressTail();
+        return true;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::clearContent() {
+        blocks_.clear();
+        tail_.clear();
+        return true;
+    }
+
+    template<class T>
+    const boost::any AlpCompressedColumn<T>::get(TID tid) {
+        if (tid < size()) {
+            return boost::any(decode(tid));
+        } else {
+            std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid << std::endl;
+        }
+        return boost::any();
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::print() const throw() {
+        std::cout << "| " << this->name_ << " |" << std::endl;
+        std::cout << "________________________" << std::endl;
+        for (TID i = 0; i < size(); i++) {
+            std::cout << "| " << decode(i) << " |" << std::endl;
+        }
+    }
+
+    template<class T>
+    size_t AlpCompressedColumn<T>::size() const throw() {
+        return blocks_.size() * block_size + tail_.size();
+    }
+
+    template<class T>
+    size_t AlpCompressedColumn<T>::getSizeinBytes() const throw() {
+        size_t size_in_bytes = blocks_.capacity() * sizeof(Block) + tail_.capacity() * sizeof(T);
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            size_in_bytes += blocks_[i].packed_values.capacity() * sizeof(uint64_t)
+                             + blocks_[i].exception_positions.capacity() * sizeof(uint16_t)
+                             + blocks_[i].exception_values.capacity() * sizeof(T);
+        }
+        return size_in_bytes;
+    }
+
+    template<class T>
+    const ColumnPtr AlpCompressedColumn<T>::copy() const {
+        return ColumnPtr(new AlpCompressedColumn<T>(*this));
+    }
+
+    template<class T>
+    const PositionListPtr AlpCompressedColumn<T>::selection(const boost::any &value_for_comparison, const ValueComparator comp) {
+        if (value_for_comparison.type() != typeid(T)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+        typename PredicateExpression<T>::PredicateExpressionPtr predicate = makeComparison(comp, boost::any_cast<T>(value_for_comparison));
+        if (!predicate) return PositionListPtr(new PositionList());
+        return predicate_selection(*predicate);
+    }
+
+    template<class T>
+    const PositionListPtr AlpCompressedColumn<T>::predicate_selection(const PredicateExpression<T> &predicate) {
+        PositionListPtr result_tids(new PositionList());
+        //decode block wise and evaluate the predicate on the decoded values
+        T values[block_size];
+        for (TID begin = 0; begin < size(); begin += block_size) {
+            TID end = std::min(TID(size()), TID(begin + block_size));
+            decode(begin, end, values);
+            evaluatePredicate(predicate, values, end - begin, begin, *result_tids);
+        }
+        return result_tids;
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::decodeRange(TID begin, TID end, T *output) {
+        decode(begin, end, output);
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::supportsConcurrentReads() const {
+        return true;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::store(const std::string &path_) {
+        std::string path(path_);
+        path += "/";
+        path += this->name_;
+        std::ofstream outfile(path.c_str(), std::ios_base::binary | std::ios_base::out);
+        boost::archive::binary_oarchive oa(outfile);
+        oa << blocks_;
+        oa << tail_;
+        outfile.flush();
+        outfile.close();
+        return true;
+    }
+
+    template<class T>
+    bool AlpCompressedColumn<T>::load(const std::string &path_) {
+        std::string path(path_);
+        path += "/";
+        path += this->name_;
+        ColumnInputFile infile (path);
+        boost::archive::binary_iarchive ia(infile);
+        ia >> blocks_;
+        ia >> tail_;
+        infile.close();
+        return true;
+    }
+
+    template<class T>
+    void AlpCompressedColumn<T>::gather(const PositionList &tids, T *output) {
+        //decode every block once for a run of TIDs inside it, isolated TIDs are decoded one by one
+        T block_values[block_size];
+        size_t decoded_block = size_t(-1);
+        for (size_t i = 0; i < tids.size(); ++i) {
+            size_t block_id = tids[i] / block_size;
+            if (block_id >= blocks_.size()) {
+                output[i] = tail_[tids[i] - blocks_.size() * block_size];
+            } else if (block_id == decoded_block) {
+                output[i] = block_values[tids[i] % block_size];
+            } else if (i + 1 < tids.size() && tids[i + 1] / block_size == block_id) {
+                decompressBlock(blocks_[block_id], block_values);
+                decoded_block = block_id;
+                output[i] = block_values[tids[i] % block_size];
+            } else {
+                output[i] = decode(tids[i]);
+            }
+        }
+    }
+
+    template<class T>
+    T &AlpCompressedColumn<T>::operator[](const TID index) {
+        return decode_buffer_.store(decode(index));
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
@@ -15,14 +15,34 @@
 
 #include <core/column.hpp>
 
+#include <core/parallel.hpp>
+
+#include <atomic>
+
+#include <iterator>
+
+#include <vector>
+
 
 namespace CoGaDB {
 
 
+/*! \brief number of rows between two absolute values, which a delta coded column keeps to decode a random row*/
+const TID delta_checkpoint_interval=128;
+
+
 /*!
 
  *  \brief     This class represents a DeltaCodingCompressedColumn with type T, is the base class for all compressed typed column classes.
 
+ *  \details   The first value is stored as is, every other value as difference to its predecessor. Reading continues from the last decompressed
+
+ *  row, so a scan decodes each row in constant time. Reads modify this cursor and must not run concurrently. A read before the cursor starts
+
+ *  at the checkpoint before the row: the value of every delta_checkpoint_interval-th row is kept, so a random read, e.g., a probe of a binary
+
+ *  search, sums at most delta_checkpoint_interval deltas. The checkpoints are computed by the reads, which need them.
+
  */
 
     template<class T>
@@ -38,13 +58,15 @@ namespace CoGaDB {
         virtual ~DeltaCodingCompressedColumn();
 
 
-        virtual T &decompress(TID id);
+        /*! \brief returns the value of row id, which is the sum of the deltas up to id*/
+        T decompress(TID id);
 
 
         virtual bool insert(const boost::any &new_Value);
 
         virtual bool insert(const T &new_value);
 
+        /*! \brief appends the values of [first,last), the deltas of large inputs are computed in parallel*/
         template<typename InputIterator>
 
         bool insert(InputIterator first, InputIterator last);
@@ -54,6 +76,8 @@ namespace CoGaDB {
 
         virtual bool update(PositionListPtr tid, const boost::any &new_value);
 
+        virtual bool update(TID tid, const T &new_value);
+
 
         virtual bool remove(TID tid);
 
@@ -66,15 +90,23 @@ namespace CoGaDB {
 
         virtual const boost::any get(TID tid);
 
+        virtual T getValue(TID tid);
+
+        virtual void decodeRange(TID begin, TID end, T *output);
+
+        /*! \brief decodes runs of ascending TIDs, which are close to each other, with one decodeRange() per run*/
+        virtual void gather(const PositionList &tids, T *output);
+
         //virtual const boost::any* const getRawData()=0;
 
         virtual void print() const throw();
 
         virtual size_t size() const throw();
 
-        virtual unsigned int getSizeinBytes() const throw();
+        virtual size_t getSizeinBytes() const throw();
 
 
+        /*! \brief the copy shares the deltas with this column, until one of them is modified*/
         virtual const ColumnPtr copy() const;
 
 
@@ -83,8 +115,19 @@ namespace CoGaDB {
         virtual bool load(const std::string &path);
 
 
-        virtual T &operator[](const int index);
+        /*! \brief returns a reference to a decoded copy of the value, which the next call overwrites, writes through it do not change the column*/
+        virtual T &operator[](const TID index);
+
+
+    private:
+
+        template<typename InputIterator>
+
+        bool insert(InputIterator first, InputIterator last, std::input_iterator_tag);
+
+        template<typename RandomAccessIterator>
 
+        bool insert(RandomAccessIterator first, RandomAccessIterator last, std::random_access_iterator_tag);
 
     public:
 
@@ -93,6 +136,22 @@ namespace CoGaDB {
         T last_value_;
 
 
+    private:
+
+        /*! row and value of the last decompressed row*/
+        TID cursor_tid_;
+
+        T cursor_value_;
+
+        bool has_cursor_;
+
+        /*! value, which operator[] refers to*/
+        T decoded_value_;
+
+        /*! values of the rows 0, delta_checkpoint_interval, 2*delta_checkpoint_interval, ..., up to the last row, which was read*/
+        std::vector<T> checkpoints_;
+
+
     };
 
 
@@ -105,9 +164,11 @@ namespace CoGaDB {
     DeltaCodingCompressedColumn<T>::DeltaCodingCompressedColumn(const std::string &name, AttributeType db_type)
             : CompressedColumn<T>(name, db_type),
 
-              column_(name, db_type), last_value_() {
+              column_(name, db_type), last_value_(), cursor_tid_(0), cursor_value_(), has_cursor_(false), decoded_value_(),
 
-        this->column_ = Column<T>(name, db_type);
+              checkpoints_() {
+
+        this->is_sorted_ = true;
 
     }
 
@@ -123,7 +184,10 @@ namespace CoGaDB {
     template<class T>
 
     bool DeltaCodingCompressedColumn<T>::insert(const boost::any &value) {
-        return this->column_.insert(boost::any_cast<T>(value));
+        if (value.empty() || typeid(T) != value.type()) {
+            return false;
+        }
+        return insert(boost::any_cast<T>(value));
     }
 
 
@@ -131,30 +195,27 @@ namespace CoGaDB {
 
     bool DeltaCodingCompressedColumn<T>::insert(const T &value) {
 
-        if (column_.getContent().empty()) {
+        if (column_.size() == 0) {
 
-            std::cout << std::endl << "Saving first entry: " << value << std::endl;
+            //NaN is not ordered, a column with NaN is never sorted
+            if (!(value <= value)) {
+                this->is_sorted_ = false;
+            }
 
             this->column_.insert(value);
 
-            this->last_value_ = value;
-
         } else {
 
-            //std::cout << "last value: " << last_value_ << std::endl;
-
-            std::cout << std::endl << "Saving entry delta: " << value - this->last_value_ << " for value : " << value
-                      << " id : " << column_.size() << std::endl;
+            //the values are sorted, as long as all deltas are non-negative
+            if (!(this->last_value_ <= value)) {
+                this->is_sorted_ = false;
+            }
 
             this->column_.insert(value - this->last_value_);
 
-            this->last_value_ = value;
-
         }
 
-        std::cout << std::endl << "decompressed : " << decompress(column_.size() - 1) << " id : " << column_.size() - 1
-                  << std::endl;
-
+        this->last_value_ = value;
 
         return true;
 
@@ -165,55 +226,163 @@ namespace CoGaDB {
 
     template<typename InputIterator>
 
-    bool DeltaCodingCompressedColumn<T>::insert(InputIterator start, InputIterator end) {
-        bool inserted = true;
-        for (auto it = start; it != end; ++it) {
-            inserted = insert(*it);
-        }
-        return inserted;
+    bool DeltaCodingCompressedColumn<T>::insert(InputIterator first, InputIterator last) {
+        return insert(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+    }
+
+
+    template<typename T>
+
+    template<typename InputIterator>
 
+    bool DeltaCodingCompressedColumn<T>::insert(InputIterator first, InputIterator last, std::input_iterator_tag) {
+        //the blocks need random access to the value before them
+        std::vector<T> values(first, last);
+        return insert(values.begin(), values.end(), std::random_access_iterator_tag());
     }
 
 
-    template<class T>
+    template<typename T>
 
-    T &DeltaCodingCompressedColumn<T>::decompress(TID id) {
+    template<typename RandomAccessIterator>
+
+    bool DeltaCodingCompressedColumn<T>::insert(RandomAccessIterator first, RandomAccessIterator last,
+                                                std::random_access_iterator_tag) {
+        const TID number_of_values = last - first;
+        if (number_of_values == 0) return true;
+
+        typename Column<T>::ValueVector &deltas = column_.getContent();
+        const TID old_size = deltas.size();
+        deltas.resize(old_size + number_of_values);
+        const T last_value = this->last_value_;
+        std::atomic<bool> sorted(true);
+        //every delta only depends on the input value before it, so each block is encoded independently,
+        //its first delta is taken to the last input value of the preceding block
+        parallel_for(0, number_of_values, [&](TID begin, TID end) {
+            bool block_sorted = true;
+            TID i = begin;
+            T previous = last_value;
+            if (begin > 0) {
+                previous = first[begin - 1];
+            } else if (old_size == 0) {
+                //the first value of the column is stored as is
+                previous = first[0];
+                deltas[0] = previous;
+                if (!(previous <= previous)) block_sorted = false;
+                ++i;
+            }
+            for (; i < end; ++i) {
+                const T value = first[i];
+                if (!(previous <= value)) block_sorted = false;
+                deltas[old_size + i] = value - previous;
+                previous = value;
+            }
+            if (!block_sorted) sorted = false;
+        }, getNumberOfAvailableThreads(), parallel_encoding_block_size);
 
-        std::vector <T> values = column_.getContent();
+        if (!sorted) this->is_sorted_ = false;
+        this->last_value_ = first[number_of_values - 1];
+        return true;
+    }
 
-        T *result = new int;
-        *result = 0;
 
+    template<class T>
+
+    T DeltaCodingCompressedColumn<T>::decompress(TID id) {
 
-        if (id == 0) {
+        const typename Column<T>::ValueVector &deltas = static_cast<const Column <T> &>(this->column_).getContent();
 
-            *result = values.at(id);
+        if (id + 1 == deltas.size()) {
+            return this->last_value_;
+        }
 
+        //continue from the last decompressed row, if it is between the checkpoint before id and id, otherwise from the checkpoint
+        const TID checkpoint = id / delta_checkpoint_interval;
+        TID begin;
+        T value;
+        if (this->has_cursor_ && this->cursor_tid_ <= id && this->cursor_tid_ >= checkpoint * delta_checkpoint_interval) {
+            begin = this->cursor_tid_ + 1;
+            value = this->cursor_value_;
         } else {
+            if (this->checkpoints_.empty()) this->checkpoints_.push_back(deltas[0]);
+            while (this->checkpoints_.size() <= checkpoint) {
+                const TID previous_row = (this->checkpoints_.size() - 1) * delta_checkpoint_interval;
+                T checkpoint_value = this->checkpoints_.back();
+                for (TID i = previous_row + 1; i <= previous_row + delta_checkpoint_interval; i++) {
+                    checkpoint_value += deltas[i];
+                }
+                this->checkpoints_.push_back(checkpoint_value);
+            }
+            begin = checkpoint * delta_checkpoint_interval + 1;
+            value = this->checkpoints_[checkpoint];
+        }
+        for (TID i = begin; i <= id; i++) {
+            value += deltas[i];
+        }
 
-            for (TID i = 0; i <= id; i++) {
+        this->cursor_tid_ = id;
+        this->cursor_value_ = value;
+        this->has_cursor_ = true;
+        return value;
 
-                *result += values.at(i);
+    }
 
-            }
 
-        }
+    template<class T>
 
+    const boost::any DeltaCodingCompressedColumn<T>::get(TID id) {
+        if (id >= this->size()) {
+            std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << id << std::endl;
+            return boost::any();
+        }
+        return boost::any(decompress(id));
+    }
 
 
-        //std::cout << std::endl << "decompress result for TID " << id << " : " << result << std::endl;
+    template<class T>
 
+    T DeltaCodingCompressedColumn<T>::getValue(TID id) {
+        return decompress(id);
+    }
 
 
-        return *result;
+    template<class T>
 
+    void DeltaCodingCompressedColumn<T>::decodeRange(TID begin, TID end, T *output) {
+        if (begin >= end) return;
+        const typename Column<T>::ValueVector &deltas = static_cast<const Column <T> &>(this->column_).getContent();
+        T value = decompress(begin);
+        output[0] = value;
+        for (TID i = begin + 1; i < end; i++) {
+            value += deltas[i];
+            output[i - begin] = value;
+        }
+        this->cursor_tid_ = end - 1;
+        this->cursor_value_ = value;
+        this->has_cursor_ = true;
     }
 
 
     template<class T>
 
-    const boost::any DeltaCodingCompressedColumn<T>::get(TID id) {
-        return decompress(id);
+    void DeltaCodingCompressedColumn<T>::gather(const PositionList &tids, T *output) {
+        //a run ends at a descending TID or at a gap, which is larger than the distance of the checkpoints, every delta of a run is added once
+        std::vector<T> run_values;
+        size_t run_begin = 0;
+        while (run_begin < tids.size()) {
+            size_t run_end = run_begin + 1;
+            while (run_end < tids.size() && tids[run_end - 1] <= tids[run_end]
+                   && tids[run_end] - tids[run_end - 1] <= delta_checkpoint_interval) {
+                ++run_end;
+            }
+            const TID begin = tids[run_begin];
+            run_values.resize(tids[run_end - 1] + 1 - begin);
+            decodeRange(begin, tids[run_end - 1] + 1, &run_values[0]);
+            for (size_t i = run_begin; i < run_end; ++i) {
+                output[i] = run_values[tids[i] - begin];
+            }
+            run_begin = run_end;
+        }
     }
 
 
@@ -239,44 +408,41 @@ namespace CoGaDB {
 
     template<class T>
 
-    bool DeltaCodingCompressedColumn<T>::update(TID id, const boost::any &newBoostValue) {
-        T newValue = boost::any_cast<T>(newBoostValue);
-        //this->column_.print();
-        if (id == 0) {
+    bool DeltaCodingCompressedColumn<T>::update(TID id, const boost::any &new_value) {
+        if (new_value.empty() || typeid(T) != new_value.type()) {
+            return false;
+        }
+        return update(id, boost::any_cast<T>(new_value));
+    }
 
-            //update old first value with new first value
-            if (!this->column_.update(0, newValue)) {
-                return false;
-            }
-            //adjust successor delta if present
-            if (this->size() > 1) {
-                T decompressedSucc = boost::any_cast<T>(this->get(id + 1));
-                T newSuccDelta = decompressedSucc - newValue;
-                if (!this->column_.update(1, newSuccDelta)) {
-                    return false;
-                }
-            }
+
+    template<class T>
+
+    bool DeltaCodingCompressedColumn<T>::update(TID id, const T &new_value) {
+        if (id >= this->size()) {
+            return false;
+        }
+        const T difference = new_value - decompress(id);
+        typename Column<T>::ValueVector &deltas = this->column_.getContent();
+
+        //the delta of row id grows by the difference, the delta of its successor shrinks by it, all other values stay the same
+        deltas[id] += difference;
+        if (id + 1 < deltas.size()) {
+            deltas[id + 1] -= difference;
         } else {
-            std::cout << "newValue: " << newValue << std::endl;
-            T oldDelta = this->column_[id];
-            std::cout << "old delta: " << oldDelta << std::endl;
-            T decompressedPreceding = boost::any_cast<T>(this->get(id - 1));
-            std::cout << "decompressedPreceding: " << decompressedPreceding << std::endl;
-            T newDelta = newValue - decompressedPreceding;
-            std::cout << "newDelta: " << newDelta << std::endl;
-            T updateDelta = newDelta - oldDelta;
-            std::cout << "updateDelta: " << updateDelta << std::endl;
-            //update old delta with new delta
-            if (!this->column_.update(id, newDelta)) {
-                return false;
-            }
-            //adjust succ delta
-            if (!this->column_.update(id + 1, this->column_[id + 1] - updateDelta)) {
-                return false;
-            }
+            this->last_value_ = new_value;
+        }
+        if (this->has_cursor_ && this->cursor_tid_ == id) {
+            this->cursor_value_ = new_value;
+        }
+        //the values of all other rows stay the same
+        if (id % delta_checkpoint_interval == 0 && id / delta_checkpoint_interval < this->checkpoints_.size()) {
+            this->checkpoints_[id / delta_checkpoint_interval] = new_value;
+        }
 
+        if (!(new_value <= new_value) || (id > 0 && !(T() <= deltas[id])) || (id + 1 < deltas.size() && !(T() <= deltas[id + 1]))) {
+            this->is_sorted_ = false;
         }
-        //this->column_.print();
 
         return true;
 
@@ -289,8 +455,9 @@ namespace CoGaDB {
         if (value.empty() || typeid(T) != value.type()) {
             return false;
         }
+        const T new_value = boost::any_cast<T>(value);
         for (auto it = ptr->begin(); it != ptr->end(); ++it) {
-            this->update(*it, value);
+            this->update(*it, new_value);
         }
         return true;
 
@@ -300,21 +467,21 @@ namespace CoGaDB {
     template<class T>
 
     bool DeltaCodingCompressedColumn<T>::remove(TID id) {
-        if(id==0){
-            T decompressedSucc = boost::any_cast<T>(this->get(id + 1));
-            this->column_.getContent().erase(this->column_.getContent().begin()+0);
-            if(!this->column_.update(0,decompressedSucc)){
-                return false;
-            }
-        }else {
-            T decompressedPreceding = boost::any_cast<T>(this->get(id - 1));
-            T decompressedSucc = boost::any_cast<T>(this->get(id + 1));
-            T newSuccDelta =  decompressedSucc - decompressedPreceding;
-            this->column_.getContent().erase(this->column_.getContent().begin() + id);
-            if(this->column_.update(id, newSuccDelta)){
-                return false;
-            }
+        if (id >= this->size()) {
+            return false;
         }
+        typename Column<T>::ValueVector &deltas = this->column_.getContent();
+        if (id + 1 < deltas.size()) {
+            //the successor takes over the delta of the removed row, so it becomes the first value, if row 0 is removed
+            deltas[id + 1] += deltas[id];
+        } else {
+            this->last_value_ = id > 0 ? this->last_value_ - deltas[id] : T();
+        }
+        deltas.erase(deltas.begin() + id);
+        //rows behind id move, so the cursor and the checkpoints behind id can not be continued
+        this->has_cursor_ = false;
+        const TID number_of_valid_checkpoints = (id + delta_checkpoint_interval - 1) / delta_checkpoint_interval;
+        if (number_of_valid_checkpoints < this->checkpoints_.size()) this->checkpoints_.resize(number_of_valid_checkpoints);
         return true;
     }
 
@@ -337,6 +504,10 @@ namespace CoGaDB {
     template<class T>
 
     bool DeltaCodingCompressedColumn<T>::clearContent() {
+        this->is_sorted_ = true;
+        this->last_value_ = T();
+        this->has_cursor_ = false;
+        this->checkpoints_.clear();
         return this->column_.clearContent();
     }
 
@@ -371,17 +542,24 @@ namespace CoGaDB {
         path += this->name_+"-meta";
 
         //std::cout << "Opening File '" << path << "'..." << std::endl;
-        std::ifstream infile (path.c_str(),std::ios_base::binary | std::ios_base::in);
+        ColumnInputFile infile (path);
         boost::archive::binary_iarchive ia(infile);
 
         ia >> last_value_;
-        std::cout << "loaded last_value_: " << last_value_ << std::endl;
+        this->has_cursor_ = false;
+        this->checkpoints_.clear();
 
 
         infile.close();
 
 
         bool loaded  = this->column_.load(path_);
+        //bulk load, the values are sorted, if no delta is negative
+        const typename Column<T>::ValueVector &deltas = static_cast<const Column <T> &>(this->column_).getContent();
+        this->is_sorted_ = true;
+        for (size_t i = 1; i < deltas.size() && this->is_sorted_; ++i) {
+            if (!(T() <= deltas[i])) this->is_sorted_ = false;
+        }
         //std::cout << "after load: " << std::endl;
         //this->column_.print();
         return loaded;
@@ -390,15 +568,16 @@ namespace CoGaDB {
 
     template<class T>
 
-    T &DeltaCodingCompressedColumn<T>::operator[](int index) {
-        return this->decompress(index);
+    T &DeltaCodingCompressedColumn<T>::operator[](const TID index) {
+        this->decoded_value_ = this->decompress(index);
+        return this->decoded_value_;
     }
 
 
     template<class T>
 
-    unsigned int DeltaCodingCompressedColumn<T>::getSizeinBytes() const throw() {
-        return this->column_.getSizeinBytes();
+    size_t DeltaCodingCompressedColumn<T>::getSizeinBytes() const throw() {
+        return this->column_.getSizeinBytes() + this->checkpoints_.capacity() * sizeof(T);
     }
 
 
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <core/global_definitions.hpp>
+#include <core/memory_arena.hpp>
+#include <core/memory_manager.hpp>
+
+namespace CoGaDB {
+
+/*!
+ *  \brief     The dictionary of one or more CoGaDB::DictionaryCompressedColumn objects, which maps values to integer keys and back.
+ *  \details   Columns, which share a dictionary by reference, encode equal values with equal keys, so they can be joined on their keys without
+ *  decoding. The dictionary counts the rows of all sharing columns per key and frees a key, when no row uses it anymore. Freed keys are
+ *  handed out again before new keys are created. Every value is stored once, in a vector indexed by its key. The lookup of the key of a
+ *  value searches a set of the keys, which is ordered by their values, so it does not need a second copy of the values.
+ */
+    template<class T>
+    class Dictionary {
+    public:
+        typedef std::vector<T, ColumnAllocator<T> > ValueVector;
+
+        /*! \brief a value, whose key is searched, it is compared with the keys by the values of the keys*/
+        struct ValueReference {
+            explicit ValueReference(const T &value) : value_(&value) {}
+
+            const T *value_;
+        };
+
+        /*! \brief orders keys by their values*/
+        class KeyOrder {
+        public:
+            typedef void is_transparent;
+
+            explicit KeyOrder(const ValueVector *values) : values_(values) {}
+
+            bool operator()(int lhs, int rhs) const { return (*values_)[lhs] < (*values_)[rhs]; }
+
+            bool operator()(int lhs, const ValueReference &rhs) const { return (*values_)[lhs] < *rhs.value_; }
+
+            bool operator()(const ValueReference &lhs, int rhs) const { return *lhs.value_ < (*values_)[rhs]; }
+
+        private:
+            const ValueVector *values_;
+        };
+
+        typedef std::set<int, KeyOrder, ColumnAllocator<int> > InsertDictionary;
+        typedef std::map<int, int, std::less<int>, ColumnAllocator<std::pair<const int, int> > > ValueCountDictionary;
+
+        Dictionary();
+
+        /*! \brief creates an empty dictionary, which allocates its entries in arena*/
+        explicit Dictionary(const MemoryArenaPtr &arena);
+
+        /*! \brief copies the entries, no column uses the copy yet*/
+        Dictionary(const Dictionary &dictionary);
+
+        const MemoryArenaPtr getArena() const;
+
+        /*! \brief returns the key of value, creates a new key for unknown values, sets known to whether value was known*/
+        int getKeyFor(const T &value, bool *known);
+
+        /*! \brief returns the key for value and increments its row count*/
+        int acquireKey(const T &value);
+
+        /*! \brief returns the key for value and increments its row count by number_of_rows, e.g., for a block of a bulk insert*/
+        int acquireKey(const T &value, int number_of_rows);
+
+        /*! \brief increments the row count of key, which is already in use*/
+        void retainKey(int key);
+
+        /*! \brief decrements the row count of key, drops the entries of key and frees it, when no row uses it anymore
+         *  \return true, if the key was freed*/
+        bool releaseKey(int key);
+
+        /*! \brief returns the value of key*/
+        T &getValue(int key);
+
+        /*! \brief writes the value of keys[i] to output[i]*/
+        void getValues(const std::vector<unsigned int> &keys, T *output) const;
+
+        /*! \brief largest key, which was handed out, all keys are in [1,getLastKey()]*/
+        int getLastKey() const;
+
+        /*! \brief number of distinct values*/
+        size_t size() const;
+
+        /*! \brief memory of the dictionary, including the tree nodes and the heap memory of the values*/
+        size_t getSizeinBytes() const;
+
+        /*! \brief share of freed keys of all keys ever handed out, in [0,1]*/
+        double getDeadCodeShare() const;
+
+        /*! \brief counts a column, which encodes its values with this dictionary, the columns split the memory of the dictionary*/
+        void registerColumn();
+
+        void unregisterColumn();
+
+        /*! \brief number of registered columns*/
+        size_t getNumberOfColumns() const;
+
+        /*! \brief renumbers the keys of all values densely (in ascending value order)
+         *  \return remap[old_key] is the new key of old_key*/
+        std::vector<unsigned int> compact();
+
+        void clear();
+
+        /*! \brief replaces the row counts with row_counts[key] and frees the keys, which no row uses, e.g., after a column loaded a
+         *  dictionary, whose stored counts include the rows of other columns*/
+        void setRowCounts(const std::vector<int> &row_counts);
+
+        void serialize(boost::archive::binary_oarchive &out) const;
+
+        void deserialize(boost::archive::binary_iarchive &in);
+
+    private:
+        Dictionary &operator=(const Dictionary &);
+
+        /*! value of every key, the values of free keys are default constructed*/
+        ValueVector values_;
+        /*! keys of all values ordered by value*/
+        InsertDictionary insert_dict_;
+        ValueCountDictionary value_count_dict_;
+        int last_key_;
+        /*! keys of removed values, which are handed out again before last_key_ grows*/
+        std::vector<int> free_keys_;
+        size_t number_of_columns_;
+    };
+
+
+/***************** Start of Implementation Section ******************/
+
+    template<class T>
+    Dictionary<T>::Dictionary() : values_(), insert_dict_(KeyOrder(&values_)), value_count_dict_(), last_key_(0), free_keys_(),
+                                  number_of_columns_(0) {
+
+    }
+
+    template<class T>
+    Dictionary<T>::Dictionary(const MemoryArenaPtr &arena)
+            : values_(typename ValueVector::allocator_type(arena)),
+              insert_dict_(KeyOrder(&values_), typename InsertDictionary::allocator_type(arena)),
+              value_count_dict_(std::less<int>(), typename ValueCountDictionary::allocator_type(arena)), last_key_(0), free_keys_(),
+              number_of_columns_(0) {
+
+    }
+
+    template<class T>
+    Dictionary<T>::Dictionary(const Dictionary &dictionary)
+            : values_(dictionary.values_),
+              insert_dict_(dictionary.insert_dict_.begin(), dictionary.insert_dict_.end(), KeyOrder(&values_), dictionary.insert_dict_.get_allocator()),
+              value_count_dict_(dictionary.value_count_dict_),
+              last_key_(dictionary.last_key_), free_keys_(dictionary.free_keys_), number_of_columns_(0) {
+
+    }
+
+    template<class T>
+    const MemoryArenaPtr Dictionary<T>::getArena() const {
+        return insert_dict_.get_allocator().getArena();
+    }
+
+    template<class T>
+    int Dictionary<T>::getKeyFor(const T &value, bool *known) {
+        typename InsertDictionary::const_iterator it = insert_dict_.find(ValueReference(value));
+        int key = -1;
+        if (it != insert_dict_.end()) {
+            key = *it;
+        }
+        if (key != -1) {
+            *known = 1;
+            //we already know the value
+        } else {
+            *known = 0;
+            //lernen wert, reuse the key of a removed value first
+            if (!this->free_keys_.empty()) {
+                key = this->free_keys_.back();
+                this->free_keys_.pop_back();
+            } else {
+                key = this->last_key_ + 1;
+                this->last_key_ = this->last_key_ + 1;
+            }
+            if (this->values_.size() <= size_t(key)) {
+                this->values_.resize(key + 1);
+            }
+            this->values_[key] = value;
+            insert_dict_.insert(key);
+            value_count_dict_.insert(std::make_pair(key, 1));
+        }
+        return key;
+    }
+
+    template<class T>
+    int Dictionary<T>::acquireKey(const T &value) {
+        bool known = false;
+        int key = getKeyFor(value, &known);
+        //increment value count for already known value, new keys start with a count of one
+        if (known) {
+            retainKey(key);
+        }
+        return key;
+    }
+
+    template<class T>
+    int Dictionary<T>::acquireKey(const T &value, int number_of_rows) {
+        bool known = false;
+        int key = getKeyFor(value, &known);
+        //new keys start with a count of one
+        this->value_count_dict_[key] = (known ? this->value_count_dict_[key] : 0) + number_of_rows;
+        return key;
+    }
+
+    template<class T>
+    void Dictionary<T>::retainKey(int key) {
+        this->value_count_dict_[key] = this->value_count_dict_[key] + 1;
+    }
+
+    template<class T>
+    bool Dictionary<T>::releaseKey(int key) {
+        int value_count = this->value_count_dict_[key];
+        if (value_count > 1) {
+            this->value_count_dict_[key] = value_count - 1;
+            return false;
+        }
+        this->value_count_dict_.erase(key);
+        this->insert_dict_.erase(key);
+        //frees the heap memory of the value
+        this->values_[key] = T();
+        this->free_keys_.push_back(key);
+        return true;
+    }
+
+    template<class T>
+    T &Dictionary<T>::getValue(int key) {
+        return values_.at(key);
+    }
+
+    template<class T>
+    void Dictionary<T>::getValues(const std::vector<unsigned int> &keys, T *output) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            output[i] = values_[keys[i]];
+        }
+    }
+
+    template<class T>
+    int Dictionary<T>::getLastKey() const {
+        return last_key_;
+    }
+
+    template<class T>
+    size_t Dictionary<T>::size() const {
+        return insert_dict_.size();
+    }
+
+    template<class T>
+    size_t Dictionary<T>::getSizeinBytes() const {
+        size_t size_in_bytes = values_.capacity() * sizeof(T)
+                               + insert_dict_.size() * getTreeNodeSizeinBytes<typename InsertDictionary::value_type>()
+                               + value_count_dict_.size() * getTreeNodeSizeinBytes<typename ValueCountDictionary::value_type>()
+                               + free_keys_.capacity() * sizeof(int);
+        for (typename InsertDictionary::const_iterator it = insert_dict_.begin(); it != insert_dict_.end(); ++it) {
+            size_in_bytes += getHeapSizeinBytes(values_[*it]);
+        }
+        return size_in_bytes;
+    }
+
+    template<class T>
+    double Dictionary<T>::getDeadCodeShare() const {
+        if (this->last_key_ == 0) return 0;
+        return double(this->free_keys_.size()) / this->last_key_;
+    }
+
+    template<class T>
+    void Dictionary<T>::registerColumn() {
+        ++this->number_of_columns_;
+    }
+
+    template<class T>
+    void Dictionary<T>::unregisterColumn() {
+        --this->number_of_columns_;
+    }
+
+    template<class T>
+    size_t Dictionary<T>::getNumberOfColumns() const {
+        return this->number_of_columns_;
+    }
+
+    template<class T>
+    std::vector<unsigned int> Dictionary<T>::compact() {
+        //assign dense keys 1..n in ascending value order, remap[old_key] is the new key
+        std::vector<unsigned int> remap(this->last_key_ + 1, 0);
+        ValueVector values(1, T(), values_.get_allocator());
+        values.reserve(insert_dict_.size() + 1);
+        ValueCountDictionary value_count_dict(value_count_dict_.key_comp(), value_count_dict_.get_allocator());
+        int new_key = 0;
+        for (typename InsertDictionary::const_iterator it = insert_dict_.begin(); it != insert_dict_.end(); ++it) {
+            ++new_key;
+            remap[*it] = new_key;
+            values.push_back(std::move(this->values_[*it]));
+            value_count_dict.insert(value_count_dict.end(), std::make_pair(new_key, this->value_count_dict_[*it]));
+        }
+        this->values_.swap(values);
+        //the new keys are ascending in value order
+        this->insert_dict_.clear();
+        for (int key = 1; key <= new_key; ++key) {
+            this->insert_dict_.insert(this->insert_dict_.end(), key);
+        }
+        this->value_count_dict_.swap(value_count_dict);
+        this->free_keys_.clear();
+        this->last_key_ = new_key;
+        return remap;
+    }
+
+    template<class T>
+    void Dictionary<T>::clear() {
+        this->insert_dict_.clear();
+        this->value_count_dict_.clear();
+        //releases the memory of the values, clear() keeps the capacity
+        ValueVector(values_.get_allocator()).swap(this->values_);
+        this->free_keys_.clear();
+        this->last_key_ = 0;
+    }
+
+    template<class T>
+    void Dictionary<T>::setRowCounts(const std::vector<int> &row_counts) {
+        std::vector<int> unused_keys;
+        for (typename InsertDictionary::const_iterator it = insert_dict_.begin(); it != insert_dict_.end(); ++it) {
+            int key = *it;
+            if (size_t(key) < row_counts.size() && row_counts[key] > 0) {
+                this->value_count_dict_[key] = row_counts[key];
+            } else {
+                unused_keys.push_back(key);
+            }
+        }
+        for (size_t i = 0; i < unused_keys.size(); ++i) {
+            this->value_count_dict_[unused_keys[i]] = 1;
+            releaseKey(unused_keys[i]);
+        }
+    }
+
+    //map serialize and deserialize
+    template<class T>
+    void Dictionary<T>::serialize(boost::archive::binary_oarchive &out) const {
+        out << this->last_key_;
+        out << this->insert_dict_.size();
+        //the values are written once, with their keys
+        for (auto const &key: insert_dict_) { out << values_[key] << key; }
+        out << this->value_count_dict_.size();
+        for (auto const &p: value_count_dict_) { out << p.first << p.second; }
+        out << this->free_keys_;
+    }
+
+    template<class T>
+    void Dictionary<T>::deserialize(boost::archive::binary_iarchive &in) {
+        clear();
+        in >> this->last_key_;
+
+        size_t size = 0;
+        in >> size;
+
+        this->values_.resize(this->last_key_ + 1);
+        for (size_t i = 0; i != size; ++i) {
+            T value;
+            int key;
+            in >> value >> key;
+            this->values_[key] = value;
+            this->insert_dict_.insert(this->insert_dict_.end(), key);
+        }
+
+        size_t size2 = 0;
+        in >> size2;
+
+        for (size_t i = 0; i != size2; ++i) {
+            int key;
+            int count;
+            in >> key >> count;
+            this->value_count_dict_[key] = count;
+        }
+
+        in >> this->free_keys_;
+    }
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
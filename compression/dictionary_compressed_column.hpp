@@ -7,6 +7,11 @@
 
 #include <core/compressed_column.hpp>
 #include <core/column.hpp>
+#include <core/parallel.hpp>
+#include <iterator>
+#include <boost/unordered_map.hpp>
+#include <compression/packed_code_vector.hpp>
+#include <compression/dictionary.hpp>
 
 namespace CoGaDB {
 
@@ -14,6 +19,12 @@ namespace CoGaDB {
 /*!
  *  \brief     This class represents a dictionary compressed column with type T, is the base class for all compressed typed column classes. (is it?)
  *  Implemented as Proxy of normal uncompressed Column.
+ *  \details  Codes of values whose last row was removed or updated are put on a free list and reused for new values. When the share of
+ *  such dead codes exceeds the compaction threshold, the dictionary is compacted: the live codes are renumbered densely and the code
+ *  vector is rewritten with the smallest possible code width.
+ *  Several columns can share one CoGaDB::Dictionary, e.g., a foreign key and the key it references. Joins between columns with the same
+ *  dictionary compare codes only and use a table, which is indexed by code, instead of a hash table. A shared dictionary is not compacted,
+ *  because this would change the codes of the other columns.
  */
     template<class T>
     class DictionaryCompressedColumn : public CompressedColumn<T> {
@@ -21,6 +32,15 @@ namespace CoGaDB {
         /***************** constructors and destructor *****************/
         DictionaryCompressedColumn(const std::string &name, AttributeType db_type);
 
+        /*! \brief creates a column, which encodes its values with dictionary, which can be shared with other columns*/
+        DictionaryCompressedColumn(const std::string &name, AttributeType db_type, shared_pointer_namespace::shared_ptr<Dictionary<T> > dictionary);
+
+        /*! \brief creates a column, which allocates its codes and its dictionary in arena*/
+        DictionaryCompressedColumn(const std::string &name, AttributeType db_type, const MemoryArenaPtr &arena);
+
+        /*! \brief shares the codes and the dictionary of column*/
+        DictionaryCompressedColumn(const DictionaryCompressedColumn &column);
+
         virtual ~DictionaryCompressedColumn();
 
         virtual void serialize(boost::archive::binary_oarchive& out);
@@ -35,6 +55,17 @@ namespace CoGaDB {
 
         virtual int getKeyFor(const T &value, bool* known);
 
+        /*! \brief renumbers the codes of all live values densely (in ascending value order), rewrites the code vector in parallel
+         *  and shrinks the code width if possible*/
+        void compact();
+
+        /*! \brief share of dead codes (codes in the free list) of all codes ever handed out, in [0,1]*/
+        double getDeadCodeShare() const;
+
+        /*! \brief compact() is called automatically when the share of dead codes exceeds threshold, values > 1 disable it*/
+        void setCompactionThreshold(double threshold);
+
+        /*! \brief appends the values of [first,last), large inputs are encoded block-wise in parallel*/
         template<typename InputIterator>
         bool insert(InputIterator first, InputIterator last);
 
@@ -42,6 +73,8 @@ namespace CoGaDB {
 
         virtual bool update(PositionListPtr tid, const boost::any &new_value);
 
+        virtual bool update(TID tid, const T &new_value);
+
         virtual bool remove(TID tid);
 
         //assumes tid list is sorted ascending
@@ -51,13 +84,22 @@ namespace CoGaDB {
 
         virtual const boost::any get(TID tid);
 
+        virtual T getValue(TID tid);
+
+        /*! \brief getValue() copies the value out of the dictionary, so several threads may read*/
+        virtual bool supportsConcurrentReads() const;
+
+        /*! \brief gathers the codes first and translates them with one call of the dictionary*/
+        virtual void gather(const PositionList &tids, T *output);
+
         //virtual const boost::any* const getRawData()=0;
         virtual void print() const throw();
 
         virtual size_t size() const throw();
 
-        virtual unsigned int getSizeinBytes() const throw();
+        virtual size_t getSizeinBytes() const throw();
 
+        /*! \brief the copy shares the codes and a private dictionary with this column, until one of them is modified*/
         virtual const ColumnPtr copy() const;
 
         virtual bool store(const std::string &path);
@@ -65,14 +107,59 @@ namespace CoGaDB {
         virtual bool load(const std::string &path);
 
 
-        virtual T &operator[](const int index);
+        /*! \brief duplicates a private dictionary first, if a copy of this column still shares it*/
+        virtual T &operator[](const TID index);
+
+        /*! \brief joins on the codes, if join_column is a dictionary compressed column with the same dictionary, otherwise on the values*/
+        virtual const PositionListPairPtr hash_join(ColumnPtr join_column);
+
+        virtual const PositionListPairPtr nested_loop_join(ColumnPtr join_column);
+
+        typedef shared_pointer_namespace::shared_ptr<Dictionary<T> > DictionaryPtr;
+
+        const DictionaryPtr getDictionary() const;
+
+        /*! \brief re-encodes all rows with dictionary and shares it from now on, e.g., after load() restored a private dictionary*/
+        void setDictionary(DictionaryPtr dictionary);
+
+    protected:
+        template<typename InputIterator>
+        bool insert(InputIterator first, InputIterator last, std::input_iterator_tag);
+
+        /*! \brief encodes every block of parallel_encoding_block_size rows with a thread local dictionary, merges the local dictionaries
+         *  into the dictionary of the column and writes the codes of the blocks concurrently through a remap of the local codes, which
+         *  are kept per row, so the rows are not looked up a second time*/
+        template<typename RandomAccessIterator>
+        bool insert(RandomAccessIterator first, RandomAccessIterator last, std::random_access_iterator_tag);
+
+        /*! \brief returns the key for value and increments its row count*/
+        int acquireKey(const T &value);
+
+        /*! \brief returns the key for value and increments its row count by number_of_rows*/
+        int acquireKey(const T &value, int number_of_rows);
+
+        /*! \brief duplicates a private dictionary before it is modified, if a copy of this column still shares it*/
+        void detachDictionary();
+
+        /*! \brief encodes the values with dictionary from now on, the codes are not changed*/
+        void replaceDictionary(DictionaryPtr dictionary);
+
+        /*! \brief decrements the row count of key, drops the dictionary entries and frees the key when no row uses it anymore*/
+        void releaseKey(int key);
+
+        /*! \brief returns the partner column, if it is a dictionary compressed column with the same dictionary, otherwise a null pointer*/
+        const shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> > getCodeJoinPartner(ColumnPtr join_column) const;
+
+    private:
+        DictionaryCompressedColumn &operator=(const DictionaryCompressedColumn &);
 
     public:
-        std::map<T, int> insert_dict_;
-        std::map<int, T> at_dict_;
-        std::map<int, int> value_count_dict_;
-        int last_key_;
-        Column<int> column_;
+        DictionaryPtr dictionary_;
+        /*! true, if the dictionary was shared with other columns on purpose, e.g., to join on codes, false, if it is private to the
+         *  column and only shared by its copies until one of them modifies it*/
+        bool shares_dictionary_;
+        double compaction_threshold_;
+        PackedCodeVector column_;
     };
 
 
@@ -82,16 +169,40 @@ namespace CoGaDB {
     //call super constructor & init empty dictionary
     template<class T>
     DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string &name, AttributeType db_type): CompressedColumn<T>(name, db_type)
-            ,insert_dict_(),at_dict_(),value_count_dict_(),last_key_(),column_(name,AttributeType::INT) {
-        this->insert_dict_ = std::map<T, int>();
-        this->at_dict_ = std::map<int, T>();
-        this->value_count_dict_ = std::map<int, int>();
-        this->last_key_ = 0;
-        this->column_ = Column<int>(name,AttributeType::INT);
+            ,dictionary_(new Dictionary<T>()),shares_dictionary_(false),compaction_threshold_(0.5),column_() {
+        this->dictionary_->registerColumn();
+    }
+
+    template<class T>
+    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string &name, AttributeType db_type, DictionaryPtr dictionary)
+            : CompressedColumn<T>(name, db_type), dictionary_(dictionary), shares_dictionary_(true), compaction_threshold_(0.5),
+              column_(1, ColumnAllocator<unsigned char>(dictionary->getArena())) {
+        this->dictionary_->registerColumn();
+    }
+
+    template<class T>
+    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string &name, AttributeType db_type, const MemoryArenaPtr &arena)
+            : CompressedColumn<T>(name, db_type), dictionary_(new Dictionary<T>(arena)), shares_dictionary_(false), compaction_threshold_(0.5),
+              column_(1, ColumnAllocator<unsigned char>(arena)) {
+        this->dictionary_->registerColumn();
+    }
+
+    template<class T>
+    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const DictionaryCompressedColumn &column)
+            : CompressedColumn<T>(column), dictionary_(column.dictionary_), shares_dictionary_(column.shares_dictionary_),
+              compaction_threshold_(column.compaction_threshold_), column_(column.column_) {
+        this->dictionary_->registerColumn();
     }
 
     template<class T>
     DictionaryCompressedColumn<T>::~DictionaryCompressedColumn()  {
+        //rows of this column no longer use their codes of a shared dictionary
+        if (this->dictionary_ && this->shares_dictionary_) {
+            for (TID i = 0; i < this->column_.size(); ++i) {
+                this->dictionary_->releaseKey(this->column_.get(i));
+            }
+        }
+        if (this->dictionary_) this->dictionary_->unregisterColumn();
         //this->insert_dict_ = std::map<T, int>();
         //this->at_dict_ = std::map<int, T>();
         //this->last_key_ = 0;
@@ -119,58 +230,123 @@ namespace CoGaDB {
 
     template<class T>
     bool DictionaryCompressedColumn<T>::insert(const T &value) {
-        bool* known = new bool;
-        *known = 0;
-        int key = getKeyFor(value,known);
-        bool inserted = this->column_.insert(key);
-        //increment value count for already known value
-        if(inserted && known){
-            this->value_count_dict_[key]=this->value_count_dict_[key]+1;
+        int key = acquireKey(value);
+        this->column_.push_back(key);
+        return true;
+    }
+
+    template<class T>
+    int DictionaryCompressedColumn<T>::acquireKey(const T &value) {
+        detachDictionary();
+        return this->dictionary_->acquireKey(value);
+    }
+
+    template<class T>
+    int DictionaryCompressedColumn<T>::acquireKey(const T &value, int number_of_rows) {
+        detachDictionary();
+        return this->dictionary_->acquireKey(value, number_of_rows);
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::releaseKey(int key) {
+        detachDictionary();
+        if (this->dictionary_->releaseKey(key) && this->dictionary_->getNumberOfColumns() == 1 && getDeadCodeShare() > this->compaction_threshold_) {
+            compact();
         }
-        return inserted;
     }
 
     template<class T>
     int DictionaryCompressedColumn<T>::getKeyFor(const T &value, bool* known){
-        auto it = insert_dict_.find(value);
-        int key = -1;
-        if (it != insert_dict_.end()) {
-            key = it->second;
-        }
-        if (key!=-1) {
-            std::cout << "Key for value: " << value << " is already known: " << key <<   std::endl;
-            *known = 1;
-            //we already know the value
-        } else {
-            *known = 0;
-            //lernen wert
-            key = this->last_key_ + 1;
-            this->last_key_ = this->last_key_ + 1;
-            std::cout << "Key for value: " << value << " is not already known. Insert new key (lastkey +1) in dicts: " << key <<   std::endl;
-            insert_dict_.insert(std::make_pair(value,key));
-            at_dict_.insert(std::make_pair(key, value));
-            value_count_dict_.insert(std::make_pair(key, 1));
-        }
-        return key;
+        //an unknown value is inserted into the dictionary
+        detachDictionary();
+        return this->dictionary_->getKeyFor(value, known);
     }
 
     template<typename T>
     template<typename InputIterator>
-    bool DictionaryCompressedColumn<T>::insert(InputIterator start, InputIterator end) {
-        bool inserted = true;
-        for (auto it = start; it != end; ++it) {
-            inserted = insert(*it);
+    bool DictionaryCompressedColumn<T>::insert(InputIterator first, InputIterator last) {
+        return insert(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+    }
+
+    template<typename T>
+    template<typename InputIterator>
+    bool DictionaryCompressedColumn<T>::insert(InputIterator first, InputIterator last, std::input_iterator_tag) {
+        //the second pass reads the input again
+        std::vector<T> values(first, last);
+        return insert(values.begin(), values.end(), std::random_access_iterator_tag());
+    }
+
+    template<typename T>
+    template<typename RandomAccessIterator>
+    bool DictionaryCompressedColumn<T>::insert(RandomAccessIterator first, RandomAccessIterator last, std::random_access_iterator_tag) {
+        const TID number_of_values = last - first;
+        if (number_of_values == 0) return true;
+        const TID number_of_blocks = (number_of_values + parallel_encoding_block_size - 1) / parallel_encoding_block_size;
+
+        //local codes are dense per block: values[code] is the value and counts[code] its number of rows in the block
+        struct LocalDictionary {
+            LocalDictionary() : codes(), values(), counts(), remap() {}
+
+            boost::unordered_map<T, unsigned int> codes;
+            std::vector<T> values;
+            std::vector<int> counts;
+            std::vector<unsigned int> remap;
+        };
+        std::vector<LocalDictionary> blocks(number_of_blocks);
+        std::vector<unsigned int> local_codes(number_of_values);
+        parallel_for(0, number_of_blocks, [&](TID block_begin, TID block_end) {
+            for (TID block = block_begin; block < block_end; ++block) {
+                LocalDictionary &dictionary = blocks[block];
+                const TID end = std::min(number_of_values, (block + 1) * parallel_encoding_block_size);
+                for (TID i = block * parallel_encoding_block_size; i < end; ++i) {
+                    std::pair<typename boost::unordered_map<T, unsigned int>::iterator, bool> inserted =
+                            dictionary.codes.insert(std::make_pair(first[i], static_cast<unsigned int>(dictionary.values.size())));
+                    local_codes[i] = inserted.first->second;
+                    if (inserted.second) {
+                        dictionary.values.push_back(first[i]);
+                        dictionary.counts.push_back(1);
+                    } else {
+                        ++dictionary.counts[inserted.first->second];
+                    }
+                }
+            }
+        }, getNumberOfAvailableThreads(), 1);
+
+        //the merge touches every distinct value of a block once, not every row
+        for (TID block = 0; block < number_of_blocks; ++block) {
+            LocalDictionary &dictionary = blocks[block];
+            dictionary.remap.resize(dictionary.values.size());
+            for (size_t code = 0; code < dictionary.values.size(); ++code) {
+                dictionary.remap[code] = acquireKey(dictionary.values[code], dictionary.counts[code]);
+            }
         }
-        return inserted;
+        const int max_key = this->dictionary_->getLastKey();
+
+        //widen the codes once up front, so the blocks write disjoint bytes without repacking
+        const TID old_size = this->column_.size();
+        if (PackedCodeVector::widthFor(max_key) > this->column_.width()) {
+            this->column_.repack(PackedCodeVector::widthFor(max_key));
+        }
+        this->column_.resize(old_size + number_of_values);
+        PackedCodeVector &codes = this->column_;
+        parallel_for(0, number_of_blocks, [&](TID block_begin, TID block_end) {
+            for (TID block = block_begin; block < block_end; ++block) {
+                const LocalDictionary &dictionary = blocks[block];
+                const TID end = std::min(number_of_values, (block + 1) * parallel_encoding_block_size);
+                for (TID i = block * parallel_encoding_block_size; i < end; ++i) {
+                    codes.set(old_size + i, dictionary.remap[local_codes[i]]);
+                }
+            }
+        }, getNumberOfAvailableThreads(), 1);
+        return true;
     }
 
     template<class T>
     const boost::any DictionaryCompressedColumn<T>::get(TID id) {
-        boost::any anyKey = this->column_.get(id);
-        if(!anyKey.empty()){
+        if(id < this->column_.size()){
             //valid key found
-            int key = boost::any_cast<int>(anyKey);
-            T value = at_dict_.at(key);
+            int key = this->column_.get(id);
+            T value = this->dictionary_->getValue(key);
             //if(value!=null){
 
 
@@ -186,9 +362,32 @@ namespace CoGaDB {
         return boost::any();
     }
 
+    template<class T>
+    T DictionaryCompressedColumn<T>::getValue(TID id) {
+        return this->dictionary_->getValue(this->column_.get(id));
+    }
+
+    template<class T>
+    bool DictionaryCompressedColumn<T>::supportsConcurrentReads() const {
+        return true;
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::gather(const PositionList &tids, T *output) {
+        std::vector<unsigned int> codes(tids.size());
+        for (size_t i = 0; i < tids.size(); ++i) {
+            codes[i] = this->column_.get(tids[i]);
+        }
+        this->dictionary_->getValues(codes, output);
+    }
+
     template<class T>
     void DictionaryCompressedColumn<T>::print() const throw() {
-        this->column_.print();
+        std::cout << "| " << this->name_ << " |" << std::endl;
+        std::cout << "________________________" << std::endl;
+        for (TID i = 0; i < this->column_.size(); i++) {
+            std::cout << "| " << this->column_.get(i) << " |" << std::endl;
+        }
     }
 
     template<class T>
@@ -198,47 +397,60 @@ namespace CoGaDB {
 
     template<class T>
     const ColumnPtr DictionaryCompressedColumn<T>::copy() const {
-        return ColumnPtr(new DictionaryCompressedColumn<T>(*this));
+        shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> > column(new DictionaryCompressedColumn<T>(*this));
+        if (this->shares_dictionary_) {
+            //the copy uses the shared dictionary as well, so its rows count as users of their codes
+            for (TID i = 0; i < this->column_.size(); ++i) {
+                this->dictionary_->retainKey(this->column_.get(i));
+            }
+        }
+        //a private dictionary is duplicated by the first modification of either column
+        return column;
     }
 
     template<class T>
     bool DictionaryCompressedColumn<T>::update(TID id, const boost::any &patch) {
         if(isOfTypeT(patch)){
-            bool* known = new bool;
-            *known = 0;
-            T value = boost::any_cast<T>(patch);
-            int key = this->getKeyFor(value,known);
-            return this->column_.update(id,key);
+            return update(id, boost::any_cast<T>(patch));
         }else{
             return false;
         }
     }
 
+    template<class T>
+    bool DictionaryCompressedColumn<T>::update(TID id, const T &value) {
+        if (id >= this->column_.size()) {
+            return false;
+        }
+        //acquire the new key first, so updating a row to its own value does not free the key
+        int key = acquireKey(value);
+        int old_key = this->column_.get(id);
+        this->column_.set(id, key);
+        releaseKey(old_key);
+        return true;
+    }
+
     template<class T>
     bool DictionaryCompressedColumn<T>::update(PositionListPtr ptr, const boost::any &value) {
         if (value.empty() || typeid(T) != value.type()) {
             return false;
         }
+        const T new_value = boost::any_cast<T>(value);
         for (auto it = ptr->begin(); it != ptr->end(); ++it) {
-            this->update(*it, value);
+            this->update(*it, new_value);
         }
         return true;
     }
 
     template<class T>
     bool DictionaryCompressedColumn<T>::remove(TID id) {
-        int key = this->column_[id];
-        int value_count = this->value_count_dict_[key];
-        if(value_count==1){
-            this->value_count_dict_.erase(key);
-            T val = this->at_dict_[key];
-            this->at_dict_.erase(key);
-            this->insert_dict_.erase(val);
-
-        }else{
-            this->value_count_dict_[key]=this->value_count_dict_[key]-1;
+        if (id >= this->column_.size()) {
+            return false;
         }
-        return this->column_.remove(id);
+        int key = this->column_.get(id);
+        this->column_.erase(id);
+        releaseKey(key);
+        return true;
     }
 
     template<class T>
@@ -257,45 +469,84 @@ namespace CoGaDB {
 
     template<class T>
     bool DictionaryCompressedColumn<T>::clearContent() {
-        this->insert_dict_.clear();
-        this->value_count_dict_.clear();
-        this->at_dict_.clear();
-        this->last_key_=0;
-        return this->column_.clearContent();
+        if (!this->shares_dictionary_) {
+            //a copy, which still shares the private dictionary, keeps it
+            if (this->dictionary_->getNumberOfColumns() == 1) {
+                this->dictionary_->clear();
+            } else {
+                replaceDictionary(DictionaryPtr(new Dictionary<T>(this->dictionary_->getArena())));
+            }
+        } else {
+            //the other columns still use the dictionary, so only the codes of this column are released
+            for (TID i = 0; i < this->column_.size(); ++i) {
+                this->dictionary_->releaseKey(this->column_.get(i));
+            }
+        }
+        //free the codes, so an arena, which only holds this column, unmaps its chunks
+        this->column_ = PackedCodeVector(1, this->column_.getAllocator());
+        return true;
     }
 
+    template<class T>
+    void DictionaryCompressedColumn<T>::detachDictionary() {
+        if (!this->shares_dictionary_ && this->dictionary_->getNumberOfColumns() > 1) {
+            replaceDictionary(DictionaryPtr(new Dictionary<T>(*this->dictionary_)));
+        }
+    }
 
-    //map serialize and deserialize
     template<class T>
-    void DictionaryCompressedColumn<T>::serialize(boost::archive::binary_oarchive& out) {
-        out << this->insert_dict_.size();
-        for (auto const& p: insert_dict_) { out << p.first << p.second; }
-        out << this->at_dict_.size();
-        for (auto const& p: at_dict_) { out << p.first << p.second; }
+    void DictionaryCompressedColumn<T>::replaceDictionary(DictionaryPtr dictionary) {
+        dictionary->registerColumn();
+        this->dictionary_->unregisterColumn();
+        this->dictionary_ = dictionary;
     }
 
     template<class T>
-    void DictionaryCompressedColumn<T>::deserialize(boost::archive::binary_iarchive& in) {
-        size_t size = 0;
-        in >> size;
-
-        for (size_t i = 0; i != size; ++i) {
-            T key;
-            int value;
-            in >> key >> value;
-            this->insert_dict_[key] = value;
-        }
+    double DictionaryCompressedColumn<T>::getDeadCodeShare() const {
+        return this->dictionary_->getDeadCodeShare();
+    }
 
-        size_t size2 = 0;
-        in >> size2;
+    template<class T>
+    void DictionaryCompressedColumn<T>::setCompactionThreshold(double threshold) {
+        this->compaction_threshold_ = threshold;
+    }
 
-        for (size_t i = 0; i != size; ++i) {
-            int key;
-            T value;
-            in >> key >> value;
-            this->at_dict_[key] = value;
+    template<class T>
+    void DictionaryCompressedColumn<T>::compact() {
+        detachDictionary();
+        if (this->dictionary_->getNumberOfColumns() > 1) {
+            std::cout << "Fatal Error! The dictionary of column " << this->name_ << " is shared and can not be compacted" << std::endl;
+            return;
         }
+        //assign dense keys 1..n in ascending value order, remap[old_key] is the new key
+        std::vector<unsigned int> remap = this->dictionary_->compact();
+        int new_key = this->dictionary_->getLastKey();
+
+        //rewrite the code vector with the narrowest width, every thread rewrites a disjoint range of rows
+        PackedCodeVector codes(PackedCodeVector::widthFor(new_key), this->column_.getAllocator());
+        codes.resize(this->column_.size());
+        const PackedCodeVector &old_codes = this->column_;
+        parallel_for(0, old_codes.size(), [&codes, &old_codes, &remap](TID begin, TID end) {
+            for (TID i = begin; i < end; ++i) {
+                codes.set(i, remap[old_codes.get(i)]);
+            }
+        });
+
+        std::swap(this->column_, codes);
+    }
+
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::serialize(boost::archive::binary_oarchive& out) {
+        this->dictionary_->serialize(out);
+    }
 
+    template<class T>
+    void DictionaryCompressedColumn<T>::deserialize(boost::archive::binary_iarchive& in) {
+        //a loaded column gets its own dictionary, setDictionary() shares it again
+        replaceDictionary(DictionaryPtr(new Dictionary<T>(this->dictionary_->getArena())));
+        this->shares_dictionary_ = false;
+        this->dictionary_->deserialize(in);
     }
 
     template<class T>
@@ -309,13 +560,21 @@ namespace CoGaDB {
         std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
         boost::archive::binary_oarchive oa(outfile);
 
-        oa << last_key_;
         serialize(oa);
 
 
         outfile.flush();
         outfile.close();
-        return this->column_.store(path_);
+
+        std::string column_path(path_);
+        column_path += "/";
+        column_path += this->name_;
+        std::ofstream column_file (column_path.c_str(),std::ios_base::binary | std::ios_base::out);
+        boost::archive::binary_oarchive column_archive(column_file);
+        column_archive << this->column_;
+        column_file.flush();
+        column_file.close();
+        return true;
     }
 
     template<class T>
@@ -327,30 +586,134 @@ namespace CoGaDB {
         path += this->name_+"-meta";
 
         //std::cout << "Opening File '" << path << "'..." << std::endl;
-        std::ifstream infile (path.c_str(),std::ios_base::binary | std::ios_base::in);
+        ColumnInputFile infile (path);
         boost::archive::binary_iarchive ia(infile);
 
-        ia >> last_key_;
         deserialize(ia);
 
         infile.close();
 
-
-        return this->column_.load(path_);
+        std::string column_path(path_);
+        column_path += "/";
+        column_path += this->name_;
+        ColumnInputFile column_file (column_path);
+        boost::archive::binary_iarchive column_archive(column_file);
+        column_archive >> this->column_;
+        column_file.close();
+
+        //the stored counts include the rows of all columns, which shared the dictionary, so only the rows of this column are counted
+        std::vector<int> row_counts(this->dictionary_->getLastKey() + 1, 0);
+        for (TID i = 0; i < this->column_.size(); ++i) {
+            ++row_counts[this->column_.get(i)];
+        }
+        this->dictionary_->setRowCounts(row_counts);
+        if (getDeadCodeShare() > this->compaction_threshold_) {
+            compact();
+        }
+        return true;
     }
 
 
     template<class T>
-    T &DictionaryCompressedColumn<T>::operator[](const int index) {
+    T &DictionaryCompressedColumn<T>::operator[](const TID index) {
         //std::cout << "Array operator called with index: " << index << std::endl;
-        int& key = this->column_[index];
+        //the caller may write the value, so a copy must not see it
+        detachDictionary();
+        int key = this->column_.get(index);
         //std::cout << "Found key for this index: " << key << std::endl;
-        return at_dict_.at(key);
+        return this->dictionary_->getValue(key);
+    }
+
+    template<class T>
+    const typename DictionaryCompressedColumn<T>::DictionaryPtr DictionaryCompressedColumn<T>::getDictionary() const {
+        return this->dictionary_;
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::setDictionary(DictionaryPtr dictionary) {
+        if (dictionary == this->dictionary_) return;
+        PackedCodeVector codes(1, this->column_.getAllocator());
+        for (TID i = 0; i < this->column_.size(); ++i) {
+            int old_key = this->column_.get(i);
+            codes.push_back(dictionary->acquireKey(this->dictionary_->getValue(old_key)));
+            if (this->shares_dictionary_) this->dictionary_->releaseKey(old_key);
+        }
+        std::swap(this->column_, codes);
+        replaceDictionary(dictionary);
+        this->shares_dictionary_ = true;
+    }
+
+    template<class T>
+    const shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> > DictionaryCompressedColumn<T>::getCodeJoinPartner(ColumnPtr join_column) const {
+        shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> > partner =
+                shared_pointer_namespace::dynamic_pointer_cast<DictionaryCompressedColumn<T> >(join_column);
+        if (!partner || partner->dictionary_ != this->dictionary_) {
+            return shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> >();
+        }
+        return partner;
+    }
+
+    template<class T>
+    const PositionListPairPtr DictionaryCompressedColumn<T>::hash_join(ColumnPtr join_column) {
+        shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> > partner = getCodeJoinPartner(join_column);
+        if (!partner) {
+            return ColumnBaseTyped<T>::hash_join(join_column);
+        }
+        //equal values have equal codes, so the build side is bucketed by code in a table, which is indexed by code
+        size_t number_of_codes = this->dictionary_->getLastKey() + 1;
+        std::vector<TID> bucket_begin(number_of_codes + 1, 0);
+        for (TID i = 0; i < this->column_.size(); ++i) {
+            ++bucket_begin[this->column_.get(i) + 1];
+        }
+        for (size_t code = 1; code <= number_of_codes; ++code) {
+            bucket_begin[code] += bucket_begin[code - 1];
+        }
+        std::vector<TID> build_tids(this->column_.size());
+        std::vector<TID> bucket_end(bucket_begin.begin(), bucket_begin.end() - 1);
+        for (TID i = 0; i < this->column_.size(); ++i) {
+            build_tids[bucket_end[this->column_.get(i)]++] = i;
+        }
+
+        PositionListPairPtr join_tids(new PositionListPair());
+        join_tids->first = PositionListPtr(new PositionList());
+        join_tids->second = PositionListPtr(new PositionList());
+        const PackedCodeVector &probe_codes = partner->column_;
+        for (TID i = 0; i < probe_codes.size(); ++i) {
+            unsigned int code = probe_codes.get(i);
+            for (TID j = bucket_begin[code]; j < bucket_begin[code + 1]; ++j) {
+                join_tids->first->push_back(build_tids[j]);
+                join_tids->second->push_back(i);
+            }
+        }
+        return join_tids;
+    }
+
+    template<class T>
+    const PositionListPairPtr DictionaryCompressedColumn<T>::nested_loop_join(ColumnPtr join_column) {
+        shared_pointer_namespace::shared_ptr<DictionaryCompressedColumn<T> > partner = getCodeJoinPartner(join_column);
+        if (!partner) {
+            return ColumnBaseTyped<T>::nested_loop_join(join_column);
+        }
+        PositionListPairPtr join_tids(new PositionListPair());
+        join_tids->first = PositionListPtr(new PositionList());
+        join_tids->second = PositionListPtr(new PositionList());
+        for (TID i = 0; i < this->column_.size(); ++i) {
+            unsigned int code = this->column_.get(i);
+            for (TID j = 0; j < partner->column_.size(); ++j) {
+                if (partner->column_.get(j) == code) {
+                    join_tids->first->push_back(i);
+                    join_tids->second->push_back(j);
+                }
+            }
+        }
+        return join_tids;
     }
 
     template<class T>
-    unsigned int DictionaryCompressedColumn<T>::getSizeinBytes() const throw() {
-        return this->column_.getSizeinBytes(); //return values_.capacity()*sizeof(T);
+    size_t DictionaryCompressedColumn<T>::getSizeinBytes() const throw() {
+        //the columns, which share the dictionary, share its memory, other holders of the dictionary do not
+        return this->column_.getSizeinBytes() + this->dictionary_->getSizeinBytes() / std::max<size_t>(1, this->dictionary_->getNumberOfColumns())
+               + this->getIndexSizeinBytes();
     }
 
 /***************** End of Implementation Section ******************/
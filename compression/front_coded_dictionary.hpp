@@ -0,0 +1,198 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <boost/serialization/vector.hpp>
+#include <boost/utility/string_view.hpp>
+
+namespace CoGaDB {
+
+/*!
+ *  \brief     An immutable, sorted set of strings, which is stored front coded in one byte array. The code of a string is its position in sort order.
+ *  \details   The strings are split into blocks of block_size strings. The first string of a block (the block head) is stored completely,
+ *             every other string only stores the length of the prefix it shares with its predecessor and the remaining suffix. Lengths are
+ *             stored as variable length integers. Decoding a code decodes at most block_size-1 strings of its block, a lookup does a binary
+ *             search over the block heads and decodes a single block, so no lookup has to decompress the whole dictionary.
+ */
+    class FrontCodedDictionary {
+    public:
+        static const unsigned int block_size = 16;
+
+        FrontCodedDictionary();
+
+        /*! \brief replaces the content by the strings in [first,last), which have to be sorted ascending and must not contain duplicates*/
+        template<typename InputIterator>
+        void build(InputIterator first, InputIterator last);
+
+        void clear();
+
+        /*! \brief number of strings in the dictionary*/
+        unsigned int size() const;
+
+        /*! \brief returns the string with the given code*/
+        std::string decode(unsigned int code) const;
+
+        /*! \brief writes the string with the given code to value, reuses the memory of value*/
+        void decode(unsigned int code, std::string &value) const;
+
+        /*! \brief returns the code of the first string, which is not less than value, *found is set to true if this string equals value*/
+        unsigned int lowerBound(const boost::string_view &value, bool *found) const;
+
+        size_t getSizeinBytes() const;
+
+        template<class Archive>
+        void serialize(Archive &ar, const unsigned int) {
+            ar & size_;
+            ar & bytes_;
+            ar & block_offsets_;
+        }
+
+    private:
+        static void writeLength(std::vector<unsigned char> &bytes, uint32_t length);
+
+        static uint32_t readLength(const unsigned char *&position);
+
+        boost::string_view getBlockHead(unsigned int block) const;
+
+        unsigned int size_;
+        std::vector<unsigned char> bytes_;
+        /*! offset of every block head in bytes_*/
+        std::vector<uint32_t> block_offsets_;
+    };
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    inline FrontCodedDictionary::FrontCodedDictionary() : size_(0), bytes_(), block_offsets_() {
+    }
+
+    inline void FrontCodedDictionary::writeLength(std::vector<unsigned char> &bytes, uint32_t length) {
+        while (length >= 0x80) {
+            bytes.push_back(static_cast<unsigned char>(length | 0x80));
+            length >>= 7;
+        }
+        bytes.push_back(static_cast<unsigned char>(length));
+    }
+
+    inline uint32_t FrontCodedDictionary::readLength(const unsigned char *&position) {
+        uint32_t length = 0;
+        unsigned int shift = 0;
+        while (*position & 0x80) {
+            length |= uint32_t(*position & 0x7F) << shift;
+            shift += 7;
+            ++position;
+        }
+        length |= uint32_t(*position) << shift;
+        ++position;
+        return length;
+    }
+
+    template<typename InputIterator>
+    void FrontCodedDictionary::build(InputIterator first, InputIterator last) {
+        clear();
+        boost::string_view previous;
+        for (InputIterator it = first; it != last; ++it) {
+            boost::string_view value(*it);
+            if (size_ % block_size == 0) {
+                block_offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+                writeLength(bytes_, static_cast<uint32_t>(value.size()));
+                bytes_.insert(bytes_.end(), value.begin(), value.end());
+            } else {
+                size_t prefix_length = 0;
+                while (prefix_length < previous.size() && prefix_length < value.size()
+                       && previous[prefix_length] == value[prefix_length]) {
+                    ++prefix_length;
+                }
+                writeLength(bytes_, static_cast<uint32_t>(prefix_length));
+                writeLength(bytes_, static_cast<uint32_t>(value.size() - prefix_length));
+                bytes_.insert(bytes_.end(), value.begin() + prefix_length, value.end());
+            }
+            previous = value;
+            ++size_;
+        }
+    }
+
+    inline void FrontCodedDictionary::clear() {
+        size_ = 0;
+        bytes_.clear();
+        block_offsets_.clear();
+    }
+
+    inline unsigned int FrontCodedDictionary::size() const {
+        return size_;
+    }
+
+    inline boost::string_view FrontCodedDictionary::getBlockHead(unsigned int block) const {
+        const unsigned char *position = &bytes_[block_offsets_[block]];
+        uint32_t length = readLength(position);
+        return boost::string_view(reinterpret_cast<const char *>(position), length);
+    }
+
+    inline std::string FrontCodedDictionary::decode(unsigned int code) const {
+        std::string value;
+        decode(code, value);
+        return value;
+    }
+
+    inline void FrontCodedDictionary::decode(unsigned int code, std::string &value) const {
+        const unsigned char *position = &bytes_[block_offsets_[code / block_size]];
+        uint32_t length = readLength(position);
+        value.assign(reinterpret_cast<const char *>(position), length);
+        position += length;
+        for (unsigned int i = 0; i < code % block_size; ++i) {
+            uint32_t prefix_length = readLength(position);
+            uint32_t suffix_length = readLength(position);
+            value.resize(prefix_length);
+            value.append(reinterpret_cast<const char *>(position), suffix_length);
+            position += suffix_length;
+        }
+    }
+
+    inline unsigned int FrontCodedDictionary::lowerBound(const boost::string_view &value, bool *found) const {
+        *found = false;
+        //find the last block whose head is not greater than value
+        unsigned int begin = 0;
+        unsigned int end = static_cast<unsigned int>(block_offsets_.size());
+        while (begin < end) {
+            unsigned int middle = begin + (end - begin) / 2;
+            if (value < getBlockHead(middle)) {
+                end = middle;
+            } else {
+                begin = middle + 1;
+            }
+        }
+        //value is smaller than all strings
+        if (begin == 0) return 0;
+        unsigned int block = begin - 1;
+
+        //scan the block, all strings of later blocks are greater than value
+        unsigned int code = block * block_size;
+        const unsigned char *position = &bytes_[block_offsets_[block]];
+        uint32_t length = readLength(position);
+        std::string current(reinterpret_cast<const char *>(position), length);
+        position += length;
+        while (true) {
+            int comparison = boost::string_view(current).compare(value);
+            if (comparison >= 0) {
+                *found = (comparison == 0);
+                return code;
+            }
+            ++code;
+            if (code == size_ || code % block_size == 0) return code;
+            uint32_t prefix_length = readLength(position);
+            uint32_t suffix_length = readLength(position);
+            current.resize(prefix_length);
+            current.append(reinterpret_cast<const char *>(position), suffix_length);
+            position += suffix_length;
+        }
+    }
+
+    inline size_t FrontCodedDictionary::getSizeinBytes() const {
+        return bytes_.capacity() + block_offsets_.capacity() * sizeof(uint32_t);
+    }
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
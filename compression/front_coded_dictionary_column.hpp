@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+#include <core/compressed_column.hpp>
+#include <core/decode_buffer.hpp>
+#include <core/parallel.hpp>
+#include <compression/front_coded_dictionary.hpp>
+#include <compression/packed_code_vector.hpp>
+
+namespace CoGaDB {
+
+
+/*!
+ *  \brief     This class represents a dictionary compressed string column, whose dictionary is front coded.
+ *  \details   Unlike CoGaDB::DictionaryCompressedColumn, every distinct string is stored only once and without a tree node of its own: the
+ *  bulk of the dictionary is a CoGaDB::FrontCodedDictionary, whose codes are the positions of the strings in sort order. Strings inserted after
+ *  the dictionary was built get the codes after it and are kept in a small overflow map, until the dictionary is rebuilt from all live
+ *  strings. Codes whose last row was removed stay dead until the next rebuild, which happens when dead codes and overflow strings together
+ *  make up a quarter of all codes. Equality and range selections are evaluated on the codes, only overflow strings are compared as strings.
+ */
+    class FrontCodedDictionaryColumn : public CompressedColumn<std::string> {
+    public:
+        /***************** constructors and destructor *****************/
+        FrontCodedDictionaryColumn(const std::string &name, AttributeType db_type);
+
+        FrontCodedDictionaryColumn(const FrontCodedDictionaryColumn &column);
+
+        virtual ~FrontCodedDictionaryColumn();
+
+        virtual bool insert(const boost::any &new_Value);
+
+        virtual bool insert(const std::string &new_value);
+
+        template<typename InputIterator>
+        bool insert(InputIterator first, InputIterator last);
+
+        virtual bool update(TID tid, const boost::any &new_value);
+
+        virtual bool update(PositionListPtr tid, const boost::any &new_value);
+
+        virtual bool remove(TID tid);
+
+        //assumes tid list is sorted ascending
+        virtual bool remove(PositionListPtr tid);
+
+        virtual bool clearContent();
+
+        virtual const boost::any get(TID tid);
+
+        virtual void print() const throw();
+
+        virtual size_t size() const throw();
+
+        virtual size_t getSizeinBytes() const throw();
+
+        virtual const ColumnPtr copy() const;
+
+        virtual const PositionListPtr selection(const boost::any &value_for_comparison, const ValueComparator comp);
+
+        virtual bool store(const std::string &path);
+
+        virtual bool load(const std::string &path);
+
+        virtual std::string &operator[](const TID index);
+
+        /*! \brief builds the front coded dictionary from all live strings, renumbers the codes and rewrites the code vector in parallel*/
+        void rebuildDictionary();
+
+        /*! \brief number of strings, which were inserted after the last rebuild of the dictionary*/
+        size_t getNumberOfOverflowValues() const;
+
+    private:
+        typedef std::map<std::string, unsigned int> OverflowMap;
+
+        FrontCodedDictionaryColumn &operator=(const FrontCodedDictionaryColumn &);
+
+        /*! \brief returns the code for value and increments its row count*/
+        unsigned int acquireCode(const std::string &value);
+
+        /*! \brief decrements the row count of code*/
+        void releaseCode(unsigned int code);
+
+        /*! \brief returns the code of value, or false if value is not in the dictionary*/
+        bool findCode(const std::string &value, unsigned int *code) const;
+
+        void decode(unsigned int code, std::string &value) const;
+
+        void rebuildDictionaryIfNecessary();
+
+        FrontCodedDictionary dictionary_;
+        /*! strings inserted after the last rebuild, their codes start at dictionary_.size()*/
+        OverflowMap overflow_codes_;
+        /*! overflow_values_[code-dictionary_.size()] points to the key of the code in overflow_codes_*/
+        std::vector<const std::string *> overflow_values_;
+        /*! number of rows per code*/
+        std::vector<unsigned int> value_counts_;
+        unsigned int number_of_dead_codes_;
+        PackedCodeVector codes_;
+        DecodeBuffer<std::string> decode_buffer_;
+    };
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    inline FrontCodedDictionaryColumn::FrontCodedDictionaryColumn(const std::string &name, AttributeType db_type)
+            : CompressedColumn<std::string>(name, db_type), dictionary_(), overflow_codes_(), overflow_values_(), value_counts_(),
+              number_of_dead_codes_(0), codes_(), decode_buffer_() {
+    }
+
+    inline FrontCodedDictionaryColumn::FrontCodedDictionaryColumn(const FrontCodedDictionaryColumn &column)
+            : CompressedColumn<std::string>(column), dictionary_(column.dictionary_), overflow_codes_(column.overflow_codes_),
+              overflow_values_(column.overflow_values_.size()), value_counts_(column.value_counts_),
+              number_of_dead_codes_(column.number_of_dead_codes_), codes_(column.codes_), decode_buffer_() {
+        //the overflow values have to point into the copied map
+        for (OverflowMap::const_iterator it = overflow_codes_.begin(); it != overflow_codes_.end(); ++it) {
+            overflow_values_[it->second - dictionary_.size()] = &it->first;
+        }
+    }
+
+    inline FrontCodedDictionaryColumn::~FrontCodedDictionaryColumn() {
+    }
+
+    inline bool FrontCodedDictionaryColumn::insert(const boost::any &new_value) {
+        if (new_value.empty() || typeid(std::string) != new_value.type()) {
+            return false;
+        }
+        return insert(boost::any_cast<const std::string &>(new_value));
+    }
+
+    inline bool FrontCodedDictionaryColumn::insert(const std::string &value) {
+        codes_.push_back(acquireCode(value));
+        rebuildDictionaryIfNecessary();
+        return true;
+    }
+
+    template<typename InputIterator>
+    bool FrontCodedDictionaryColumn::insert(InputIterator first, InputIterator last) {
+        for (InputIterator it = first; it != last; ++it) {
+            codes_.push_back(acquireCode(*it));
+        }
+        rebuildDictionaryIfNecessary();
+        return true;
+    }
+
+    inline bool FrontCodedDictionaryColumn::findCode(const std::string &value, unsigned int *code) const {
+        bool found = false;
+        *code = dictionary_.lowerBound(value, &found);
+        if (found) return true;
+        OverflowMap::const_iterator it = overflow_codes_.find(value);
+        if (it == overflow_codes_.end()) return false;
+        *code = it->second;
+        return true;
+    }
+
+    inline unsigned int FrontCodedDictionaryColumn::acquireCode(const std::string &value) {
+        unsigned int code = 0;
+        if (!findCode(value, &code)) {
+            code = static_cast<unsigned int>(value_counts_.size());
+            std::pair<OverflowMap::iterator, bool> inserted = overflow_codes_.insert(std::make_pair(value, code));
+            overflow_values_.push_back(&inserted.first->first);
+            value_counts_.push_back(0);
+        } else if (value_counts_[code] == 0) {
+            //the code was dead, it is used again
+            --number_of_dead_codes_;
+        }
+        ++value_counts_[code];
+        return code;
+    }
+
+    inline void FrontCodedDictionaryColumn::releaseCode(unsigned int code) {
+        if (--value_counts_[code] == 0) {
+            ++number_of_dead_codes_;
+        }
+    }
+
+    inline void FrontCodedDictionaryColumn::decode(unsigned int code, std::string &value) const {
+        if (code < dictionary_.size()) {
+            dictionary_.decode(code, value);
+        } else {
+            value = *overflow_values_[code - dictionary_.size()];
+        }
+    }
+
+    inline bool FrontCodedDictionaryColumn::update(TID tid, const boost::any &new_value) {
+        if (new_value.empty() || typeid(std::string) != new_value.type() || tid >= codes_.size()) {
+            return false;
+        }
+        //acquire the new code first, so updating a row to its own value does not kill the code
+        unsigned int code = acquireCode(boost::any_cast<const std::string &>(new_value));
+        releaseCode(codes_.get(tid));
+        codes_.set(tid, code);
+        rebuildDictionaryIfNecessary();
+        return true;
+    }
+
+    inline bool FrontCodedDictionaryColumn::update(PositionListPtr tids, const boost::any &new_value) {
+        if (!tids || new_value.empty() || typeid(std::string) != new_value.type()) {
+            return false;
+        }
+        for (PositionList::const_iterator it = tids->begin(); it != tids->end(); ++it) {
+            if (!update(*it, new_value)) return false;
+        }
+        return true;
+    }
+
+    inline bool FrontCodedDictionaryColumn::remove(TID tid) {
+        if (tid >= codes_.size()) {
+            return false;
+        }
+        releaseCode(codes_.get(tid));
+        codes_.erase(tid);
+        rebuildDictionaryIfNecessary();
+        return true;
+    }
+
+    inline bool FrontCodedDictionaryColumn::remove(PositionListPtr tids) {
+        if (!tids || tids->empty()) {
+            return false;
+        }
+        //compact the code vector in one pass, every row moves by the number of removed rows before it
+        TID write_position = (*tids)[0];
+        size_t next_removed = 0;
+        for (TID tid = (*tids)[0]; tid < codes_.size(); ++tid) {
+            if (next_removed < tids->size() && (*tids)[next_removed] == tid) {
+                releaseCode(codes_.get(tid));
+                ++next_removed;
+                continue;
+            }
+            codes_.set(write_position++, codes_.get(tid));
+        }
+        codes_.resize(write_position);
+        rebuildDictionaryIfNecessary();
+        return true;
+    }
+
+    inline bool FrontCodedDictionaryColumn::clearContent() {
+        dictionary_.clear();
+        overflow_codes_.clear();
+        overflow_values_.clear();
+        value_counts_.clear();
+        number_of_dead_codes_ = 0;
+        codes_.clear();
+        return true;
+    }
+
+    inline void FrontCodedDictionaryColumn::rebuildDictionaryIfNecessary() {
+        size_t number_of_stale_codes = number_of_dead_codes_ + overflow_values_.size();
+        if (number_of_stale_codes >= 64 && 4 * number_of_stale_codes > value_counts_.size()) {
+            rebuildDictionary();
+        }
+    }
+
+    inline void FrontCodedDictionaryColumn::rebuildDictionary() {
+        //collect the live strings in sort order, the dictionary part is already sorted
+        std::vector<std::pair<std::string, unsigned int> > live_values;
+        live_values.reserve(value_counts_.size() - number_of_dead_codes_);
+        for (unsigned int code = 0; code < value_counts_.size(); ++code) {
+            if (value_counts_[code] == 0) continue;
+            live_values.push_back(std::make_pair(std::string(), code));
+            decode(code, live_values.back().first);
+        }
+        std::sort(live_values.begin(), live_values.end());
+
+        //remap[old_code] is the new code, which is the position in sort order
+        std::vector<unsigned int> remap(value_counts_.size(), 0);
+        std::vector<unsigned int> value_counts(live_values.size());
+        std::vector<std::string> sorted_values(live_values.size());
+        for (unsigned int i = 0; i < live_values.size(); ++i) {
+            remap[live_values[i].second] = i;
+            value_counts[i] = value_counts_[live_values[i].second];
+            sorted_values[i].swap(live_values[i].first);
+        }
+        dictionary_.build(sorted_values.begin(), sorted_values.end());
+
+        //rewrite the code vector with the narrowest width, every thread rewrites a disjoint range of rows
+        PackedCodeVector codes(PackedCodeVector::widthFor(live_values.empty() ? 0 : live_values.size() - 1));
+        codes.resize(codes_.size());
+        const PackedCodeVector &old_codes = codes_;
+        parallel_for(0, old_codes.size(), [&codes, &old_codes, &remap](TID begin, TID end) {
+            for (TID i = begin; i < end; ++i) {
+                codes.set(i, remap[old_codes.get(i)]);
+            }
+        });
+
+        std::swap(codes_, codes);
+        value_counts_.swap(value_counts);
+        overflow_codes_.clear();
+        overflow_values_.clear();
+        number_of_dead_codes_ = 0;
+    }
+
+    inline size_t FrontCodedDictionaryColumn::getNumberOfOverflowValues() const {
+        return overflow_values_.size();
+    }
+
+    inline const boost::any FrontCodedDictionaryColumn::get(TID tid) {
+        if (tid < codes_.size()) {
+            std::string value;
+            decode(codes_.get(tid), value);
+            return boost::any(value);
+        } else {
+            std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid << std::endl;
+        }
+        return boost::any();
+    }
+
+    inline void FrontCodedDictionaryColumn::print() const throw() {
+        std::cout << "| " << this->name_ << " |" << std::endl;
+        std::cout << "________________________" << std::endl;
+        std::string value;
+        for (TID i = 0; i < codes_.size(); i++) {
+            decode(codes_.get(i), value);
+            std::cout << "| " << value << " |" << std::endl;
+        }
+    }
+
+    inline size_t FrontCodedDictionaryColumn::size() const throw() {
+        return codes_.size();
+    }
+
+    inline size_t FrontCodedDictionaryColumn::getSizeinBytes() const throw() {
+        size_t size_in_bytes = dictionary_.getSizeinBytes() + codes_.getSizeinBytes()
+                               + value_counts_.capacity() * sizeof(unsigned int)
+                               + overflow_values_.capacity() * sizeof(const std::string *);
+        for (OverflowMap::const_iterator it = overflow_codes_.begin(); it != overflow_codes_.end(); ++it) {
+            size_in_bytes += sizeof(OverflowMap::value_type) + it->first.capacity();
+        }
+        return size_in_bytes;
+    }
+
+    inline const ColumnPtr FrontCodedDictionaryColumn::copy() const {
+        return ColumnPtr(new FrontCodedDictionaryColumn(*this));
+    }
+
+    inline const PositionListPtr FrontCodedDictionaryColumn::selection(const boost::any &value_for_comparison, const ValueComparator comp) {
+        if (value_for_comparison.type() != typeid(std::string)) {
+            std::cout << "Fatal Error!!! Typemismatch for column " << name_ << std::endl;
+            std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+            exit(-1);
+        }
+        const std::string &value = boost::any_cast<const std::string &>(value_for_comparison);
+
+        //decide the predicate once per code, the dictionary codes are ordered like their strings
+        bool found = false;
+        unsigned int lower_bound = dictionary_.lowerBound(value, &found);
+        std::vector<char> qualifies(value_counts_.size(), 0);
+        for (unsigned int code = 0; code < dictionary_.size(); ++code) {
+            if (comp == EQUAL) {
+                qualifies[code] = found && code == lower_bound;
+            } else if (comp == LESSER) {
+                qualifies[code] = code < lower_bound;
+            } else if (comp == GREATER) {
+                qualifies[code] = code >= lower_bound + (found ? 1 : 0);
+            }
+        }
+        for (OverflowMap::const_iterator it = overflow_codes_.begin(); it != overflow_codes_.end(); ++it) {
+            if (comp == EQUAL) {
+                qualifies[it->second] = it->first == value;
+            } else if (comp == LESSER) {
+                qualifies[it->second] = it->first < value;
+            } else if (comp == GREATER) {
+                qualifies[it->second] = it->first > value;
+            }
+        }
+
+        PositionListPtr result_tids(new PositionList());
+        for (TID i = 0; i < codes_.size(); ++i) {
+            if (qualifies[codes_.get(i)]) result_tids->push_back(i);
+        }
+        return result_tids;
+    }
+
+    inline bool FrontCodedDictionaryColumn::store(const std::string &path_) {
+        std::string path(path_);
+        path += "/";
+        path += this->name_;
+        //store the overflow strings in code order, so load() can restore their codes
+        std::vector<std::string> overflow_values(overflow_values_.size());
+        for (unsigned int i = 0; i < overflow_values_.size(); ++i) {
+            overflow_values[i] = *overflow_values_[i];
+        }
+        std::ofstream outfile(path.c_str(), std::ios_base::binary | std::ios_base::out);
+        boost::archive::binary_oarchive oa(outfile);
+        oa << dictionary_;
+        oa << overflow_values;
+        oa << value_counts_;
+        oa << number_of_dead_codes_;
+        oa << codes_;
+        outfile.flush();
+        outfile.close();
+        return true;
+    }
+
+    inline bool FrontCodedDictionaryColumn::load(const std::string &path_) {
+        std::string path(path_);
+        path += "/";
+        path += this->name_;
+        std::vector<std::string> overflow_values;
+        ColumnInputFile infile (path);
+        boost::archive::binary_iarchive ia(infile);
+        ia >> dictionary_;
+        ia >> overflow_values;
+        ia >> value_counts_;
+        ia >> number_of_dead_codes_;
+        ia >> codes_;
+        infile.close();
+
+        overflow_codes_.clear();
+        overflow_values_.clear();
+        for (unsigned int i = 0; i < overflow_values.size(); ++i) {
+            std::pair<OverflowMap::iterator, bool> inserted = overflow_codes_.insert(
+                    std::make_pair(overflow_values[i], dictionary_.size() + i));
+            overflow_values_.push_back(&inserted.first->first);
+        }
+        return true;
+    }
+
+    inline std::string &FrontCodedDictionaryColumn::operator[](const TID index) {
+        std::string value;
+        decode(codes_.get(index), value);
+        return decode_buffer_.store(value);
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+
+}; //end namespace CogaDB
@@ -0,0 +1,458 @@
+/*! \brief main_delta_column.hpp
+ * Write-optimized wrapper around a compressed column: new rows are appended to an uncompressed delta buffer and merged into the compressed main in the background.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include <core/compressed_column.hpp>
+#include <core/column.hpp>
+#include <core/epoch_manager.hpp>
+
+namespace CoGaDB {
+
+
+/*!
+ *  \brief     This class represents a column with type T, which is split into a read-optimized compressed main (of type MainColumnType<T>)
+ *  and a small write-optimized, uncompressed delta buffer.
+ *  \details   Inserts append to the delta buffer only. When the buffer reaches the merge threshold, a background thread decodes the
+ *  main and the buffer into one array, encodes it into a new main with one bulk insert and swaps the new main in. While a merge is running, the buffer being merged is frozen and new rows go
+ *  into a fresh buffer, so ingest never waits for the encoder. Row ids are positional over main, frozen buffer and delta buffer (in this order).
+ *  Updates and removes of rows that live in the main or in the frozen buffer wait for a running merge to finish.
+ *  All methods lock the column. The replaced main is retired with epoch based reclamation and deleted, as soon as no thread, which was
+ *  pinned (with an EpochManager::Guard) before the swap, is pinned anymore, so only the merge itself needs memory for two mains. getValue()
+ *  copies the value under the lock, a reference returned by operator[] stays valid across a merge only while the calling thread is pinned.
+ */
+    template<class T, template<typename> class MainColumnType>
+    class MainDeltaColumn : public CompressedColumn<T> {
+    public:
+        typedef shared_pointer_namespace::shared_ptr<MainColumnType<T> > MainColumnPtr;
+        /***************** constructors and destructor *****************/
+        MainDeltaColumn(const std::string &name, AttributeType db_type, size_t merge_threshold = 64 * 1024);
+
+        virtual ~MainDeltaColumn();
+
+        virtual bool insert(const boost::any &new_Value);
+
+        virtual bool insert(const T &new_value);
+
+        template<typename InputIterator>
+        bool insert(InputIterator first, InputIterator last);
+
+        virtual bool update(TID tid, const boost::any &new_value);
+
+        virtual bool update(PositionListPtr tid, const boost::any &new_value);
+
+        virtual bool remove(TID tid);
+
+        //assumes tid list is sorted ascending
+        virtual bool remove(PositionListPtr tid);
+
+        virtual bool clearContent();
+
+        virtual const boost::any get(TID tid);
+
+        /*! \brief returns a copy of the value, which is read under the lock, so a concurrent merge can not delete it*/
+        virtual T getValue(TID tid);
+
+        virtual void print() const throw();
+
+        virtual size_t size() const throw();
+
+        virtual size_t getSizeinBytes() const throw();
+
+        virtual const ColumnPtr copy() const;
+
+        virtual const PositionListPtr selection(const boost::any &value_for_comparison, const ValueComparator comp);
+
+        virtual bool store(const std::string &path);
+
+        virtual bool load(const std::string &path);
+
+        virtual T &operator[](const TID index);
+
+        /*! \brief combines the statistics of the main, which are computed on load and maintained by every merge, with the statistics of the buffers*/
+        virtual const typename ColumnStatistics<T>::ColumnStatisticsPtr getStatistics();
+
+        /*! \brief starts a background merge of the delta buffer into the main, returns immediately*/
+        void startMerge();
+
+        /*! \brief blocks until no merge is running*/
+        void waitForMerge();
+
+        /*! \brief merges the delta buffer into the main and returns when the merge is finished*/
+        void merge();
+
+        /*! \brief number of rows that are not yet part of the compressed main*/
+        size_t getDeltaSize() const;
+
+        void setMergeThreshold(size_t merge_threshold);
+
+    private:
+        /*! \brief entry point of the merge thread, encodes the main and the frozen buffer into a new main and swaps it in*/
+        void mergeFrozenDelta();
+
+        void waitForMerge(std::unique_lock<std::mutex> &lock);
+
+        bool startMerge(std::unique_lock<std::mutex> &lock);
+
+        void merge(std::unique_lock<std::mutex> &lock);
+
+        /*! \brief returns the column storing row tid and translates tid to a row id of that column, the caller has to hold the lock*/
+        ColumnBaseTyped<T> &locate(TID &tid);
+
+        static const typename ColumnStatistics<T>::ColumnStatisticsPtr computeBufferStatistics(const Column<T> &buffer);
+
+        MainColumnPtr main_;
+        /*! \brief statistics of the main, a null pointer, if they have to be computed from the main*/
+        typename ColumnStatistics<T>::ColumnStatisticsPtr main_statistics_;
+        /*! \brief buffer that is merged by the running merge, read only while merge_running_ is set*/
+        Column<T> frozen_delta_;
+        Column<T> delta_;
+        size_t merge_threshold_;
+        bool merge_running_;
+        std::thread merge_thread_;
+        mutable std::mutex mutex_;
+        std::condition_variable merge_finished_;
+    };
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    template<class T, template<typename> class MainColumnType>
+    MainDeltaColumn<T, MainColumnType>::MainDeltaColumn(const std::string &name, AttributeType db_type, size_t merge_threshold)
+            : CompressedColumn<T>(name, db_type),
+              main_(new MainColumnType<T>(name, db_type)), main_statistics_(), frozen_delta_(name, db_type), delta_(name, db_type),
+              merge_threshold_(merge_threshold), merge_running_(false), merge_thread_(), mutex_(), merge_finished_() {
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    MainDeltaColumn<T, MainColumnType>::~MainDeltaColumn() {
+        waitForMerge();
+        if (merge_thread_.joinable()) {
+            merge_thread_.join();
+        }
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::insert(const boost::any &new_value) {
+        if (new_value.empty() || typeid(T) != new_value.type()) {
+            return false;
+        }
+        return insert(boost::any_cast<T>(new_value));
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::insert(const T &new_value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        delta_.insert(new_value);
+        if (delta_.size() >= merge_threshold_) {
+            startMerge(lock);
+        }
+        return true;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    template<typename InputIterator>
+    bool MainDeltaColumn<T, MainColumnType>::insert(InputIterator first, InputIterator last) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        delta_.insert(first, last);
+        if (delta_.size() >= merge_threshold_) {
+            startMerge(lock);
+        }
+        return true;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    ColumnBaseTyped<T> &MainDeltaColumn<T, MainColumnType>::locate(TID &tid) {
+        if (tid < main_->size()) {
+            return *main_;
+        }
+        tid -= main_->size();
+        if (tid < frozen_delta_.size()) {
+            return frozen_delta_;
+        }
+        tid -= frozen_delta_.size();
+        return delta_;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::update(TID tid, const boost::any &new_value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (tid >= main_->size() + frozen_delta_.size() + delta_.size()) {
+            return false;
+        }
+        //rows of the main and the frozen buffer are read by the merge thread
+        if (tid < main_->size() + frozen_delta_.size()) {
+            waitForMerge(lock);
+        }
+        if (tid < main_->size()) {
+            main_statistics_.reset();
+        }
+        ColumnBaseTyped<T> &column = locate(tid);
+        return column.update(tid, new_value);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::update(PositionListPtr tids, const boost::any &new_value) {
+        if (!tids || new_value.empty() || typeid(T) != new_value.type()) {
+            return false;
+        }
+        for (PositionList::iterator it = tids->begin(); it != tids->end(); ++it) {
+            if (!update(*it, new_value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::remove(TID tid) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (tid >= main_->size() + frozen_delta_.size() + delta_.size()) {
+            return false;
+        }
+        if (tid < main_->size() + frozen_delta_.size()) {
+            waitForMerge(lock);
+        }
+        if (tid < main_->size()) {
+            main_statistics_.reset();
+        }
+        ColumnBaseTyped<T> &column = locate(tid);
+        return column.remove(tid);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::remove(PositionListPtr tids) {
+        if (!tids || tids->empty()) {
+            return false;
+        }
+        //delete in reverse order, otherwise the first deletion would invalidate all other tids
+        for (PositionList::reverse_iterator rit = tids->rbegin(); rit != tids->rend(); ++rit) {
+            if (!remove(*rit)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::clearContent() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMerge(lock);
+        main_statistics_.reset();
+        delta_.clearContent();
+        return main_->clearContent();
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    const boost::any MainDeltaColumn<T, MainColumnType>::get(TID tid) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ColumnBaseTyped<T> &column = locate(tid);
+        return column.get(tid);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    T MainDeltaColumn<T, MainColumnType>::getValue(TID tid) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ColumnBaseTyped<T> &column = locate(tid);
+        return column.getValue(tid);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::print() const throw() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::cout << "Main of column " << this->name_ << ":" << std::endl;
+        main_->print();
+        std::cout << "Delta of column " << this->name_ << ":" << std::endl;
+        frozen_delta_.print();
+        delta_.print();
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    size_t MainDeltaColumn<T, MainColumnType>::size() const throw() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return main_->size() + frozen_delta_.size() + delta_.size();
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    size_t MainDeltaColumn<T, MainColumnType>::getSizeinBytes() const throw() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return main_->getSizeinBytes() + frozen_delta_.getSizeinBytes() + delta_.getSizeinBytes();
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    const ColumnPtr MainDeltaColumn<T, MainColumnType>::copy() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        shared_pointer_namespace::shared_ptr<MainDeltaColumn<T, MainColumnType> > column(
+                new MainDeltaColumn<T, MainColumnType>(this->name_, this->db_type_, merge_threshold_));
+        column->main_ = shared_pointer_namespace::static_pointer_cast<MainColumnType<T> >(main_->copy());
+        column->main_statistics_ = main_statistics_;
+        column->delta_.insert(frozen_delta_.getContent().begin(), frozen_delta_.getContent().end());
+        column->delta_.insert(delta_.getContent().begin(), delta_.getContent().end());
+        return column;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    const PositionListPtr MainDeltaColumn<T, MainColumnType>::selection(const boost::any &value_for_comparison, const ValueComparator comp) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        //scan the compressed main with its own selection and append the matches of the buffers with shifted row ids
+        PositionListPtr result_tids = main_->selection(value_for_comparison, comp);
+        TID offset = main_->size();
+        Column<T> *buffers[] = {&frozen_delta_, &delta_};
+        for (unsigned int i = 0; i < 2; ++i) {
+            PositionListPtr buffer_tids = buffers[i]->selection(value_for_comparison, comp);
+            for (PositionList::const_iterator it = buffer_tids->begin(); it != buffer_tids->end(); ++it) {
+                result_tids->push_back(*it + offset);
+            }
+            offset += buffers[i]->size();
+        }
+        return result_tids;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::store(const std::string &path) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        merge(lock);
+        return main_->store(path);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::load(const std::string &path) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMerge(lock);
+        delta_.clearContent();
+        main_statistics_.reset();
+        if (!main_->load(path)) {
+            return false;
+        }
+        main_statistics_ = main_->getStatistics();
+        return true;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    T &MainDeltaColumn<T, MainColumnType>::operator[](const TID index) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        TID tid = index;
+        ColumnBaseTyped<T> &column = locate(tid);
+        return column[tid];
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    const typename ColumnStatistics<T>::ColumnStatisticsPtr MainDeltaColumn<T, MainColumnType>::getStatistics() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!main_statistics_) {
+            //the merge thread reads the main
+            waitForMerge(lock);
+            main_statistics_ = main_->getStatistics();
+        }
+        shared_pointer_namespace::shared_ptr<ColumnStatistics<T> > statistics(new ColumnStatistics<T>(*main_statistics_));
+        statistics->merge(*computeBufferStatistics(frozen_delta_));
+        statistics->merge(*computeBufferStatistics(delta_));
+        return statistics;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    const typename ColumnStatistics<T>::ColumnStatisticsPtr MainDeltaColumn<T, MainColumnType>::computeBufferStatistics(const Column<T> &buffer) {
+        shared_pointer_namespace::shared_ptr<ColumnStatistics<T> > statistics(new ColumnStatistics<T>(buffer.size()));
+        statistics->insert(buffer.getContent().data(), buffer.size());
+        statistics->finish();
+        return statistics;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::startMerge() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        startMerge(lock);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    bool MainDeltaColumn<T, MainColumnType>::startMerge(std::unique_lock<std::mutex> &) {
+        if (merge_running_ || delta_.size() == 0) {
+            return false;
+        }
+        //the previous merge thread already left its critical section, so joining it cannot block on the lock we hold
+        if (merge_thread_.joinable()) {
+            merge_thread_.join();
+        }
+        frozen_delta_.getContent().swap(delta_.getContent());
+        merge_running_ = true;
+        merge_thread_ = std::thread(&MainDeltaColumn<T, MainColumnType>::mergeFrozenDelta, this);
+        return true;
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::mergeFrozenDelta() {
+        //main_ and frozen_delta_ are not modified while merge_running_ is set, so we can encode without holding the lock
+        const Column<T> &frozen_delta = frozen_delta_;
+        //the new main is encoded from scratch instead of copying the old main and appending to the copy
+        const TID main_size = main_->size();
+        std::vector<T> values(main_size + frozen_delta.size());
+        if (main_size > 0) main_->decodeRange(0, main_size, &values[0]);
+        std::copy(frozen_delta.getContent().begin(), frozen_delta.getContent().end(), values.begin() + main_size);
+        MainColumnPtr new_main(new MainColumnType<T>(this->name_, this->db_type_));
+        new_main->insert(values.begin(), values.end());
+        //the statistics of the new main are the statistics of the old main plus the merged rows, so the new main is not scanned
+        shared_pointer_namespace::shared_ptr<ColumnStatistics<T> > statistics;
+        if (main_statistics_) {
+            statistics.reset(new ColumnStatistics<T>(*main_statistics_));
+            statistics->merge(*computeBufferStatistics(frozen_delta));
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        //threads, which are pinned, may still use references into the old main, it is deleted after they left their epoch
+        EpochManager::instance().retire(new MainColumnPtr(main_));
+        main_ = new_main;
+        main_statistics_ = statistics;
+        frozen_delta_.clearContent();
+        merge_running_ = false;
+        merge_finished_.notify_all();
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::waitForMerge() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMerge(lock);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::waitForMerge(std::unique_lock<std::mutex> &lock) {
+        while (merge_running_) {
+            merge_finished_.wait(lock);
+        }
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::merge() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        merge(lock);
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::merge(std::unique_lock<std::mutex> &lock) {
+        waitForMerge(lock);
+        if (startMerge(lock)) {
+            waitForMerge(lock);
+        }
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    size_t MainDeltaColumn<T, MainColumnType>::getDeltaSize() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return frozen_delta_.size() + delta_.size();
+    }
+
+    template<class T, template<typename> class MainColumnType>
+    void MainDeltaColumn<T, MainColumnType>::setMergeThreshold(size_t merge_threshold) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        merge_threshold_ = merge_threshold;
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+}; //end namespace CogaDB
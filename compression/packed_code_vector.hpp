@@ -0,0 +1,185 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <core/copy_on_write.hpp>
+#include <core/global_definitions.hpp>
+#include <core/memory_arena.hpp>
+
+namespace CoGaDB {
+
+/*!
+ *  \brief     A vector of dictionary codes, which stores each code with the smallest byte width (1, 2 or 4 bytes) that can hold the largest code.
+ *  \details   Appending or setting a code that does not fit into the current width widens the whole vector. Shrinking the width
+ *             is done explicitly with repack(), e.g., after a dictionary was compacted.
+ *             Copies share the codes until one of them is modified. Threads may set() disjoint codes concurrently, if no copy shares the
+ *             codes, e.g., after resize().
+ */
+    class PackedCodeVector {
+    public:
+        PackedCodeVector();
+
+        explicit PackedCodeVector(unsigned int width);
+
+        /*! \brief creates an empty vector, which allocates its codes with allocator*/
+        PackedCodeVector(unsigned int width, const ColumnAllocator<unsigned char> &allocator);
+
+        unsigned int get(TID tid) const;
+
+        void set(TID tid, unsigned int code);
+
+        void push_back(unsigned int code);
+
+        void erase(TID tid);
+
+        void clear();
+
+        void resize(size_t size);
+
+        size_t size() const;
+
+        bool empty() const;
+
+        /*! \brief width of a single code in bytes*/
+        unsigned int width() const;
+
+        /*! \brief re-encodes all codes with the given width, the caller has to make sure that every stored code fits*/
+        void repack(unsigned int width);
+
+        /*! \brief returns the smallest width in bytes that can store the code max_code*/
+        static unsigned int widthFor(unsigned int max_code);
+
+        size_t getSizeinBytes() const;
+
+        ColumnAllocator<unsigned char> getAllocator() const;
+
+        template<class Archive>
+        void save(Archive &ar, const unsigned int) const {
+            ar << width_;
+            ar << bytes_.read();
+        }
+
+        template<class Archive>
+        void load(Archive &ar, const unsigned int) {
+            ar >> width_;
+            ar >> bytes_.write();
+        }
+
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    private:
+        unsigned int width_;
+        typedef std::vector<unsigned char, ColumnAllocator<unsigned char> > ByteVector;
+
+        /*! codes, which copies of the vector share until one of them is modified*/
+        CopyOnWrite<ByteVector> bytes_;
+    };
+
+
+/***************** Start of Implementation Section ******************/
+
+
+    inline PackedCodeVector::PackedCodeVector() : width_(1), bytes_() {
+    }
+
+    inline PackedCodeVector::PackedCodeVector(unsigned int width) : width_(width), bytes_() {
+    }
+
+    inline PackedCodeVector::PackedCodeVector(unsigned int width, const ColumnAllocator<unsigned char> &allocator)
+            : width_(width), bytes_(ByteVector(allocator)) {
+    }
+
+    inline unsigned int PackedCodeVector::get(TID tid) const {
+        const unsigned char *position = &bytes_.read()[tid * width_];
+        if (width_ == 1) {
+            return *position;
+        } else if (width_ == 2) {
+            uint16_t code;
+            std::memcpy(&code, position, sizeof(code));
+            return code;
+        }
+        uint32_t code;
+        std::memcpy(&code, position, sizeof(code));
+        return code;
+    }
+
+    inline void PackedCodeVector::set(TID tid, unsigned int code) {
+        if (widthFor(code) > width_) {
+            repack(widthFor(code));
+        }
+        unsigned char *position = &bytes_.write()[tid * width_];
+        if (width_ == 1) {
+            *position = static_cast<unsigned char>(code);
+        } else if (width_ == 2) {
+            uint16_t narrow_code = static_cast<uint16_t>(code);
+            std::memcpy(position, &narrow_code, sizeof(narrow_code));
+        } else {
+            uint32_t wide_code = code;
+            std::memcpy(position, &wide_code, sizeof(wide_code));
+        }
+    }
+
+    inline void PackedCodeVector::push_back(unsigned int code) {
+        bytes_.write().resize(bytes_.read().size() + width_);
+        set(size() - 1, code);
+    }
+
+    inline void PackedCodeVector::erase(TID tid) {
+        ByteVector &bytes = bytes_.write();
+        bytes.erase(bytes.begin() + tid * width_, bytes.begin() + (tid + 1) * width_);
+    }
+
+    inline void PackedCodeVector::clear() {
+        //copies keep the codes they share
+        bytes_ = CopyOnWrite<ByteVector>(ByteVector(bytes_.read().get_allocator()));
+    }
+
+    inline void PackedCodeVector::resize(size_t size) {
+        bytes_.write().resize(size * width_);
+    }
+
+    inline size_t PackedCodeVector::size() const {
+        return bytes_.read().size() / width_;
+    }
+
+    inline bool PackedCodeVector::empty() const {
+        return bytes_.read().empty();
+    }
+
+    inline unsigned int PackedCodeVector::width() const {
+        return width_;
+    }
+
+    inline void PackedCodeVector::repack(unsigned int width) {
+        if (width == width_) return;
+        PackedCodeVector repacked(width, bytes_.read().get_allocator());
+        repacked.resize(size());
+        for (TID i = 0; i < size(); ++i) {
+            repacked.set(i, get(i));
+        }
+        bytes_ = repacked.bytes_;
+        width_ = width;
+    }
+
+    inline unsigned int PackedCodeVector::widthFor(unsigned int max_code) {
+        if (max_code <= 0xFF) return 1;
+        if (max_code <= 0xFFFF) return 2;
+        return 4;
+    }
+
+    inline size_t PackedCodeVector::getSizeinBytes() const {
+        return bytes_.read().capacity();
+    }
+
+    inline ColumnAllocator<unsigned char> PackedCodeVector::getAllocator() const {
+        return bytes_.read().get_allocator();
+    }
+
+/***************** End of Implementation Section ******************/
+
+
+}; //end namespace CogaDB
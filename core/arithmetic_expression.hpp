@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <core/global_definitions.hpp>
+#include <core/column.hpp>
+
+namespace CoGaDB{
+
+/*! \brief number of rows, which an arithmetic expression evaluates at once, the buffers of all nodes of an expression fit into the L1/L2 cache*/
+const size_t expression_chunk_size=1024;
+/*! \brief number of bytes of the vectors, which the kernels of an arithmetic expression compute at once, the SIMD width of SSE2, which every
+ *  x86-64 CPU has*/
+const size_t expression_vector_size=16;
+
+/*!
+ *  \brief     An arithmetic expression over columns and constants with type T, e.g., a*b+c, which computes a new column in a single pass.
+ *  \details   Expressions are evaluated chunk wise: evaluate() computes the values of up to expression_chunk_size consecutive rows at once. A column
+ *  is decoded chunk by chunk with decodeRange(), so compressed columns are never decompressed completely, an uncompressed column is read in
+ *  place. Every operation is a class template, which is instantiated per operator and type, so the loop over a chunk contains no branch and
+ *  no virtual call. The loop computes whole vectors with the vector extension of GCC, so it uses SIMD instructions without relying on
+ *  auto-vectorization, which the build does not enable (it passes no -O flag). Intermediate results stay in chunk buffers, no intermediate
+ *  column is materialized.
+ */
+template<class T>
+class ArithmeticExpression{
+	public:
+	typedef shared_pointer_namespace::shared_ptr<ArithmeticExpression<T> > ArithmeticExpressionPtr;
+
+	virtual ~ArithmeticExpression(){}
+	/*! \brief computes the values of the rows [begin,begin+number_of_values), number_of_values must not exceed expression_chunk_size
+	 *  \return the values, either buffer, which has room for expression_chunk_size values, or storage of a column, or NULL, if the expression
+	 *  is undefined for one of the rows, i.e., an integer division by zero*/
+	virtual const T* evaluate(TID begin, size_t number_of_values, T* buffer) const=0;
+	/*! \brief number of rows of the columns in the expression, an expression without columns has an unlimited number of rows*/
+	virtual size_t size() const=0;
+};
+
+/*! \brief the values of a column*/
+template<class T>
+class ColumnExpression : public ArithmeticExpression<T>{
+	public:
+	typedef shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > ColumnTypedPtr;
+
+	explicit ColumnExpression(ColumnTypedPtr column) : ArithmeticExpression<T>(), column_(column),
+		materialized_column_(shared_pointer_namespace::dynamic_pointer_cast<Column<T> >(column)){}
+
+	virtual const T* evaluate(TID begin, size_t number_of_values, T* buffer) const{
+		if(materialized_column_){
+			return materialized_column_->getContent().data()+begin;
+		}
+		column_->decodeRange(begin,begin+number_of_values,buffer);
+		return buffer;
+	}
+
+	virtual size_t size() const{
+		return column_->size();
+	}
+
+	private:
+	ColumnTypedPtr column_;
+	/*! the column, if it is uncompressed, so it is read without copying*/
+	shared_pointer_namespace::shared_ptr<const Column<T> > materialized_column_;
+};
+
+/*! \brief a constant value, which is the same for all rows*/
+template<class T>
+class ConstantExpression : public ArithmeticExpression<T>{
+	public:
+	explicit ConstantExpression(const T& value) : ArithmeticExpression<T>(), values_(expression_chunk_size,value){}
+
+	virtual const T* evaluate(TID, size_t, T*) const{
+		return &values_[0];
+	}
+
+	virtual size_t size() const{
+		return std::numeric_limits<size_t>::max();
+	}
+
+	private:
+	/*! one chunk of the constant, which is filled once*/
+	std::vector<T> values_;
+};
+
+/*! \brief returns true, if Operator is defined for all pairs of values, the integer division is not defined for a divisor 0 and for the
+ *  smallest value divided by -1, both terminate the program with SIGFPE*/
+template<class T, class Operator>
+struct OperatorDomain{
+	static bool contains(const T*, const T*, size_t){
+		return true;
+	}
+};
+
+template<class T>
+struct OperatorDomain<T,std::divides<> >{
+	static bool contains(const T* left_values, const T* right_values, size_t number_of_values){
+		if(!std::numeric_limits<T>::is_integer) return true;
+		for(size_t i=0;i<number_of_values;i++){
+			if(right_values[i]==T(0)) return false;
+			if(std::numeric_limits<T>::is_signed && right_values[i]==T(-1) && left_values[i]==std::numeric_limits<T>::min()) return false;
+		}
+		return true;
+	}
+};
+
+/*! \brief writes op(left_values[i],right_values[i]) to result[i], expression_vector_size bytes at once, result may be left_values*/
+template<class T, class Operator>
+void applyOperator(const T* left_values, const T* right_values, size_t number_of_values, T* result){
+	typedef T Vector __attribute__((vector_size(expression_vector_size)));
+	const size_t values_per_vector=sizeof(Vector)/sizeof(T);
+	Operator op;
+	size_t i=0;
+	for(;i+values_per_vector<=number_of_values;i+=values_per_vector){
+		//the values of a column need not be aligned to a vector
+		Vector left_vector, right_vector;
+		std::memcpy(&left_vector,left_values+i,sizeof(Vector));
+		std::memcpy(&right_vector,right_values+i,sizeof(Vector));
+		Vector result_vector=op(left_vector,right_vector);
+		std::memcpy(result+i,&result_vector,sizeof(Vector));
+	}
+	for(;i<number_of_values;i++){
+		result[i]=op(left_values[i],right_values[i]);
+	}
+}
+
+/*! \brief applies a binary operator to the values of two expressions, Operator is a transparent function object like std::plus<>, which is
+ *  applied to values and to vectors of values*/
+template<class T, class Operator>
+class BinaryExpression : public ArithmeticExpression<T>{
+	public:
+	typedef typename ArithmeticExpression<T>::ArithmeticExpressionPtr ArithmeticExpressionPtr;
+
+	BinaryExpression(ArithmeticExpressionPtr left, ArithmeticExpressionPtr right) : ArithmeticExpression<T>(), left_(left), right_(right){}
+
+	virtual const T* evaluate(TID begin, size_t number_of_values, T* buffer) const{
+		T right_buffer[expression_chunk_size];
+		//the left child may compute its values in buffer, the kernel then overwrites them in place
+		const T* left_values=left_->evaluate(begin,number_of_values,buffer);
+		if(left_values==NULL) return NULL;
+		const T* right_values=right_->evaluate(begin,number_of_values,right_buffer);
+		if(right_values==NULL) return NULL;
+		if(!OperatorDomain<T,Operator>::contains(left_values,right_values,number_of_values)) return NULL;
+		applyOperator<T,Operator>(left_values,right_values,number_of_values,buffer);
+		return buffer;
+	}
+
+	virtual size_t size() const{
+		return std::min(left_->size(),right_->size());
+	}
+
+	private:
+	ArithmeticExpressionPtr left_;
+	ArithmeticExpressionPtr right_;
+};
+
+/*! \brief evaluates expression for all its rows and stores the results in a new column, the columns in expression are not modified
+ *  \return the new column, or a null pointer, if expression contains no column or an undefined integer division*/
+template<class T>
+const shared_pointer_namespace::shared_ptr<Column<T> > evaluateExpression(const ArithmeticExpression<T>& expression, const std::string& name, AttributeType db_type){
+	size_t number_of_rows=expression.size();
+	if(number_of_rows==std::numeric_limits<size_t>::max()){
+		std::cout << "Fatal Error! Expression for column " << name << " contains no column" << std::endl;
+		return shared_pointer_namespace::shared_ptr<Column<T> >();
+	}
+	shared_pointer_namespace::shared_ptr<Column<T> > result(new Column<T>(name,db_type));
+	typename Column<T>::ValueVector& values=result->getContent();
+	values.resize(number_of_rows);
+	for(TID begin=0;begin<number_of_rows;begin+=expression_chunk_size){
+		size_t chunk_size=std::min(expression_chunk_size,number_of_rows-begin);
+		//the chunk is computed directly in the result column, unless the expression is a bare column
+		T* chunk=&values[begin];
+		const T* chunk_values=expression.evaluate(begin,chunk_size,chunk);
+		if(chunk_values==NULL){
+			std::cout << "Fatal Error! Expression for column " << name << " divides an integer by zero or the smallest integer by -1 in the rows from " << begin << std::endl;
+			return shared_pointer_namespace::shared_ptr<Column<T> >();
+		}
+		if(chunk_values!=chunk) std::copy(chunk_values,chunk_values+chunk_size,chunk);
+	}
+	return result;
+}
+
+/***************** factory functions *****************/
+
+/*! \brief returns the expression, which reads the values of column*/
+template<class T>
+const typename ArithmeticExpression<T>::ArithmeticExpressionPtr makeColumnExpression(shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > column){
+	return typename ArithmeticExpression<T>::ArithmeticExpressionPtr(new ColumnExpression<T>(column));
+}
+
+/*! \brief returns the expression, which has the value value in every row*/
+template<class T>
+const typename ArithmeticExpression<T>::ArithmeticExpressionPtr makeConstantExpression(const T& value){
+	return typename ArithmeticExpression<T>::ArithmeticExpressionPtr(new ConstantExpression<T>(value));
+}
+
+/*! \brief returns the expression left op right for an arithmetic type T, a null pointer for unknown operators or columns with different numbers of rows*/
+template<class T>
+const typename ArithmeticExpression<T>::ArithmeticExpressionPtr makeArithmeticExpression(ArithmeticOperator op,
+	typename ArithmeticExpression<T>::ArithmeticExpressionPtr left, typename ArithmeticExpression<T>::ArithmeticExpressionPtr right){
+	typedef typename ArithmeticExpression<T>::ArithmeticExpressionPtr ArithmeticExpressionPtr;
+	if(!left || !right) return ArithmeticExpressionPtr();
+	if(left->size()!=right->size() && left->size()!=std::numeric_limits<size_t>::max() && right->size()!=std::numeric_limits<size_t>::max()){
+		std::cout << "Fatal Error! Arithmetic expression on columns with " << left->size() << " and " << right->size() << " rows" << std::endl;
+		return ArithmeticExpressionPtr();
+	}
+	if(op==ADDITION){
+		return ArithmeticExpressionPtr(new BinaryExpression<T,std::plus<> >(left,right));
+	}else if(op==SUBTRACTION){
+		return ArithmeticExpressionPtr(new BinaryExpression<T,std::minus<> >(left,right));
+	}else if(op==MULTIPLICATION){
+		return ArithmeticExpressionPtr(new BinaryExpression<T,std::multiplies<> >(left,right));
+	}else if(op==DIVISION){
+		return ArithmeticExpressionPtr(new BinaryExpression<T,std::divides<> >(left,right));
+	}
+	return ArithmeticExpressionPtr();
+}
+
+}; //end namespace CogaDB
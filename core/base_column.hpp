@@ -71,7 +71,7 @@ class ColumnBase{
 	/*! \brief returns the number of values (rows) in a column*/	
 	virtual size_t size() const throw()=0;
 	/*! \brief returns the size in bytes the column consumes in main memory*/	
-	virtual unsigned int getSizeinBytes() const throw()=0;
+	virtual size_t getSizeinBytes() const throw()=0;
 	/*! \brief virtual copy constructor
 	 * \return a ColumnPtr to an exakt copy of the current column*/	
 	virtual const ColumnPtr copy() const=0;
@@ -95,6 +95,9 @@ class ColumnBase{
 	/*! \brief joins two columns using the nested loop join algorithm
 	 * \return PositionListPairPtr to a PositionListPair, which represents the result*/			
 	virtual const PositionListPairPtr nested_loop_join(ColumnPtr join_column)=0;
+	/*! \brief joins two columns with the join algorithm, which suits the sizes, the sortedness and the statistics of both columns
+	 * \return PositionListPairPtr to a PositionListPair, which represents the result*/
+	virtual const PositionListPairPtr join(ColumnPtr join_column)=0;
 	/***************** column algebra operations *****************/	
 	/*! \brief adds constant to column
 	 *  \details for all indeces i holds the following property: B[i]=A[i]+new_Value*/		
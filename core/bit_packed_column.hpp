@@ -0,0 +1,261 @@
+#pragma once
+
+#include <fstream>
+
+#include <core/column_base_typed.hpp>
+#include <core/bitmap.hpp>
+#include <core/decode_buffer.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *
+ *
+ *  \brief     This class represents a BOOLEAN column, which stores one bit per row.
+ *  \details   The rows are stored in a CoGaDB::Bitmap. selectionBitmap() computes the result of a predicate with a few operations per 64 rows,
+ *  so results of several predicates can be combined with Bitmap::operator&= and Bitmap::operator|= before they are converted to a position
+ *  list. operator[] has to return a reference and copies the bit into a DecodeBuffer, changing the returned value does not change the column.
+ */
+class BitPackedColumn : public ColumnBaseTyped<bool>{
+	public:
+	/***************** constructors and destructor *****************/
+	BitPackedColumn(const std::string& name, AttributeType db_type);
+	virtual ~BitPackedColumn();
+
+	virtual bool insert(const boost::any& new_value);
+	bool insert(const bool& new_value);
+	template <typename InputIterator>
+	bool insert(InputIterator first, InputIterator last);
+
+	virtual bool update(TID tid, const boost::any& new_value);
+	virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+	virtual bool remove(TID tid);
+	//assumes tid list is sorted ascending
+	virtual bool remove(PositionListPtr tid);
+	virtual bool clearContent();
+
+	virtual const boost::any get(TID tid);
+	virtual void print() const throw();
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	virtual const ColumnPtr copy() const;
+
+	virtual const PositionListPtr sort(SortOrder order);
+	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+
+	/*! \brief returns a bitmap, in which the bits of the rows fulfilling the predicate are set*/
+	Bitmap selectionBitmap(bool value, const ValueComparator comp) const;
+
+	virtual bool store(const std::string& path);
+	virtual bool load(const std::string& path);
+	virtual bool isMaterialized() const  throw();
+	virtual bool isCompressed() const  throw();
+
+	virtual bool& operator[](const TID index);
+
+	const Bitmap& getContent() const;
+
+	private:
+	Bitmap values_;
+	DecodeBuffer<bool> decode_buffer_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline BitPackedColumn::BitPackedColumn(const std::string& name, AttributeType db_type) : ColumnBaseTyped<bool>(name,db_type), values_(), decode_buffer_(){
+
+	}
+
+	inline BitPackedColumn::~BitPackedColumn(){
+
+	}
+
+	inline bool BitPackedColumn::insert(const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(typeid(bool)==new_value.type()){
+			return insert(boost::any_cast<bool>(new_value));
+		}
+		return false;
+	}
+
+	inline bool BitPackedColumn::insert(const bool& new_value){
+		values_.push_back(new_value);
+		return true;
+	}
+
+	template <typename InputIterator>
+	bool BitPackedColumn::insert(InputIterator first, InputIterator last){
+		for(InputIterator it=first;it!=last;++it){
+			values_.push_back(*it);
+		}
+		return true;
+	}
+
+	inline bool BitPackedColumn::update(TID tid, const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(tid>=values_.size()){
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+			return false;
+		}
+		if(typeid(bool)==new_value.type()){
+			values_.set(tid,boost::any_cast<bool>(new_value));
+			return true;
+		}else{
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+		}
+		return false;
+	}
+
+	inline bool BitPackedColumn::update(PositionListPtr tids, const boost::any& new_value){
+		if(!tids)
+			return false;
+		if(new_value.empty() || typeid(bool)!=new_value.type()) return false;
+		bool value=boost::any_cast<bool>(new_value);
+		for(size_t i=0;i<tids->size();i++){
+			if((*tids)[i]>=values_.size()) return false;
+			values_.set((*tids)[i],value);
+		}
+		return true;
+	}
+
+	inline bool BitPackedColumn::remove(TID tid){
+		if(tid>=values_.size()) return false;
+		values_.erase(tid);
+		return true;
+	}
+
+	inline bool BitPackedColumn::remove(PositionListPtr tids){
+		if(!tids)
+			return false;
+		//test whether tid list has at least one element, if not, return with error
+		if(tids->empty())
+			return false;
+
+		//compact the bits in one pass, every row moves by the number of removed rows before it
+		TID write_position=(*tids)[0];
+		size_t next_removed=0;
+		for(TID tid=(*tids)[0];tid<values_.size();tid++){
+			if(next_removed<tids->size() && (*tids)[next_removed]==tid){
+				++next_removed;
+				continue;
+			}
+			values_.set(write_position++,values_.get(tid));
+		}
+		values_.resize(write_position);
+		return true;
+	}
+
+	inline bool BitPackedColumn::clearContent(){
+		values_.clear();
+		return true;
+	}
+
+	inline const boost::any BitPackedColumn::get(TID tid){
+		if(tid<values_.size())
+			return boost::any(values_.get(tid));
+		else{
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+		}
+		return boost::any();
+	}
+
+	inline void BitPackedColumn::print() const throw(){
+		std::cout << "| " << this->name_ << " |" << std::endl;
+		std::cout << "________________________" << std::endl;
+		for(TID i=0;i<values_.size();i++){
+			std::cout << "| " << values_.get(i) << " |" << std::endl;
+		}
+	}
+
+	inline size_t BitPackedColumn::size() const throw(){
+		return values_.size();
+	}
+
+	inline size_t BitPackedColumn::getSizeinBytes() const throw(){
+		return values_.getSizeinBytes();
+	}
+
+	inline const ColumnPtr BitPackedColumn::copy() const{
+		return ColumnPtr(new BitPackedColumn(*this));
+	}
+
+	inline Bitmap BitPackedColumn::selectionBitmap(bool value, const ValueComparator comp) const{
+		//false < true, so every predicate is either empty, the column or its complement
+		if((comp==EQUAL && value) || (comp==GREATER && !value)){
+			return values_;
+		}else if((comp==EQUAL && !value) || (comp==LESSER && value)){
+			Bitmap result(values_);
+			result.flip();
+			return result;
+		}
+		return Bitmap(values_.size());
+	}
+
+	inline const PositionListPtr BitPackedColumn::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+		if(value_for_comparison.type()!=typeid(bool)){
+			std::cout << "Fatal Error!!! Typemismatch for column " << name_ << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		return selectionBitmap(boost::any_cast<bool>(value_for_comparison),comp).toPositionList();
+	}
+
+	inline const PositionListPtr BitPackedColumn::sort(SortOrder order){
+		if(order!=ASCENDING && order!=DESCENDING){
+			std::cout << "FATAL ERROR: BitPackedColumn::sort(): Unknown Sorting Order!" << std::endl;
+			return PositionListPtr(new PositionList());
+		}
+		//a stable sort of bits lists the rows of one value before the rows of the other, both in ascending order
+		Bitmap first=selectionBitmap(order==DESCENDING,EQUAL);
+		PositionListPtr ids=first.toPositionList();
+		first.flip();
+		PositionListPtr second=first.toPositionList();
+		ids->insert(ids->end(),second->begin(),second->end());
+		return ids;
+	}
+
+	inline bool BitPackedColumn::store(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
+		boost::archive::binary_oarchive oa(outfile);
+		oa << values_;
+		outfile.flush();
+		outfile.close();
+		return true;
+	}
+
+	inline bool BitPackedColumn::load(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		ColumnInputFile infile (path);
+		boost::archive::binary_iarchive ia(infile);
+		ia >> values_;
+		infile.close();
+		return true;
+	}
+
+	inline bool BitPackedColumn::isMaterialized() const  throw(){
+		return true;
+	}
+
+	inline bool BitPackedColumn::isCompressed() const  throw(){
+		return false;
+	}
+
+	inline bool& BitPackedColumn::operator[](const TID index){
+		return decode_buffer_.store(values_.get(index));
+	}
+
+	inline const Bitmap& BitPackedColumn::getContent() const{
+		return values_;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
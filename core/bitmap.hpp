@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <boost/serialization/vector.hpp>
+
+#include <core/base_column.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A sequence of bits, which is stored in 64 bit words. Used as storage of boolean columns and as result of predicates.
+ *  \details   Combining bitmaps with operator&= and operator|= and counting set bits works on whole words. Bits behind size() in the last word
+ *  are always zero, so count() and toPositionList() do not have to mask them.
+ */
+class Bitmap{
+	public:
+	Bitmap();
+	explicit Bitmap(size_t number_of_bits, bool value=false);
+
+	/*! \brief returns a bitmap of number_of_bits bits, in which the bits on the positions in tids are set*/
+	static Bitmap fromPositionList(const PositionList& tids, size_t number_of_bits);
+
+	size_t size() const;
+	bool get(size_t position) const;
+	void set(size_t position, bool value);
+	void push_back(bool value);
+	/*! \brief removes the bit on position, all later bits move one position to the front*/
+	void erase(size_t position);
+	void resize(size_t number_of_bits);
+	void clear();
+
+	Bitmap& operator&=(const Bitmap& bitmap);
+	Bitmap& operator|=(const Bitmap& bitmap);
+	/*! \brief inverts all bits*/
+	void flip();
+
+	/*! \brief number of set bits*/
+	size_t count() const;
+	/*! \brief returns the positions of all set bits in ascending order*/
+	PositionListPtr toPositionList() const;
+
+	const std::vector<uint64_t>& getWords() const;
+	size_t getSizeinBytes() const;
+
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int){
+		ar & size_;
+		ar & words_;
+	}
+
+	private:
+	/*! \brief sets the unused bits of the last word to zero*/
+	void clearPadding();
+
+	std::vector<uint64_t> words_;
+	size_t size_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline Bitmap::Bitmap() : words_(), size_(0){
+
+	}
+
+	inline Bitmap::Bitmap(size_t number_of_bits, bool value) : words_((number_of_bits+63)/64, value ? ~uint64_t(0) : 0), size_(number_of_bits){
+		clearPadding();
+	}
+
+	inline Bitmap Bitmap::fromPositionList(const PositionList& tids, size_t number_of_bits){
+		Bitmap bitmap(number_of_bits);
+		for(size_t i=0;i<tids.size();i++){
+			bitmap.words_[tids[i]/64] |= uint64_t(1) << (tids[i]%64);
+		}
+		return bitmap;
+	}
+
+	inline void Bitmap::clearPadding(){
+		if(size_%64!=0){
+			words_.back() &= (uint64_t(1) << (size_%64))-1;
+		}
+	}
+
+	inline size_t Bitmap::size() const{
+		return size_;
+	}
+
+	inline bool Bitmap::get(size_t position) const{
+		return (words_[position/64] >> (position%64)) & 1;
+	}
+
+	inline void Bitmap::set(size_t position, bool value){
+		uint64_t mask = uint64_t(1) << (position%64);
+		if(value){
+			words_[position/64] |= mask;
+		}else{
+			words_[position/64] &= ~mask;
+		}
+	}
+
+	inline void Bitmap::push_back(bool value){
+		if(size_%64==0) words_.push_back(0);
+		++size_;
+		set(size_-1,value);
+	}
+
+	inline void Bitmap::erase(size_t position){
+		size_t word = position/64;
+		uint64_t low_mask = (uint64_t(1) << (position%64))-1;
+		//keep the bits before position, move the bits after it one to the front
+		words_[word] = (words_[word] & low_mask) | ((words_[word] >> 1) & ~low_mask);
+		for(size_t i=word+1;i<words_.size();i++){
+			words_[i-1] |= words_[i] << 63;
+			words_[i] >>= 1;
+		}
+		--size_;
+		words_.resize((size_+63)/64);
+	}
+
+	inline void Bitmap::resize(size_t number_of_bits){
+		words_.resize((number_of_bits+63)/64,0);
+		size_=number_of_bits;
+		clearPadding();
+	}
+
+	inline void Bitmap::clear(){
+		words_.clear();
+		size_=0;
+	}
+
+	inline Bitmap& Bitmap::operator&=(const Bitmap& bitmap){
+		for(size_t i=0;i<words_.size();i++){
+			words_[i] &= i<bitmap.words_.size() ? bitmap.words_[i] : 0;
+		}
+		return *this;
+	}
+
+	inline Bitmap& Bitmap::operator|=(const Bitmap& bitmap){
+		for(size_t i=0;i<words_.size() && i<bitmap.words_.size();i++){
+			words_[i] |= bitmap.words_[i];
+		}
+		clearPadding();
+		return *this;
+	}
+
+	inline void Bitmap::flip(){
+		for(size_t i=0;i<words_.size();i++){
+			words_[i] = ~words_[i];
+		}
+		clearPadding();
+	}
+
+	inline size_t Bitmap::count() const{
+		size_t number_of_set_bits=0;
+		for(size_t i=0;i<words_.size();i++){
+			number_of_set_bits += __builtin_popcountll(words_[i]);
+		}
+		return number_of_set_bits;
+	}
+
+	inline PositionListPtr Bitmap::toPositionList() const{
+		PositionListPtr tids(new PositionList());
+		tids->reserve(count());
+		for(size_t i=0;i<words_.size();i++){
+			//visit only the set bits of every word
+			for(uint64_t word=words_[i];word!=0;word &= word-1){
+				tids->push_back(TID(i*64+__builtin_ctzll(word)));
+			}
+		}
+		return tids;
+	}
+
+	inline const std::vector<uint64_t>& Bitmap::getWords() const{
+		return words_;
+	}
+
+	inline size_t Bitmap::getSizeinBytes() const{
+		return words_.capacity()*sizeof(uint64_t);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <core/global_definitions.hpp>
+#include <core/parallel.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A register blocked Bloom filter: all bits of a key are in one 64 bit word, so a lookup costs a single cache miss and a few
+ *  register operations.
+ *  \details   The upper 32 bits of the hash value select the word, four 6 bit fields of the lower bits select the bits in the word. With 16 bits
+ *  per key, about 1% of the keys, which were not inserted, pass the filter. containsBatch() tests four keys per AVX2 gather, if the CPU
+ *  supports AVX2, the AVX2 loop is compiled with a target attribute, independent of the flags of the build. The hash join builds a filter on its build side and only probes the hash table with rows, which pass it. The filter can
+ *  also be pushed down into a scan of the probe column with a CoGaDB::BloomFilterPredicate.
+ */
+class BloomFilter{
+	public:
+	/*! \brief creates an empty filter for about number_of_keys keys*/
+	explicit BloomFilter(size_t number_of_keys);
+
+	void insert(uint64_t hash_value);
+	bool contains(uint64_t hash_value) const;
+	/*! \brief writes 1 to result[i], if hash_values[i] may have been inserted, otherwise 0*/
+	void containsBatch(const uint64_t* hash_values, size_t number_of_values, unsigned char* result) const;
+	size_t getSizeinBytes() const;
+
+	/*! \brief hash function of the filter, mixes the bits of boost::hash, which is the identity for integers*/
+	template<class T>
+	static uint64_t hash(const T& value);
+
+	private:
+	static uint64_t getMask(uint64_t hash_value);
+#if defined(__x86_64__)
+	/*! \brief tests four keys per iteration, returns the number of tested keys, the caller tests the rest, requires AVX2*/
+	__attribute__((target("avx2"))) size_t containsBatchAVX2(const uint64_t* hash_values, size_t number_of_values, unsigned char* result) const;
+#endif
+
+	std::vector<uint64_t> words_;
+	uint64_t word_mask_;
+};
+
+typedef shared_pointer_namespace::shared_ptr<BloomFilter> BloomFilterPtr;
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline BloomFilter::BloomFilter(size_t number_of_keys) : words_(), word_mask_(0){
+		//16 bits per key, the number of words is a power of two
+		size_t number_of_words=1;
+		while(number_of_words*64<number_of_keys*16) number_of_words*=2;
+		words_.resize(number_of_words,0);
+		word_mask_=number_of_words-1;
+	}
+
+	template<class T>
+	uint64_t BloomFilter::hash(const T& value){
+		//finalizer of MurmurHash3
+		uint64_t hash_value=boost::hash<T>()(value);
+		hash_value^=hash_value >> 33;
+		hash_value*=0xff51afd7ed558ccdULL;
+		hash_value^=hash_value >> 33;
+		hash_value*=0xc4ceb9fe1a85ec53ULL;
+		hash_value^=hash_value >> 33;
+		return hash_value;
+	}
+
+	inline uint64_t BloomFilter::getMask(uint64_t hash_value){
+		return (uint64_t(1) << (hash_value & 63)) | (uint64_t(1) << ((hash_value >> 6) & 63))
+			| (uint64_t(1) << ((hash_value >> 12) & 63)) | (uint64_t(1) << ((hash_value >> 18) & 63));
+	}
+
+	inline void BloomFilter::insert(uint64_t hash_value){
+		words_[(hash_value >> 32) & word_mask_]|=getMask(hash_value);
+	}
+
+	inline bool BloomFilter::contains(uint64_t hash_value) const{
+		uint64_t mask=getMask(hash_value);
+		return (words_[(hash_value >> 32) & word_mask_] & mask)==mask;
+	}
+
+	inline void BloomFilter::containsBatch(const uint64_t* hash_values, size_t number_of_values, unsigned char* result) const{
+		size_t i=0;
+#if defined(__x86_64__)
+		if(hasAVX2()) i=containsBatchAVX2(hash_values,number_of_values,result);
+#endif
+		for(;i<number_of_values;i++){
+			result[i]=contains(hash_values[i]);
+		}
+	}
+
+#if defined(__x86_64__)
+	__attribute__((target("avx2"))) inline size_t BloomFilter::containsBatchAVX2(const uint64_t* hash_values, size_t number_of_values,
+		unsigned char* result) const{
+		size_t i=0;
+		const __m256i word_mask=_mm256_set1_epi64x(word_mask_);
+		const __m256i bit_mask=_mm256_set1_epi64x(63);
+		const __m256i one=_mm256_set1_epi64x(1);
+		for(;i+4<=number_of_values;i+=4){
+			__m256i hash_vector=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hash_values+i));
+			__m256i word_ids=_mm256_and_si256(_mm256_srli_epi64(hash_vector,32),word_mask);
+			__m256i mask=_mm256_sllv_epi64(one,_mm256_and_si256(hash_vector,bit_mask));
+			mask=_mm256_or_si256(mask,_mm256_sllv_epi64(one,_mm256_and_si256(_mm256_srli_epi64(hash_vector,6),bit_mask)));
+			mask=_mm256_or_si256(mask,_mm256_sllv_epi64(one,_mm256_and_si256(_mm256_srli_epi64(hash_vector,12),bit_mask)));
+			mask=_mm256_or_si256(mask,_mm256_sllv_epi64(one,_mm256_and_si256(_mm256_srli_epi64(hash_vector,18),bit_mask)));
+			__m256i words=_mm256_i64gather_epi64(reinterpret_cast<const long long*>(words_.data()),word_ids,8);
+			__m256i matches=_mm256_cmpeq_epi64(_mm256_and_si256(words,mask),mask);
+			int match_bits=_mm256_movemask_pd(_mm256_castsi256_pd(matches));
+			for(size_t j=0;j<4;j++){
+				result[i+j]=(match_bits >> j) & 1;
+			}
+		}
+		return i;
+	}
+#endif
+
+	inline size_t BloomFilter::getSizeinBytes() const{
+		return words_.capacity()*sizeof(uint64_t);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
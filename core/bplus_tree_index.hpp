@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <core/column_index.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A secondary index for range and equality predicates, which stores its entries in a B+-tree.
+ *  \details   The entries are (value,TID) pairs, which are unique, so duplicate values need no overflow lists and an entry can be removed
+ *  directly. Every node stores its keys in a contiguous array, which covers a few cache lines, so a node is searched with a few cache misses;
+ *  inner nodes keep their child pointers apart from the keys. The leaves are linked, a range lookup descends once and scans the leaves.
+ *  Removing an entry does not merge nodes, underfull leaves are only dropped by clear().
+ */
+template<class T>
+class BPlusTreeIndex : public ColumnIndex<T>{
+	public:
+	typedef typename ColumnIndex<T>::ColumnIndexPtr ColumnIndexPtr;
+
+	/*! \brief number of keys per node, the keys of a node fill about two cache lines*/
+	static const unsigned int node_capacity = (128/sizeof(T)>8) ? 128/sizeof(T) : 8;
+
+	BPlusTreeIndex();
+	virtual ~BPlusTreeIndex();
+
+	virtual IndexType getIndexType() const throw();
+	virtual void insert(const T& value, TID tid);
+	virtual void remove(const T& value, TID tid);
+	virtual void renumber(const PositionList& removed_tids);
+	virtual void clear();
+	virtual void getEntries(std::vector<T>& values, PositionList& tids) const;
+	virtual ColumnIndexPtr clone() const;
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	/*! \brief returns the TIDs of all rows with a value between lower and upper, a null bound is unbounded, sorted ascending*/
+	const PositionListPtr lookup(const T* lower, bool lower_inclusive, const T* upper, bool upper_inclusive) const;
+
+	private:
+	struct Node{
+		Node() : number_of_keys(0), keys(), tids(){}
+		unsigned int number_of_keys;
+		//one more slot than the capacity, so a node can overflow before it is split
+		T keys[node_capacity+1];
+		TID tids[node_capacity+1];
+	};
+	struct InnerNode : public Node{
+		InnerNode() : Node(), children(){}
+		/*! children[i] contains the entries lesser than key i, children[i+1] the entries not lesser than key i*/
+		Node* children[node_capacity+2];
+		private:
+		InnerNode(const InnerNode&);
+		InnerNode& operator=(const InnerNode&);
+	};
+	struct LeafNode : public Node{
+		LeafNode() : Node(), next(NULL){}
+		LeafNode* next;
+		private:
+		LeafNode(const LeafNode&);
+		LeafNode& operator=(const LeafNode&);
+	};
+
+	BPlusTreeIndex(const BPlusTreeIndex&);
+	BPlusTreeIndex& operator=(const BPlusTreeIndex&);
+
+	static bool isLesser(const T& value1, TID tid1, const T& value2, TID tid2);
+	/*! \brief number of keys in node, which are not greater than (value,tid)*/
+	static unsigned int upperBound(const Node* node, const T& value, TID tid);
+	/*! \brief inserts into the subtree of node at height, returns the new right sibling and its first key, if node was split*/
+	Node* insertInto(Node* node, unsigned int height, const T& value, TID tid, T* split_value, TID* split_tid);
+	/*! \brief returns the leaf, which contains the entry (value,tid), if it exists*/
+	LeafNode* findLeaf(const T& value, TID tid) const;
+	LeafNode* getFirstLeaf() const;
+	void renumberNode(Node* node, unsigned int height, const PositionList& removed_tids);
+	void deleteNode(Node* node, unsigned int height);
+
+	Node* root_;
+	/*! number of inner node levels, 0 if the root is a leaf*/
+	unsigned int height_;
+	size_t number_of_entries_;
+	size_t number_of_nodes_;
+};
+
+	template<class T>
+	const unsigned int BPlusTreeIndex<T>::node_capacity;
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	BPlusTreeIndex<T>::BPlusTreeIndex() : ColumnIndex<T>(), root_(new LeafNode()), height_(0), number_of_entries_(0), number_of_nodes_(1){
+
+	}
+
+	template<class T>
+	BPlusTreeIndex<T>::~BPlusTreeIndex(){
+		deleteNode(root_,height_);
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::deleteNode(Node* node, unsigned int height){
+		if(height==0){
+			delete static_cast<LeafNode*>(node);
+			return;
+		}
+		InnerNode* inner_node=static_cast<InnerNode*>(node);
+		for(unsigned int i=0;i<=inner_node->number_of_keys;i++){
+			deleteNode(inner_node->children[i],height-1);
+		}
+		delete inner_node;
+	}
+
+	template<class T>
+	IndexType BPlusTreeIndex<T>::getIndexType() const throw(){
+		return BPLUS_TREE_INDEX;
+	}
+
+	template<class T>
+	bool BPlusTreeIndex<T>::isLesser(const T& value1, TID tid1, const T& value2, TID tid2){
+		return value1<value2 || (!(value2<value1) && tid1<tid2);
+	}
+
+	template<class T>
+	unsigned int BPlusTreeIndex<T>::upperBound(const Node* node, const T& value, TID tid){
+		unsigned int begin=0;
+		unsigned int end=node->number_of_keys;
+		while(begin<end){
+			unsigned int middle=(begin+end)/2;
+			if(isLesser(value,tid,node->keys[middle],node->tids[middle])){
+				end=middle;
+			}else{
+				begin=middle+1;
+			}
+		}
+		return begin;
+	}
+
+	template<class T>
+	typename BPlusTreeIndex<T>::Node* BPlusTreeIndex<T>::insertInto(Node* node, unsigned int height, const T& value, TID tid, T* split_value, TID* split_tid){
+		unsigned int position=upperBound(node,value,tid);
+		if(height==0){
+			for(unsigned int i=node->number_of_keys;i>position;i--){
+				node->keys[i]=node->keys[i-1];
+				node->tids[i]=node->tids[i-1];
+			}
+			node->keys[position]=value;
+			node->tids[position]=tid;
+			if(++node->number_of_keys<=node_capacity) return NULL;
+			//split the leaf, the right half starts with the separator
+			LeafNode* leaf=static_cast<LeafNode*>(node);
+			LeafNode* right=new LeafNode();
+			++number_of_nodes_;
+			unsigned int middle=leaf->number_of_keys/2;
+			for(unsigned int i=middle;i<leaf->number_of_keys;i++){
+				right->keys[i-middle]=leaf->keys[i];
+				right->tids[i-middle]=leaf->tids[i];
+			}
+			right->number_of_keys=leaf->number_of_keys-middle;
+			leaf->number_of_keys=middle;
+			right->next=leaf->next;
+			leaf->next=right;
+			*split_value=right->keys[0];
+			*split_tid=right->tids[0];
+			return right;
+		}
+		InnerNode* inner_node=static_cast<InnerNode*>(node);
+		T child_split_value=T();
+		TID child_split_tid=0;
+		Node* new_child=insertInto(inner_node->children[position],height-1,value,tid,&child_split_value,&child_split_tid);
+		if(!new_child) return NULL;
+		for(unsigned int i=inner_node->number_of_keys;i>position;i--){
+			inner_node->keys[i]=inner_node->keys[i-1];
+			inner_node->tids[i]=inner_node->tids[i-1];
+			inner_node->children[i+1]=inner_node->children[i];
+		}
+		inner_node->keys[position]=child_split_value;
+		inner_node->tids[position]=child_split_tid;
+		inner_node->children[position+1]=new_child;
+		if(++inner_node->number_of_keys<=node_capacity) return NULL;
+		//split the inner node, the middle key moves up to the parent
+		InnerNode* right=new InnerNode();
+		++number_of_nodes_;
+		unsigned int middle=inner_node->number_of_keys/2;
+		for(unsigned int i=middle+1;i<inner_node->number_of_keys;i++){
+			right->keys[i-middle-1]=inner_node->keys[i];
+			right->tids[i-middle-1]=inner_node->tids[i];
+		}
+		for(unsigned int i=middle+1;i<=inner_node->number_of_keys;i++){
+			right->children[i-middle-1]=inner_node->children[i];
+		}
+		right->number_of_keys=inner_node->number_of_keys-middle-1;
+		inner_node->number_of_keys=middle;
+		*split_value=inner_node->keys[middle];
+		*split_tid=inner_node->tids[middle];
+		return right;
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::insert(const T& value, TID tid){
+		T split_value=T();
+		TID split_tid=0;
+		Node* new_node=insertInto(root_,height_,value,tid,&split_value,&split_tid);
+		++number_of_entries_;
+		if(!new_node) return;
+		//the root was split, the tree grows by one level
+		InnerNode* new_root=new InnerNode();
+		++number_of_nodes_;
+		new_root->keys[0]=split_value;
+		new_root->tids[0]=split_tid;
+		new_root->children[0]=root_;
+		new_root->children[1]=new_node;
+		new_root->number_of_keys=1;
+		root_=new_root;
+		++height_;
+	}
+
+	template<class T>
+	typename BPlusTreeIndex<T>::LeafNode* BPlusTreeIndex<T>::findLeaf(const T& value, TID tid) const{
+		Node* node=root_;
+		for(unsigned int height=height_;height>0;height--){
+			node=static_cast<InnerNode*>(node)->children[upperBound(node,value,tid)];
+		}
+		return static_cast<LeafNode*>(node);
+	}
+
+	template<class T>
+	typename BPlusTreeIndex<T>::LeafNode* BPlusTreeIndex<T>::getFirstLeaf() const{
+		Node* node=root_;
+		for(unsigned int height=height_;height>0;height--){
+			node=static_cast<InnerNode*>(node)->children[0];
+		}
+		return static_cast<LeafNode*>(node);
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::remove(const T& value, TID tid){
+		LeafNode* leaf=findLeaf(value,tid);
+		unsigned int position=upperBound(leaf,value,tid);
+		//the entry is the last key, which is not greater than (value,tid)
+		if(position==0 || leaf->tids[position-1]!=tid || leaf->keys[position-1]<value || value<leaf->keys[position-1]) return;
+		for(unsigned int i=position;i<leaf->number_of_keys;i++){
+			leaf->keys[i-1]=leaf->keys[i];
+			leaf->tids[i-1]=leaf->tids[i];
+		}
+		--leaf->number_of_keys;
+		--number_of_entries_;
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::renumberNode(Node* node, unsigned int height, const PositionList& removed_tids){
+		//renumbering keeps the order of the remaining entries, so the tree stays valid
+		for(unsigned int i=0;i<node->number_of_keys;i++){
+			node->tids[i]=ColumnIndex<T>::renumberTID(node->tids[i],removed_tids);
+		}
+		if(height==0) return;
+		InnerNode* inner_node=static_cast<InnerNode*>(node);
+		for(unsigned int i=0;i<=inner_node->number_of_keys;i++){
+			renumberNode(inner_node->children[i],height-1,removed_tids);
+		}
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::renumber(const PositionList& removed_tids){
+		if(removed_tids.empty()) return;
+		renumberNode(root_,height_,removed_tids);
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::clear(){
+		deleteNode(root_,height_);
+		root_=new LeafNode();
+		height_=0;
+		number_of_entries_=0;
+		number_of_nodes_=1;
+	}
+
+	template<class T>
+	void BPlusTreeIndex<T>::getEntries(std::vector<T>& values, PositionList& tids) const{
+		for(LeafNode* leaf=getFirstLeaf();leaf;leaf=leaf->next){
+			values.insert(values.end(),leaf->keys,leaf->keys+leaf->number_of_keys);
+			tids.insert(tids.end(),leaf->tids,leaf->tids+leaf->number_of_keys);
+		}
+	}
+
+	template<class T>
+	typename BPlusTreeIndex<T>::ColumnIndexPtr BPlusTreeIndex<T>::clone() const{
+		shared_pointer_namespace::shared_ptr<BPlusTreeIndex<T> > index(new BPlusTreeIndex<T>());
+		for(LeafNode* leaf=getFirstLeaf();leaf;leaf=leaf->next){
+			for(unsigned int i=0;i<leaf->number_of_keys;i++){
+				index->insert(leaf->keys[i],leaf->tids[i]);
+			}
+		}
+		return index;
+	}
+
+	template<class T>
+	size_t BPlusTreeIndex<T>::size() const throw(){
+		return number_of_entries_;
+	}
+
+	template<class T>
+	size_t BPlusTreeIndex<T>::getSizeinBytes() const throw(){
+		//inner nodes are larger than leaves, so this is an upper bound
+		return number_of_nodes_*sizeof(InnerNode);
+	}
+
+	template<class T>
+	const PositionListPtr BPlusTreeIndex<T>::lookup(const T* lower, bool lower_inclusive, const T* upper, bool upper_inclusive) const{
+		PositionListPtr tids(new PositionList());
+		LeafNode* leaf=getFirstLeaf();
+		unsigned int position=0;
+		if(lower){
+			//(lower,0) precedes all entries of lower, (lower,max TID) follows them
+			TID lower_tid = lower_inclusive ? 0 : std::numeric_limits<TID>::max();
+			leaf=findLeaf(*lower,lower_tid);
+			position=upperBound(leaf,*lower,lower_tid);
+			if(lower_inclusive && position>0 && !(leaf->keys[position-1]<*lower) && leaf->tids[position-1]==0) --position;
+		}
+		for(;leaf;leaf=leaf->next,position=0){
+			for(;position<leaf->number_of_keys;position++){
+				const T& value=leaf->keys[position];
+				if(upper && (*upper<value || (!upper_inclusive && !(value<*upper)))){
+					std::sort(tids->begin(),tids->end());
+					return tids;
+				}
+				tids->push_back(leaf->tids[position]);
+			}
+		}
+		std::sort(tids->begin(),tids->end());
+		return tids;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
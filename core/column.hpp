@@ -1,6 +1,11 @@
 #pragma once
 
 #include <core/column_base_typed.hpp>
+#include <core/copy_on_write.hpp>
+#include <core/gather.hpp>
+#include <core/memory_arena.hpp>
+#include <core/memory_manager.hpp>
+#include <core/parallel.hpp>
 #include <iostream>
 #include <fstream>
 
@@ -9,8 +14,12 @@ namespace CoGaDB{
 template<typename T>
 class Column : public ColumnBaseTyped<T>{
 	public:
+	typedef std::vector<T,ColumnAllocator<T> > ValueVector;
+
 	/***************** constructors and destructor *****************/
 	Column(const std::string& name, AttributeType db_type);
+	/*! \brief creates a column, which stores its values in arena*/
+	Column(const std::string& name, AttributeType db_type, const MemoryArenaPtr& arena);
 	//Column(const Column& column);
 	virtual ~Column();
 
@@ -21,6 +30,7 @@ class Column : public ColumnBaseTyped<T>{
 
 	virtual bool update(TID tid, const boost::any& new_value);
 	virtual bool update(PositionListPtr tid, const boost::any& new_value);	
+	virtual bool update(TID tid, const T& new_value);
 	
 	virtual bool remove(TID tid);
 	//assumes tid list is sorted ascending
@@ -28,11 +38,14 @@ class Column : public ColumnBaseTyped<T>{
 	virtual bool clearContent();
 
 	virtual const boost::any get(TID tid);
+	/*! \brief reads without duplicating values, which a copy shares*/
+	virtual T getValue(TID tid);
 	//virtual const boost::any* const getRawData();
 	virtual void print() const throw();
 	virtual size_t size() const throw();
-	virtual unsigned int getSizeinBytes() const throw();
+	virtual size_t getSizeinBytes() const throw();
 
+	/*! \brief the copy shares the values with this column, until one of them is modified*/
 	virtual const ColumnPtr copy() const;
 
 	virtual bool store(const std::string& path);
@@ -40,11 +53,20 @@ class Column : public ColumnBaseTyped<T>{
 	virtual bool isMaterialized() const  throw();
 	virtual bool isCompressed() const  throw();	
 	
-	virtual T& operator[](const int index);
+	/*! \brief duplicates the values first, if a copy of this column shares them*/
+	virtual T& operator[](const TID index);
+	virtual void gather(const PositionList& tids, T* output);
+	/*! \brief a large column is scanned by as many threads as estimateNumberOfSelectionThreads() returns*/
+	virtual const PositionListPtr predicate_selection(const PredicateExpression<T>& predicate);
+	virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
 
-	std::vector<T>& getContent();
+	/*! \brief duplicates the values first, if a copy of this column shares them, and drops the statistics, because the caller may modify the values*/
+	ValueVector& getContent();
+	const ValueVector& getContent() const;
 
 	protected:
+	/*! \brief scans the values in place instead of decoding them*/
+	virtual const PositionListPtr parallelPredicateSelection(const PredicateExpression<T>& predicate, unsigned int number_of_threads);
 
 		struct Type_TID_Comparator {
   			inline bool operator() (std::pair<T,TID> i, std::pair<T,TID> j) { return (i.first<j.first);}
@@ -52,7 +74,7 @@ class Column : public ColumnBaseTyped<T>{
 
 	
 	/*! values*/
-	std::vector<T> values_;
+	CopyOnWrite<ValueVector> values_;
 };
 
 
@@ -62,9 +84,19 @@ class Column : public ColumnBaseTyped<T>{
 	
 	template<class T>
 	Column<T>::Column(const std::string& name, AttributeType db_type) : ColumnBaseTyped<T>(name,db_type), type_tid_comparator(), values_(){
+		//an empty column is sorted, insert(), update() and remove() call the modification hooks
+		this->is_sorted_=true;
+		this->maintains_indexes_=true;
 
 	}
 
+	template<class T>
+	Column<T>::Column(const std::string& name, AttributeType db_type, const MemoryArenaPtr& arena) : ColumnBaseTyped<T>(name,db_type), type_tid_comparator(),
+		values_(ValueVector(ColumnAllocator<T>(arena))){
+		this->is_sorted_=true;
+		this->maintains_indexes_=true;
+	}
+
 //	template<class T>
 //	Column<T>::Column(const Column& column) : this->db_type_(column->db_type_), this->values_(column->values_){
 //		
@@ -76,8 +108,16 @@ class Column : public ColumnBaseTyped<T>{
 	}
 
 	template<class T>
-	std::vector<T>& Column<T>::getContent(){
-		return values_;
+	typename Column<T>::ValueVector& Column<T>::getContent(){
+		//the caller can change the values, so we no longer know whether they are sorted, attached indexes are not maintained for such changes
+		this->is_sorted_=false;
+		this->statistics_.reset();
+		return values_.write();
+	}
+
+	template<class T>
+	const typename Column<T>::ValueVector& Column<T>::getContent() const{
+		return values_.read();
 	}
 
 
@@ -86,7 +126,8 @@ class Column : public ColumnBaseTyped<T>{
 		if(new_value.empty()) return false;
 		if(typeid(T)==new_value.type()){
 			 T value = boost::any_cast<T>(new_value);
-			 values_.push_back(value);
+			 this->beforeInsert(value);
+			 values_.write().push_back(value);
 			 return true;
 		}
 		return false;
@@ -94,7 +135,8 @@ class Column : public ColumnBaseTyped<T>{
 
 	template<class T>
 	bool Column<T>::insert(const T& new_value){
-		values_.push_back(new_value);
+		this->beforeInsert(new_value);
+		values_.write().push_back(new_value);
 		return true;
 	}
 
@@ -102,7 +144,10 @@ class Column : public ColumnBaseTyped<T>{
 	template <typename T> 
 	template <typename InputIterator>
 	bool Column<T>::insert(InputIterator first, InputIterator last){
-		this->values_.insert(this->values_.end(),first,last);
+		ValueVector& values=values_.write();
+		size_t old_size=values.size();
+		values.insert(values.end(),first,last);
+		this->afterBulkInsert(old_size);
 		return true;
 	}
 
@@ -110,15 +155,20 @@ class Column : public ColumnBaseTyped<T>{
 	bool Column<T>::update(TID tid, const boost::any& new_value){
 		if(new_value.empty()) return false;
 		if(typeid(T)==new_value.type()){
-			 T value = boost::any_cast<T>(new_value);
-			 values_[tid]=value;
-			 return true;
+			 return update(tid,boost::any_cast<T>(new_value));
 		}else{
 			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl; 
 		}
 		return false;
 	}
 
+	template<class T>
+	bool Column<T>::update(TID tid, const T& new_value){
+		this->beforeUpdate(tid,new_value);
+		values_.write()[tid]=new_value;
+		return true;
+	}
+
 	template<class T>
 	bool Column<T>::update(PositionListPtr tids, const boost::any& new_value){
 		if(!tids)
@@ -126,9 +176,11 @@ class Column : public ColumnBaseTyped<T>{
 	if(new_value.empty()) return false;
 		if(typeid(T)==new_value.type()){
 			 T value = boost::any_cast<T>(new_value);
-			 for(unsigned int i=0;i<tids->size();i++){
+			 ValueVector& values=values_.write();
+			 for(size_t i=0;i<tids->size();i++){
 				TID tid=(*tids)[i];
-				values_[tid]=value;
+				this->beforeUpdate(tid,value);
+				values[tid]=value;
 			 }
 			 return true;
 		}else{
@@ -142,7 +194,9 @@ class Column : public ColumnBaseTyped<T>{
 
 	template<class T>
 	bool Column<T>::remove(TID tid){
-		values_.erase(values_.begin()+tid);
+		this->beforeRemove(PositionList(1,tid));
+		ValueVector& values=values_.write();
+		values.erase(values.begin()+tid);
 		return true;
 	}
 	
@@ -156,10 +210,12 @@ class Column : public ColumnBaseTyped<T>{
 
 		//assert();
 
+		this->beforeRemove(*tids);
 		typename PositionList::reverse_iterator rit;
+		ValueVector& values=values_.write();
 
 		for (rit = tids->rbegin(); rit!=tids->rend(); ++rit)
-			values_.erase(values_.begin()+(*rit));
+			values.erase(values.begin()+(*rit));
 
 		/*
 		//delete tuples in reverse order, otherwise the first deletion would invalidate all other tids
@@ -176,31 +232,39 @@ class Column : public ColumnBaseTyped<T>{
 
 	template<class T>
 	bool Column<T>::clearContent(){
-		values_.clear();
+		//free the buffer, so an arena, which only holds the values, unmaps its chunks, copies keep the values they share
+		values_=CopyOnWrite<ValueVector>(ValueVector(values_.read().get_allocator()));
+		this->afterClear();
 		return true;
 	}
 
 	template<class T>
 	const boost::any Column<T>::get(TID tid){
-		if(tid<values_.size())
- 			return boost::any(values_[tid]);
+		if(tid<values_.read().size())
+ 			return boost::any(values_.read()[tid]);
 		else{
 			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
 		}
 		return boost::any();
 	}
 
+	template<class T>
+	T Column<T>::getValue(TID tid){
+		return values_.read()[tid];
+	}
+
 	template<class T>
 	void Column<T>::print() const throw(){
 		std::cout << "| " << this->name_ << " |" << std::endl;
 		std::cout << "________________________" << std::endl;
-		for(unsigned int i=0;i<values_.size();i++){
-			std::cout << "| " << values_[i] << " |" << std::endl;
+		const ValueVector& values=values_.read();
+		for(TID i=0;i<values.size();i++){
+			std::cout << "| " << values[i] << " |" << std::endl;
 		}
 	}
 	template<class T>
 	size_t Column<T>::size() const throw(){
-		return values_.size();
+		return values_.read().size();
 	}
 	template<class T>
 	const ColumnPtr Column<T>::copy() const{
@@ -239,11 +303,11 @@ class Column : public ColumnBaseTyped<T>{
 		std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
 		boost::archive::binary_oarchive oa(outfile);
 
-		oa << values_;
+		oa << values_.read();
 
 		outfile.flush();
 		outfile.close();
-		return true;
+		return this->storeIndexes(path_);
 	}
 	template<class T>
 	bool Column<T>::load(const std::string& path_){
@@ -254,11 +318,11 @@ class Column : public ColumnBaseTyped<T>{
 		path += this->name_;
 		
 		//std::cout << "Opening File '" << path << "'..." << std::endl;
-		std::ifstream infile (path.c_str(),std::ios_base::binary | std::ios_base::in);
+		ColumnInputFile infile (path);
 		boost::archive::binary_iarchive ia(infile);
-		ia >> values_;
+		ia >> values_.write();
 		infile.close();
-
+		this->afterLoad(path_);
 
 		return true;
 	}
@@ -273,24 +337,81 @@ class Column : public ColumnBaseTyped<T>{
 	}
 
 	template<class T>
-	T& Column<T>::operator[](const int index){
-		
-		return values_[index];
+	T& Column<T>::operator[](const TID index){
+		return values_.write()[index];
+	}
+
+	template<class T>
+	void Column<T>::gather(const PositionList& tids, T* output){
+		gatherValues(values_.read().data(),tids.data(),tids.size(),output);
+	}
+
+	template<class T>
+	const PositionListPtr Column<T>::predicate_selection(const PredicateExpression<T>& predicate){
+		PositionListPtr result_tids=this->rangeSelection(predicate);
+		if(result_tids) return result_tids;
+		unsigned int number_of_threads=this->estimateNumberOfSelectionThreads(predicate);
+		if(number_of_threads>1) return parallelPredicateSelection(predicate,number_of_threads);
+		//the values are evaluated in place, no copy into a decode buffer
+		result_tids=PositionListPtr(new PositionList());
+		result_tids->reserve(this->estimateNumberOfMatches(predicate));
+		evaluatePredicate(predicate,values_.read().data(),values_.read().size(),0,*result_tids);
+		return result_tids;
+	}
+
+	template<class T>
+	const PositionListPtr Column<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+		if(value_for_comparison.type()!=typeid(T)){
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		typename PredicateExpression<T>::PredicateExpressionPtr predicate=makeComparison(comp,boost::any_cast<T>(value_for_comparison));
+		if(!predicate) return PositionListPtr(new PositionList());
+		PositionListPtr result_tids=this->rangeSelection(*predicate);
+		if(result_tids) return result_tids;
+		return parallelPredicateSelection(*predicate,number_of_threads);
+	}
+
+	template<class T>
+	const PositionListPtr Column<T>::parallelPredicateSelection(const PredicateExpression<T>& predicate, unsigned int number_of_threads){
+		const ValueVector& values=values_.read();
+		TID number_of_blocks=(values.size()+parallel_selection_block_size-1)/parallel_selection_block_size;
+		std::vector<PositionList> block_tids(number_of_blocks);
+		double selectivity=values.empty() ? 0 : double(this->estimateNumberOfMatches(predicate))/values.size();
+		parallel_for(0,number_of_blocks,[&](TID begin, TID end){
+			for(TID block=begin;block<end;block++){
+				TID block_begin=block*parallel_selection_block_size;
+				TID block_end=std::min(TID(values.size()),block_begin+parallel_selection_block_size);
+				block_tids[block].reserve(selectivity*(block_end-block_begin));
+				evaluatePredicate(predicate,values.data()+block_begin,block_end-block_begin,block_begin,block_tids[block]);
+			}
+		},number_of_threads,1);
+		size_t number_of_matches=0;
+		for(TID block=0;block<number_of_blocks;block++){
+			number_of_matches+=block_tids[block].size();
+		}
+		PositionListPtr result_tids(new PositionList());
+		result_tids->reserve(number_of_matches);
+		for(TID block=0;block<number_of_blocks;block++){
+			result_tids->insert(result_tids->end(),block_tids[block].begin(),block_tids[block].end());
+		}
+		return result_tids;
 	}
 
 	template<class T>
-	unsigned int Column<T>::getSizeinBytes() const throw(){
-			return values_.capacity()*sizeof(T);
+	size_t Column<T>::getSizeinBytes() const throw(){
+			return values_.read().capacity()*sizeof(T)+this->getIndexSizeinBytes();
 	}
 
 	//total template specialization
 	template<>
-	inline unsigned int Column<std::string>::getSizeinBytes() const throw(){
-		unsigned int size_in_bytes=0;
-		for(unsigned int i=0;i<values_.size();++i){
-			size_in_bytes+=values_[i].capacity();
+	inline size_t Column<std::string>::getSizeinBytes() const throw(){
+		const ValueVector& values=values_.read();
+		size_t size_in_bytes=values.capacity()*sizeof(std::string)+this->getIndexSizeinBytes();
+		for(TID i=0;i<values.size();++i){
+			size_in_bytes+=getHeapSizeinBytes(values[i]);
 		}
-		//return values_.size()*sizeof(T);
 		return size_in_bytes;
 	}
 
@@ -2,6 +2,8 @@
 #pragma once
 
 #include <core/base_column.hpp>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 
 #include <utility>
@@ -10,12 +12,29 @@
 
 #include <boost/unordered_map.hpp>
 #include <boost/any.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/core/null_deleter.hpp>
+#include <core/predicate_expression.hpp>
+#include <core/hash_index.hpp>
+#include <core/bplus_tree_index.hpp>
+#include <core/cracker_index.hpp>
+#include <core/column_statistics.hpp>
+#include <core/parallel.hpp>
 
 //#include <core/column.hpp>
 
 /*! \brief The global namespace of the programming tasks, to avoid name claches with other libraries.*/
 namespace CoGaDB{
 
+/*! \brief cost of inserting a row into the hash table and the Bloom filter of a hash join, in value comparisons of a nested loop join*/
+const double hash_join_build_cost=16;
+/*! \brief cost of testing a probe row of a hash join against the Bloom filter*/
+const double hash_join_filter_cost=4;
+/*! \brief cost of looking up a probe row, which passed the Bloom filter, in the hash table*/
+const double hash_join_lookup_cost=8;
+/*! \brief cost per row and recursion level of sorting the rows of a column for a sort-merge join*/
+const double join_sort_cost=3;
+
 /*!
  * 
  * 
@@ -35,12 +54,19 @@ class ColumnBaseTyped : public ColumnBase{
 	//typedef boost::shared_ptr<ColumnBaseTyped> ColumnPtr;
 	/***************** constructors and destructor *****************/
 	ColumnBaseTyped(const std::string& name, AttributeType db_type);
+	/*! \brief copies the attached indexes, so the copy maintains its own indexes*/
+	ColumnBaseTyped(const ColumnBaseTyped& column);
+	ColumnBaseTyped& operator=(const ColumnBaseTyped& column);
 	virtual ~ColumnBaseTyped();
 
 	virtual bool insert(const boost::any& new_Value)=0;
 	virtual bool insert(const T& new_Value)=0;
 	virtual bool update(TID tid, const boost::any& new_value) = 0;
 	virtual bool update(PositionListPtr tid, const boost::any& new_value) = 0;	
+	/*! \brief overwrites the value of row tid without the type check and the any_cast of a boost::any
+	 * \details The default implementation wraps new_value into a boost::any.
+	 * */
+	virtual bool update(TID tid, const T& new_value);
 	
 	virtual bool remove(TID tid)=0;
 	//assumes tid list is sorted ascending
@@ -48,20 +74,59 @@ class ColumnBaseTyped : public ColumnBase{
 	virtual bool clearContent()=0;
 
 	virtual const boost::any get(TID tid)=0;
+	/*! \brief returns the value of row tid by value, without the heap allocation and the type check of a boost::any
+	 * \details The default implementation copies the value operator[] refers to, columns, which decode their values, override it.
+	 * */
+	virtual T getValue(TID tid);
 	//virtual const boost::any* const getRawData()=0;
 	virtual void print() const throw()=0;
 	virtual size_t size() const throw()=0;
-	virtual unsigned int getSizeinBytes() const throw()=0;
+	virtual size_t getSizeinBytes() const throw()=0;
 
 	virtual const ColumnPtr copy() const=0;
 	/***************** relational operations on Columns which return lookup tables *****************/
 	virtual const PositionListPtr sort(SortOrder order); 
 	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+	/*! \brief returns the TIDs of all rows, whose value fulfills predicate, the whole predicate is evaluated in one pass over the column
+	 * \details The default implementation decodes predicate_chunk_size rows at a time with decodeRange() and evaluates the predicate on them.
+	 * */
+	virtual const PositionListPtr predicate_selection(const PredicateExpression<T>& predicate);
+	/*! \brief scans the column with number_of_threads threads, if supportsConcurrentReads() is true, and with the calling thread otherwise
+	 * \details Sorted and indexed columns answer the comparison like selection().
+	 * */
 	virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
 	//join algorithms
+	/*! \brief joins with a hash table on this column, probe rows are tested against a Bloom filter on this column, before they access the hash table*/
 	virtual const PositionListPairPtr hash_join(ColumnPtr join_column);
+	/*! \brief returns a Bloom filter on the values of this column, which can be pushed down as semi join filter into a scan of a join partner
+	 * with makeBloomFilterPredicate()
+	 * */
+	const BloomFilterPtr createBloomFilter();
 	virtual const PositionListPairPtr sort_merge_join(ColumnPtr join_column);
 	virtual const PositionListPairPtr nested_loop_join(ColumnPtr join_column);
+	/*! \brief joins with the algorithm chooseJoinAlgorithm() returns, a hash join builds its hash table on the column, which
+	 * isHashJoinBuildSide() chooses
+	 * \details Two columns, whose statistics estimate an empty join result, e.g., because of disjoint value ranges, are not scanned at all.
+	 * */
+	virtual const PositionListPairPtr join(ColumnPtr join_column);
+	/*! \brief returns the join algorithm with the lowest estimated costs
+	 * \details A nested loop join compares all pairs of rows. A hash join inserts the rows of one column into a hash table and a Bloom filter,
+	 * only probe rows, whose value is in the other column, pass the filter. A sort-merge join sorts the columns, which are not sorted, and
+	 * merges them. The share of probe rows, which pass the filter, is estimated with the numbers of distinct values of the kept statistics,
+	 * columns without statistics are assumed to have unique values.
+	 * */
+	JoinAlgorithm chooseJoinAlgorithm(const ColumnBaseTyped<T>& join_column) const;
+	/*! \brief returns true, if a hash join with join_column has lower estimated costs, when it builds its hash table on this column
+	 * \details The smaller column is the cheaper build side, unless the probe rows of the larger column are mostly filtered out, because the
+	 * smaller column has much more distinct values.
+	 * */
+	bool isHashJoinBuildSide(const ColumnBaseTyped<T>& join_column) const;
+	/*! \brief returns the number of threads for a scan with predicate: one thread per parallel_selection_block_size units of estimated work,
+	 * at most all available threads
+	 * \details Every row and every estimated match is one unit of work, so a scan with many matches uses more threads than a scan of the same
+	 * rows with few matches. Columns without statistics estimate no matches.
+	 * */
+	unsigned int estimateNumberOfSelectionThreads(const PredicateExpression<T>& predicate) const;
 
 
 	virtual bool add(const boost::any& new_Value);
@@ -89,15 +154,138 @@ class ColumnBaseTyped : public ColumnBase{
 	/*! \brief defines operator[] for this class, which enables the user to thread all typed columns as arrays.
 	 * \details Note that this method is pure virtual, so it has to be defined in a derived class. 
 	 * \return a reference to the value at position index
+	 * \details The generic algorithms read with getValue() and only write through operator[], e.g., in the column algebra operations.
 	 * */
-	virtual T& operator[](const int index) = 0;
+	virtual T& operator[](const TID index) = 0;
 	inline bool operator==(ColumnBaseTyped<T>& column);
+	/*! \brief writes the values on the positions in tids to output, which has to have room for tids.size() values
+	 * \details The default implementation uses operator[], columns override it with batched access to their storage.
+	 * */
+	virtual void gather(const PositionList& tids, T* output);
+	/*! \brief writes the values of the rows [begin,end) to output, which has to have room for end-begin values*/
+	virtual void decodeRange(TID begin, TID end, T* output);
+	/*! \brief returns true, if the values are sorted ascending
+	 * \details Sorted columns answer selection() and range predicates with a binary search and sort() without sorting. Only columns, which
+	 * call the modification hooks in insert(), update() and load(), can be sorted. Values changed through the reference returned by operator[]
+	 * are not tracked.
+	 * */
+	bool isSorted() const throw();
+
+	/*! \brief attaches a secondary index, which is built from the current values and maintained by insert(), update() and remove()
+	 * \details A HASH_INDEX answers equality predicates, a BPLUS_TREE_INDEX equality and range predicates. A CRACKER_INDEX answers equality and
+	 * range predicates like a BPLUS_TREE_INDEX, but is only sorted as far as the predicates it answered require. selection() and range predicates use
+	 * an attached index automatically. Like sortedness, indexes are only maintained by columns, which call the modification hooks.
+	 * \return false, if the column does not maintain indexes
+	 * */
+	bool createIndex(IndexType index_type);
+	bool dropIndex(IndexType index_type);
+	bool hasIndex(IndexType index_type) const;
+	/*! \brief answers a comparison with an attached index (INDEX_SCAN)
+	 * \return the TIDs sorted ascending, or a null pointer, if no attached index supports the comparison
+	 * */
+	const PositionListPtr index_scan(const boost::any& value_for_comparison, const ValueComparator comp);
+	/*! \brief returns statistics on the values, e.g., to estimate result sizes
+	 * \details Columns, which call the modification hooks, compute them on load and keep them until the next modification, other columns
+	 * compute them on every call.
+	 * */
+	virtual const typename ColumnStatistics<T>::ColumnStatisticsPtr getStatistics();
+
+	protected:
+	/*! \brief modification hook, which a column calls before it appends new_value, maintains the sortedness and the indexes*/
+	void beforeInsert(const T& new_value);
+	/*! \brief modification hook, which a column calls after it appended the rows [old_size,size()) at once*/
+	void afterBulkInsert(size_t old_size);
+	/*! \brief modification hook, which a column calls before it overwrites the value of row tid with new_value*/
+	void beforeUpdate(TID tid, const T& new_value);
+	/*! \brief modification hook, which a column calls before it removes the rows tids, which are sorted ascending*/
+	void beforeRemove(const PositionList& tids);
+	/*! \brief modification hook, which a column calls after it removed all rows*/
+	void afterClear();
+	/*! \brief modification hook, which a column calls after it loaded its values from path, attaches the indexes stored in path and
+	 *  rebuilds attached indexes, which are not stored*/
+	void afterLoad(const std::string& path);
+	/*! \brief stores the attached indexes next to the column in path and deletes stored indexes, which are no longer attached*/
+	bool storeIndexes(const std::string& path);
+	/*! \brief rebuilds the attached indexes, e.g., after an arithmetic operation changed all values*/
+	void rebuildIndexes();
+	/*! \brief memory of the attached indexes, which is part of the footprint of the column*/
+	size_t getIndexSizeinBytes() const throw();
+	/*! \brief checks all values, e.g., after a bulk load*/
+	void computeSortedness();
+	/*! \brief returns true, if value may follow previous in a sorted column, which is false, if one of them is NaN, because NaN is not
+	 *  ordered, so binary searches would skip it*/
+	static bool isInOrder(const T& previous, const T& value);
+	/*! \brief first row, whose value is not lesser than value, requires sorted values*/
+	TID lowerBound(const T& value);
+	/*! \brief first row, whose value is greater than value, requires sorted values*/
+	TID upperBound(const T& value);
+	/*! \brief returns true, if several threads may call decodeRange() at the same time
+	 * \details The default implementation reads with getValue(), which returns a reference into a buffer shared by all readers in most
+	 * compressed columns, and other columns continue the decoding of the previous call, so columns have to opt in.
+	 * */
+	virtual bool supportsConcurrentReads() const;
+	/*! \brief scans blocks of parallel_selection_block_size rows concurrently and concatenates their matches in the order of the rows,
+	 *  requires supportsConcurrentReads()*/
+	virtual const PositionListPtr parallelPredicateSelection(const PredicateExpression<T>& predicate, unsigned int number_of_threads);
+	/*! \brief returns the rows of a range predicate with a binary search or an index, or a null pointer, if neither is possible*/
+	const PositionListPtr rangeSelection(const PredicateExpression<T>& predicate);
+	/*! \brief returns the attached index of type index_type, or a null pointer*/
+	const typename ColumnIndex<T>::ColumnIndexPtr getIndex(IndexType index_type) const;
+	/*! \brief replaces the index of type index_type with an empty one and returns it*/
+	const typename ColumnIndex<T>::ColumnIndexPtr attachEmptyIndex(IndexType index_type);
+	/*! \brief returns the position list begin,...,end-1*/
+	static const PositionListPtr createTIDRange(TID begin, TID end);
+	/*! \brief computes statistics on the current values in one pass with decodeRange()*/
+	const typename ColumnStatistics<T>::ColumnStatisticsPtr computeStatistics();
+	/*! \brief estimates the number of rows, which fulfill predicate, with the kept statistics, or returns 0, if the column keeps none*/
+	size_t estimateNumberOfMatches(const PredicateExpression<T>& predicate) const;
+	/*! \brief returns the number of distinct values of the kept statistics, or the number of rows, if the column keeps none*/
+	size_t estimateNumberOfDistinctValues() const;
+	/*! \brief estimated costs of a hash join, which builds its hash table on build_column and probes it with probe_column*/
+	static double estimateHashJoinCosts(const ColumnBaseTyped<T>& build_column, const ColumnBaseTyped<T>& probe_column);
+	/*! \brief estimated costs of the sort and the merge of the rows of this column in a sort-merge join*/
+	double estimateSortMergeCosts() const;
+
+	/*! true, if the values are sorted ascending*/
+	bool is_sorted_;
+	/*! true, if the column calls the modification hooks, so it can maintain indexes*/
+	bool maintains_indexes_;
+	shared_pointer_namespace::shared_ptr<HashIndex<T> > hash_index_;
+	shared_pointer_namespace::shared_ptr<BPlusTreeIndex<T> > bplus_tree_index_;
+	shared_pointer_namespace::shared_ptr<CrackerIndex<T> > cracker_index_;
+	/*! statistics on the values, only kept by columns, which call the modification hooks*/
+	typename ColumnStatistics<T>::ColumnStatisticsPtr statistics_;
 };
 
 //constructors just call super(...)
 	template<class T>
-	ColumnBaseTyped<T>::ColumnBaseTyped(const std::string& name, AttributeType db_type) : ColumnBase(name,db_type){
+	ColumnBaseTyped<T>::ColumnBaseTyped(const std::string& name, AttributeType db_type) : ColumnBase(name,db_type), is_sorted_(false),
+		maintains_indexes_(false), hash_index_(), bplus_tree_index_(), cracker_index_(), statistics_(){
+
+	}
+
+	template<class T>
+	ColumnBaseTyped<T>::ColumnBaseTyped(const ColumnBaseTyped& column) : ColumnBase(column), is_sorted_(column.is_sorted_),
+		maintains_indexes_(column.maintains_indexes_), hash_index_(), bplus_tree_index_(), cracker_index_(), statistics_(column.statistics_){
+		if(column.hash_index_) hash_index_=shared_pointer_namespace::static_pointer_cast<HashIndex<T> >(column.hash_index_->clone());
+		if(column.bplus_tree_index_) bplus_tree_index_=shared_pointer_namespace::static_pointer_cast<BPlusTreeIndex<T> >(column.bplus_tree_index_->clone());
+		if(column.cracker_index_) cracker_index_=shared_pointer_namespace::static_pointer_cast<CrackerIndex<T> >(column.cracker_index_->clone());
+	}
 
+	template<class T>
+	ColumnBaseTyped<T>& ColumnBaseTyped<T>::operator=(const ColumnBaseTyped& column){
+		if(this==&column) return *this;
+		ColumnBase::operator=(column);
+		is_sorted_=column.is_sorted_;
+		maintains_indexes_=column.maintains_indexes_;
+		statistics_=column.statistics_;
+		hash_index_.reset();
+		bplus_tree_index_.reset();
+		cracker_index_.reset();
+		if(column.hash_index_) hash_index_=shared_pointer_namespace::static_pointer_cast<HashIndex<T> >(column.hash_index_->clone());
+		if(column.bplus_tree_index_) bplus_tree_index_=shared_pointer_namespace::static_pointer_cast<BPlusTreeIndex<T> >(column.bplus_tree_index_->clone());
+		if(column.cracker_index_) cracker_index_=shared_pointer_namespace::static_pointer_cast<CrackerIndex<T> >(column.cracker_index_->clone());
+		return *this;
 	}
 
 	template<class T>
@@ -110,14 +298,357 @@ const std::type_info& ColumnBaseTyped<T>::type() const throw(){
 	return typeid(T);
 }
 
+template<class T>
+T ColumnBaseTyped<T>::getValue(TID tid){
+	return (*this)[tid];
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::update(TID tid, const T& new_value){
+	return update(tid,boost::any(new_value));
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::isSorted() const throw(){
+	return is_sorted_;
+}
+
+template<class T>
+void ColumnBaseTyped<T>::beforeInsert(const T& new_value){
+	if(is_sorted_ && !isInOrder(this->size()>0 ? this->getValue(this->size()-1) : new_value,new_value)){
+		is_sorted_=false;
+	}
+	statistics_.reset();
+	if(hash_index_) hash_index_->insert(new_value,this->size());
+	if(bplus_tree_index_) bplus_tree_index_->insert(new_value,this->size());
+	if(cracker_index_) cracker_index_->insert(new_value,this->size());
+}
+
+template<class T>
+void ColumnBaseTyped<T>::afterBulkInsert(size_t old_size){
+	statistics_.reset();
+	for(TID i=old_size;i<this->size() && is_sorted_;i++){
+		T value=this->getValue(i);
+		if(!isInOrder(i>0 ? this->getValue(i-1) : value,value)) is_sorted_=false;
+	}
+	if(!hash_index_ && !bplus_tree_index_ && !cracker_index_) return;
+	for(TID i=old_size;i<this->size();i++){
+		T value=this->getValue(i);
+		if(hash_index_) hash_index_->insert(value,i);
+		if(bplus_tree_index_) bplus_tree_index_->insert(value,i);
+		if(cracker_index_) cracker_index_->insert(value,i);
+	}
+}
+
+template<class T>
+void ColumnBaseTyped<T>::beforeUpdate(TID tid, const T& new_value){
+	if(is_sorted_ && (!isInOrder(tid>0 ? this->getValue(tid-1) : new_value,new_value) || (tid+1<this->size() && !isInOrder(new_value,this->getValue(tid+1))))){
+		is_sorted_=false;
+	}
+	statistics_.reset();
+	if(!hash_index_ && !bplus_tree_index_ && !cracker_index_) return;
+	T old_value=this->getValue(tid);
+	if(hash_index_){
+		hash_index_->remove(old_value,tid);
+		hash_index_->insert(new_value,tid);
+	}
+	if(bplus_tree_index_){
+		bplus_tree_index_->remove(old_value,tid);
+		bplus_tree_index_->insert(new_value,tid);
+	}
+	if(cracker_index_){
+		cracker_index_->remove(old_value,tid);
+		cracker_index_->insert(new_value,tid);
+	}
+}
+
+template<class T>
+void ColumnBaseTyped<T>::beforeRemove(const PositionList& tids){
+	//removing rows keeps the order of the remaining rows, so only the indexes and the statistics change
+	statistics_.reset();
+	if(!hash_index_ && !bplus_tree_index_ && !cracker_index_) return;
+	std::vector<T> values(tids.size());
+	for(size_t i=0;i<tids.size();i++){
+		values[i]=this->getValue(tids[i]);
+	}
+	if(hash_index_) hash_index_->removeRows(values,tids);
+	if(bplus_tree_index_) bplus_tree_index_->removeRows(values,tids);
+	if(cracker_index_) cracker_index_->removeRows(values,tids);
+}
+
+template<class T>
+void ColumnBaseTyped<T>::afterClear(){
+	is_sorted_=true;
+	statistics_.reset();
+	if(hash_index_) hash_index_->clear();
+	if(bplus_tree_index_) bplus_tree_index_->clear();
+	if(cracker_index_) cracker_index_->clear();
+}
+
+template<class T>
+void ColumnBaseTyped<T>::afterLoad(const std::string& path){
+	computeSortedness();
+	statistics_=computeStatistics();
+	if(!maintains_indexes_) return;
+	const IndexType index_types[]={HASH_INDEX,BPLUS_TREE_INDEX,CRACKER_INDEX};
+	for(size_t i=0;i<sizeof(index_types)/sizeof(index_types[0]);i++){
+		const std::string file_name=ColumnIndex<T>::getFileName(path,this->name_,index_types[i]);
+		bool is_stored=std::ifstream(file_name.c_str()).good();
+		if(!is_stored && !hasIndex(index_types[i])) continue;
+		//a stored index has to contain one entry per row, otherwise it belongs to other values and is rebuilt
+		typename ColumnIndex<T>::ColumnIndexPtr index=attachEmptyIndex(index_types[i]);
+		if(!is_stored || !index->load(file_name) || index->size()!=this->size()){
+			dropIndex(index_types[i]);
+			createIndex(index_types[i]);
+		}
+	}
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::storeIndexes(const std::string& path){
+	const IndexType index_types[]={HASH_INDEX,BPLUS_TREE_INDEX,CRACKER_INDEX};
+	for(size_t i=0;i<sizeof(index_types)/sizeof(index_types[0]);i++){
+		const std::string file_name=ColumnIndex<T>::getFileName(path,this->name_,index_types[i]);
+		typename ColumnIndex<T>::ColumnIndexPtr index=getIndex(index_types[i]);
+		if(index){
+			if(!index->store(file_name)) return false;
+		}else{
+			//otherwise load() would attach the index of older values again
+			std::remove(file_name.c_str());
+		}
+	}
+	return true;
+}
+
+template<class T>
+size_t ColumnBaseTyped<T>::getIndexSizeinBytes() const throw(){
+	size_t size_in_bytes=0;
+	if(hash_index_) size_in_bytes+=hash_index_->getSizeinBytes();
+	if(bplus_tree_index_) size_in_bytes+=bplus_tree_index_->getSizeinBytes();
+	if(cracker_index_) size_in_bytes+=cracker_index_->getSizeinBytes();
+	return size_in_bytes;
+}
+
+template<class T>
+void ColumnBaseTyped<T>::rebuildIndexes(){
+	statistics_.reset();
+	if(hash_index_){
+		hash_index_.reset();
+		createIndex(HASH_INDEX);
+	}
+	if(bplus_tree_index_){
+		bplus_tree_index_.reset();
+		createIndex(BPLUS_TREE_INDEX);
+	}
+	if(cracker_index_){
+		cracker_index_.reset();
+		createIndex(CRACKER_INDEX);
+	}
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::createIndex(IndexType index_type){
+	if(!maintains_indexes_){
+		std::cout << "Fatal Error! Column " << this->name_ << " does not maintain indexes" << std::endl;
+		return false;
+	}
+	if(hasIndex(index_type)) return true;
+	typename ColumnIndex<T>::ColumnIndexPtr index=attachEmptyIndex(index_type);
+	for(TID i=0;i<this->size();i++){
+		index->insert(this->getValue(i),i);
+	}
+	return true;
+}
+
+template<class T>
+const typename ColumnIndex<T>::ColumnIndexPtr ColumnBaseTyped<T>::attachEmptyIndex(IndexType index_type){
+	if(index_type==HASH_INDEX){
+		hash_index_=shared_pointer_namespace::shared_ptr<HashIndex<T> >(new HashIndex<T>());
+		return hash_index_;
+	}else if(index_type==BPLUS_TREE_INDEX){
+		bplus_tree_index_=shared_pointer_namespace::shared_ptr<BPlusTreeIndex<T> >(new BPlusTreeIndex<T>());
+		return bplus_tree_index_;
+	}
+	cracker_index_=shared_pointer_namespace::shared_ptr<CrackerIndex<T> >(new CrackerIndex<T>());
+	return cracker_index_;
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::dropIndex(IndexType index_type){
+	if(!hasIndex(index_type)) return false;
+	if(index_type==HASH_INDEX){
+		hash_index_.reset();
+	}else if(index_type==BPLUS_TREE_INDEX){
+		bplus_tree_index_.reset();
+	}else{
+		cracker_index_.reset();
+	}
+	return true;
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::hasIndex(IndexType index_type) const{
+	return getIndex(index_type).get()!=NULL;
+}
+
+template<class T>
+const typename ColumnIndex<T>::ColumnIndexPtr ColumnBaseTyped<T>::getIndex(IndexType index_type) const{
+	if(index_type==HASH_INDEX) return hash_index_;
+	if(index_type==BPLUS_TREE_INDEX) return bplus_tree_index_;
+	return cracker_index_;
+}
+
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::index_scan(const boost::any& value_for_comparison, const ValueComparator comp){
+	if(value_for_comparison.type()!=typeid(T)) return PositionListPtr();
+	T value = boost::any_cast<T>(value_for_comparison);
+	if(comp==EQUAL && hash_index_){
+		return hash_index_->lookup(value);
+	}
+	if(bplus_tree_index_){
+		if(comp==EQUAL){
+			return bplus_tree_index_->lookup(&value,true,&value,true);
+		}else if(comp==LESSER){
+			return bplus_tree_index_->lookup(NULL,false,&value,false);
+		}else if(comp==GREATER){
+			return bplus_tree_index_->lookup(&value,false,NULL,false);
+		}
+	}
+	if(cracker_index_){
+		if(comp==EQUAL){
+			return cracker_index_->lookup(&value,true,&value,true);
+		}else if(comp==LESSER){
+			return cracker_index_->lookup(NULL,false,&value,false);
+		}else if(comp==GREATER){
+			return cracker_index_->lookup(&value,false,NULL,false);
+		}
+	}
+	return PositionListPtr();
+}
+
+template<class T>
+void ColumnBaseTyped<T>::computeSortedness(){
+	is_sorted_=true;
+	for(TID i=0;i<this->size() && is_sorted_;i++){
+		T value=this->getValue(i);
+		if(!isInOrder(i>0 ? this->getValue(i-1) : value,value)) is_sorted_=false;
+	}
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::isInOrder(const T& previous, const T& value){
+	return previous<=value;
+}
+
+template<class T>
+TID ColumnBaseTyped<T>::lowerBound(const T& value){
+	TID begin=0;
+	TID end=this->size();
+	while(begin<end){
+		TID middle=begin+(end-begin)/2;
+		if(this->getValue(middle)<value){
+			begin=middle+1;
+		}else{
+			end=middle;
+		}
+	}
+	return begin;
+}
+
+template<class T>
+TID ColumnBaseTyped<T>::upperBound(const T& value){
+	TID begin=0;
+	TID end=this->size();
+	while(begin<end){
+		TID middle=begin+(end-begin)/2;
+		if(value<this->getValue(middle)){
+			end=middle;
+		}else{
+			begin=middle+1;
+		}
+	}
+	return begin;
+}
+
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::createTIDRange(TID begin, TID end){
+	PositionListPtr tids(new PositionList());
+	if(begin>=end) return tids;
+	tids->reserve(end-begin);
+	for(TID i=begin;i<end;i++){
+		tids->push_back(i);
+	}
+	return tids;
+}
+
+template<class T>
+const typename ColumnStatistics<T>::ColumnStatisticsPtr ColumnBaseTyped<T>::getStatistics(){
+	if(statistics_) return statistics_;
+	typename ColumnStatistics<T>::ColumnStatisticsPtr statistics=computeStatistics();
+	//other columns change their values without calling the hooks, so their statistics could not be invalidated
+	if(maintains_indexes_) statistics_=statistics;
+	return statistics;
+}
+
+template<class T>
+const typename ColumnStatistics<T>::ColumnStatisticsPtr ColumnBaseTyped<T>::computeStatistics(){
+	shared_pointer_namespace::shared_ptr<ColumnStatistics<T> > statistics(new ColumnStatistics<T>(this->size()));
+	boost::scoped_array<T> values(new T[predicate_chunk_size]);
+	for(TID begin=0;begin<this->size();begin+=predicate_chunk_size){
+		TID end=std::min(TID(this->size()),TID(begin+predicate_chunk_size));
+		decodeRange(begin,end,values.get());
+		statistics->insert(values.get(),end-begin);
+	}
+	statistics->finish();
+	return statistics;
+}
+
+template<class T>
+size_t ColumnBaseTyped<T>::estimateNumberOfMatches(const PredicateExpression<T>& predicate) const{
+	if(!statistics_) return 0;
+	return size_t(statistics_->estimateSelectivity(predicate)*this->size());
+}
+
+template<class T>
+size_t ColumnBaseTyped<T>::estimateNumberOfDistinctValues() const{
+	if(!statistics_) return this->size();
+	return statistics_->getNumberOfDistinctValues();
+}
+
+template<class T>
+unsigned int ColumnBaseTyped<T>::estimateNumberOfSelectionThreads(const PredicateExpression<T>& predicate) const{
+	size_t work=this->size()+estimateNumberOfMatches(predicate);
+	size_t number_of_threads=std::max<size_t>(1,work/parallel_selection_block_size);
+	return unsigned(std::min<size_t>(number_of_threads,getNumberOfAvailableThreads()));
+}
+
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::rangeSelection(const PredicateExpression<T>& predicate){
+	T lower=T();
+	T upper=T();
+	if(!predicate.getRange(&lower,&upper)) return PositionListPtr();
+	//an empty range or a NaN bound matches no row
+	if(!(lower<=upper)) return createTIDRange(0,0);
+	if(is_sorted_) return createTIDRange(lowerBound(lower),upperBound(upper));
+	if(bplus_tree_index_) return bplus_tree_index_->lookup(&lower,true,&upper,true);
+	if(cracker_index_) return cracker_index_->lookup(&lower,true,&upper,true);
+	return PositionListPtr();
+}
+
 template<class T>
 const PositionListPtr ColumnBaseTyped<T>::sort(SortOrder order){
+	if(is_sorted_ && (order==ASCENDING || order==DESCENDING)){
+		//the rows are already in order, ties are ordered by TID like the sorted (value,TID) pairs below
+		PositionListPtr ids=createTIDRange(0,this->size());
+		if(order==DESCENDING) std::reverse(ids->begin(),ids->end());
+		return ids;
+	}
 
 	PositionListPtr ids = PositionListPtr( new PositionList());
 		std::vector<std::pair<T,TID> > v;
 
-		for(unsigned int i=0;i<this->size();i++){
-			v.push_back (std::pair<T,TID>((*this)[i],i) );
+		for(TID i=0;i<this->size();i++){
+			v.push_back (std::pair<T,TID>(this->getValue(i),i) );
 		}
 
 		//TODO: change implementation, so that no copy operations are required -> use boost zip iterators!
@@ -132,7 +663,7 @@ const PositionListPtr ColumnBaseTyped<T>::sort(SortOrder order){
 			std::cout << "FATAL ERROR: ColumnBaseTyped<T>::sort(): Unknown Sorting Order!" << std::endl;
 		}
 
-		for(unsigned int i=0;i<v.size();i++){
+		for(size_t i=0;i<v.size();i++){
 			ids->push_back(v[i].second);
 		}
 
@@ -141,11 +672,82 @@ const PositionListPtr ColumnBaseTyped<T>::sort(SortOrder order){
 
 
 template<class T>
-const PositionListPtr ColumnBaseTyped<T>::parallel_selection(const boost::any&, const ValueComparator, unsigned int){
+void ColumnBaseTyped<T>::gather(const PositionList& tids, T* output){
+	for(size_t i=0;i<tids.size();i++){
+		output[i]=this->getValue(tids[i]);
+	}
+}
 
-		PositionListPtr result_tids( new PositionList());
+template<class T>
+void ColumnBaseTyped<T>::decodeRange(TID begin, TID end, T* output){
+	for(TID i=begin;i<end;i++){
+		output[i-begin]=this->getValue(i);
+	}
+}
 
-		return result_tids;
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::predicate_selection(const PredicateExpression<T>& predicate){
+	PositionListPtr result_tids=rangeSelection(predicate);
+	if(result_tids) return result_tids;
+	result_tids=PositionListPtr(new PositionList());
+	result_tids->reserve(estimateNumberOfMatches(predicate));
+	//no std::vector, std::vector<bool> has no contiguous storage
+	boost::scoped_array<T> values(new T[predicate_chunk_size]);
+	for(TID begin=0;begin<this->size();begin+=predicate_chunk_size){
+		TID end=std::min(TID(this->size()),TID(begin+predicate_chunk_size));
+		decodeRange(begin,end,values.get());
+		evaluatePredicate(predicate,values.get(),end-begin,begin,*result_tids);
+	}
+	return result_tids;
+}
+
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+	if(number_of_threads<=1 || is_sorted_ || !supportsConcurrentReads()) return this->selection(value_for_comparison,comp);
+	if(value_for_comparison.type()!=typeid(T)){
+		std::cout << "Fatal Error!!! Typemismatch for column " << name_ << std::endl;
+		std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+		exit(-1);
+	}
+	PositionListPtr result_tids=index_scan(value_for_comparison,comp);
+	if(result_tids) return result_tids;
+	typename PredicateExpression<T>::PredicateExpressionPtr predicate=makeComparison(comp,boost::any_cast<T>(value_for_comparison));
+	if(!predicate) return PositionListPtr(new PositionList());
+	return parallelPredicateSelection(*predicate,number_of_threads);
+}
+
+template<class T>
+bool ColumnBaseTyped<T>::supportsConcurrentReads() const{
+	return false;
+}
+
+template<class T>
+const PositionListPtr ColumnBaseTyped<T>::parallelPredicateSelection(const PredicateExpression<T>& predicate, unsigned int number_of_threads){
+	TID number_of_rows=this->size();
+	TID number_of_blocks=(number_of_rows+parallel_selection_block_size-1)/parallel_selection_block_size;
+	std::vector<PositionList> block_tids(number_of_blocks);
+	parallel_for(0,number_of_blocks,[&](TID begin, TID end){
+		//every thread decodes into its own buffer
+		boost::scoped_array<T> values(new T[predicate_chunk_size]);
+		for(TID block=begin;block<end;block++){
+			TID block_end=std::min(number_of_rows,TID((block+1)*parallel_selection_block_size));
+			for(TID chunk_begin=block*parallel_selection_block_size;chunk_begin<block_end;chunk_begin+=predicate_chunk_size){
+				TID chunk_end=std::min(block_end,TID(chunk_begin+predicate_chunk_size));
+				decodeRange(chunk_begin,chunk_end,values.get());
+				evaluatePredicate(predicate,values.get(),chunk_end-chunk_begin,chunk_begin,block_tids[block]);
+			}
+		}
+	},number_of_threads,1);
+	size_t number_of_matches=0;
+	for(TID block=0;block<number_of_blocks;block++){
+		number_of_matches+=block_tids[block].size();
+	}
+	PositionListPtr result_tids(new PositionList());
+	result_tids->reserve(number_of_matches);
+	for(TID block=0;block<number_of_blocks;block++){
+		result_tids->insert(result_tids->end(),block_tids[block].begin(),block_tids[block].end());
+	}
+	return result_tids;
 }
 
 
@@ -159,40 +761,25 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		}
 			
 		T value = boost::any_cast<T>(value_for_comparison);
-	
-
-		PositionListPtr result_tids;
 
-				result_tids = PositionListPtr(new PositionList());
-
-				if(!quiet) std::cout << "Using CPU for Selection..." << std::endl;
-				for(TID i=0;i<this->size();i++){
-		
-					//boost::any value = column->get(i);
-					//val = values_[i];
-			
-					if(comp==EQUAL){
-					if(value==(*this)[i]){
-						//result_table->insert(this->fetchTuple(i));
-						result_tids->push_back(i);
-					}
-					}else if(comp==LESSER){
-					if((*this)[i]<value){
-						//result_table->insert(this->fetchTuple(i));
-						result_tids->push_back(i);
-					}
-					}else if(comp==GREATER){
-					if((*this)[i]>value){
-						result_tids->push_back(i);
-						//result_table->insert(this->fetchTuple(i));
-					}
-					}else{
-
-					}
-				}	
-
-	    //}
-	    return result_tids;
+		if(is_sorted_){
+			//the matching rows of a sorted column form a contiguous TID range
+			if(comp==EQUAL){
+				return createTIDRange(lowerBound(value),upperBound(value));
+			}else if(comp==LESSER){
+				return createTIDRange(0,lowerBound(value));
+			}else if(comp==GREATER){
+				return createTIDRange(upperBound(value),this->size());
+			}
+		}
+		PositionListPtr result_tids=index_scan(value_for_comparison,comp);
+		if(result_tids) return result_tids;
+
+		if(!quiet) std::cout << "Using CPU for Selection..." << std::endl;
+		//the comparator is resolved once, the loop over the values runs a kernel specialized for it
+		typename PredicateExpression<T>::PredicateExpressionPtr predicate=makeComparison(comp,value);
+		if(!predicate) return PositionListPtr(new PositionList());
+		return this->predicate_selection(*predicate);
 }
 
 	
@@ -214,21 +801,35 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				join_tids->second = PositionListPtr( new PositionList() );
 
 
-	//create hash table
+	//create hash table and a Bloom filter on the same values
 	HashTable hashtable;
-	for(unsigned int i=0;i<this->size();i++)	
-		hashtable.insert(
-								std::pair<T,TID> ((*this)[i],i)
-					);
-
-	//probe larger relation
-	for(unsigned int i=0;i<join_column->size();i++){
-		std::pair<typename HashTable::iterator, typename HashTable::iterator> range =  hashtable.equal_range((*join_column)[i]);
-		for(typename HashTable::iterator it=range.first ; it!=range.second;it++){
-			if(it->first==(*join_column)[i]){
-				join_tids->first->push_back(it->second);
-				join_tids->second->push_back(i);
-				//cout << "match! " << it->second << ", " << i << "	"  << it->first << endl;
+	BloomFilter bloom_filter(this->size());
+	for(TID i=0;i<this->size();i++){
+		T value=this->getValue(i);
+		hashtable.insert(std::pair<T,TID>(value,i));
+		bloom_filter.insert(BloomFilter::hash(value));
+	}
+
+	//probe larger relation chunk wise, only rows passing the Bloom filter access the hash table
+	boost::scoped_array<T> values(new T[predicate_chunk_size]);
+	uint64_t hash_values[predicate_chunk_size];
+	unsigned char may_match[predicate_chunk_size];
+	for(TID begin=0;begin<join_column->size();begin+=predicate_chunk_size){
+		TID end=std::min(TID(join_column->size()),TID(begin+predicate_chunk_size));
+		join_column->decodeRange(begin,end,values.get());
+		for(TID i=0;i<end-begin;i++){
+			hash_values[i]=BloomFilter::hash(values[i]);
+		}
+		bloom_filter.containsBatch(hash_values,end-begin,may_match);
+		for(TID i=0;i<end-begin;i++){
+			if(!may_match[i]) continue;
+			std::pair<typename HashTable::iterator, typename HashTable::iterator> range =  hashtable.equal_range(values[i]);
+			for(typename HashTable::iterator it=range.first ; it!=range.second;it++){
+				if(it->first==values[i]){
+					join_tids->first->push_back(it->second);
+					join_tids->second->push_back(begin+i);
+					//cout << "match! " << it->second << ", " << i << "	"  << it->first << endl;
+				}
 			}
 		}
 	}
@@ -236,6 +837,20 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		return join_tids;
 	}
 
+	template<class T>
+	const BloomFilterPtr ColumnBaseTyped<T>::createBloomFilter(){
+		BloomFilterPtr bloom_filter(new BloomFilter(this->size()));
+		boost::scoped_array<T> values(new T[predicate_chunk_size]);
+		for(TID begin=0;begin<this->size();begin+=predicate_chunk_size){
+			TID end=std::min(TID(this->size()),TID(begin+predicate_chunk_size));
+			decodeRange(begin,end,values.get());
+			for(TID i=0;i<end-begin;i++){
+				bloom_filter->insert(BloomFilter::hash(values[i]));
+			}
+		}
+		return bloom_filter;
+	}
+
 	template<class Type>
 	const PositionListPairPtr ColumnBaseTyped<Type>::sort_merge_join(ColumnPtr join_column_){
 
@@ -251,6 +866,46 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				join_tids->first = PositionListPtr( new PositionList() );
 				join_tids->second = PositionListPtr( new PositionList() );
 
+		typedef std::vector<std::pair<Type,TID> > SortedRows;
+		SortedRows rows[2]={SortedRows(this->size()),SortedRows(join_column->size())};
+		ColumnBaseTyped<Type>* columns[2]={this,join_column.get()};
+		boost::scoped_array<Type> values(new Type[predicate_chunk_size]);
+		for(unsigned int side=0;side<2;side++){
+			for(TID begin=0;begin<rows[side].size();begin+=predicate_chunk_size){
+				TID end=std::min(TID(rows[side].size()),TID(begin+predicate_chunk_size));
+				columns[side]->decodeRange(begin,end,values.get());
+				for(TID i=begin;i<end;i++){
+					rows[side][i]=std::make_pair(values[i-begin],i);
+				}
+			}
+			//the rows of a sorted column are already ordered by value and TID
+			if(!columns[side]->isSorted()) std::sort(rows[side].begin(),rows[side].end());
+		}
+
+		//merge, every run of equal values on the left joins with the run of the same value on the right
+		size_t left=0;
+		size_t right=0;
+		while(left<rows[0].size() && right<rows[1].size()){
+			if(rows[0][left].first<rows[1][right].first){
+				++left;
+			}else if(rows[1][right].first<rows[0][left].first){
+				++right;
+			}else{
+				size_t left_end=left;
+				while(left_end<rows[0].size() && rows[0][left_end].first==rows[0][left].first) ++left_end;
+				size_t right_end=right;
+				while(right_end<rows[1].size() && rows[1][right_end].first==rows[1][right].first) ++right_end;
+				for(size_t i=left;i<left_end;i++){
+					for(size_t j=right;j<right_end;j++){
+						join_tids->first->push_back(rows[0][i].second);
+						join_tids->second->push_back(rows[1][j].second);
+					}
+				}
+				left=left_end;
+				right=right_end;
+			}
+		}
+
 				return join_tids;
 	}
 
@@ -270,9 +925,13 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 				join_tids->first = PositionListPtr( new PositionList() );
 				join_tids->second = PositionListPtr( new PositionList() );
 
-		for(unsigned int i=0;i<this->size();i++){
-			for(unsigned int j=0;j<join_column->size();j++){
-				if((*this)[i]==(*join_column)[j]){
+		//the inner column is decoded once instead of once per outer row
+		boost::scoped_array<Type> join_values(new Type[join_column->size()]);
+		join_column->decodeRange(0,join_column->size(),join_values.get());
+		for(TID i=0;i<this->size();i++){
+			Type value=this->getValue(i);
+			for(TID j=0;j<join_column->size();j++){
+				if(value==join_values[j]){
 					if(debug) std::cout << "MATCH: (" << i << "," << j << ")" << std::endl;
 					join_tids->first->push_back(i);
 					join_tids->second->push_back(j);
@@ -283,11 +942,67 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		return join_tids;
 	}
 
+	template<class T>
+	const PositionListPairPtr ColumnBaseTyped<T>::join(ColumnPtr join_column_){
+		if(join_column_->type()!=typeid(T)){
+			std::cout << "Fatal Error!!! Typemismatch for columns " << this->name_  << " and " << join_column_->getName() << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > join_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<T> >(join_column_);
+
+		//only kept statistics are used, computing them would cost another pass over both columns
+		if(statistics_ && join_column->statistics_ && statistics_->estimateJoinSize(*join_column->statistics_)==0){
+			PositionListPairPtr join_tids(new PositionListPair());
+			join_tids->first=PositionListPtr(new PositionList());
+			join_tids->second=PositionListPtr(new PositionList());
+			return join_tids;
+		}
+		JoinAlgorithm algorithm=chooseJoinAlgorithm(*join_column);
+		if(algorithm==NESTED_LOOP_JOIN) return this->nested_loop_join(join_column_);
+		if(algorithm==SORT_MERGE_JOIN) return this->sort_merge_join(join_column_);
+		if(isHashJoinBuildSide(*join_column)) return this->hash_join(join_column_);
+		//the join column does not keep the pointer to this column beyond the call
+		PositionListPairPtr join_tids=join_column->hash_join(ColumnPtr(this,boost::null_deleter()));
+		std::swap(join_tids->first,join_tids->second);
+		return join_tids;
+	}
+
+	template<class T>
+	JoinAlgorithm ColumnBaseTyped<T>::chooseJoinAlgorithm(const ColumnBaseTyped<T>& join_column) const{
+		//every algorithm writes the same result, so the costs of the result are left out
+		double nested_loop_costs=double(this->size())*join_column.size();
+		double hash_join_costs=std::min(estimateHashJoinCosts(*this,join_column),estimateHashJoinCosts(join_column,*this));
+		double sort_merge_costs=this->estimateSortMergeCosts()+join_column.estimateSortMergeCosts();
+		if(nested_loop_costs<=hash_join_costs && nested_loop_costs<=sort_merge_costs) return NESTED_LOOP_JOIN;
+		if(sort_merge_costs<hash_join_costs) return SORT_MERGE_JOIN;
+		return HASH_JOIN;
+	}
+
+	template<class T>
+	bool ColumnBaseTyped<T>::isHashJoinBuildSide(const ColumnBaseTyped<T>& join_column) const{
+		return estimateHashJoinCosts(*this,join_column)<=estimateHashJoinCosts(join_column,*this);
+	}
+
+	template<class T>
+	double ColumnBaseTyped<T>::estimateHashJoinCosts(const ColumnBaseTyped<T>& build_column, const ColumnBaseTyped<T>& probe_column){
+		//a probe row passes the Bloom filter, if its value is one of the values of the build column
+		double match_share=std::min(1.0,double(build_column.estimateNumberOfDistinctValues())/std::max<size_t>(1,probe_column.estimateNumberOfDistinctValues()));
+		return hash_join_build_cost*build_column.size()+probe_column.size()*(hash_join_filter_cost+match_share*hash_join_lookup_cost);
+	}
+
+	template<class T>
+	double ColumnBaseTyped<T>::estimateSortMergeCosts() const{
+		double number_of_rows=this->size();
+		if(this->isSorted() || number_of_rows<2) return number_of_rows;
+		return number_of_rows+join_sort_cost*number_of_rows*std::log2(number_of_rows);
+	}
+
 	template<class T>
 	bool ColumnBaseTyped<T>::operator==(ColumnBaseTyped<T>& column){
 	  if(this->size()!=column.size()) return false;
-	  for(unsigned int i=0;i<this->size();i++){
-			if((*this)[i]!=column[i]){ 	
+	  for(TID i=0;i<this->size();i++){
+			if(this->getValue(i)!=column.getValue(i)){ 	
 				return false;
 			}
 	  }
@@ -301,9 +1016,10 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 			 Type value = boost::any_cast<Type>(new_value);
 			 //std::transform(myvec.begin(), myvec.end(), myvec.begin(),
           //bind2nd(std::plus<double>(), 1.0));
-			 for(unsigned int i=0;i<this->size();i++){
+			 for(TID i=0;i<this->size();i++){
 					this->operator[](i)+=value;
 			 }
+			 this->rebuildIndexes();
 			 return true;
 		}
 		return false;
@@ -313,12 +1029,15 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 			
 	template<class Type>
 	bool ColumnBaseTyped<Type>::add(ColumnPtr column){
+		//the values can be in a different order afterwards
+		this->is_sorted_=false;
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
 		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
 		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)+=typed_column->operator[](i);
+		for(TID i=0;i<this->size();i++){
+			this->operator[](i)+=typed_column->getValue(i);
 		}			
+		this->rebuildIndexes();
 		return true;
 	}
 
@@ -330,9 +1049,10 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 		if(new_value.empty()) return false;
 		if(typeid(Type)==new_value.type()){
 			 Type value = boost::any_cast<Type>(new_value);
-			 for(unsigned int i=0;i<this->size();i++){
+			 for(TID i=0;i<this->size();i++){
 					this->operator[](i)-=value;
 			 }
+			 this->rebuildIndexes();
 			 return true;
 		}
 		return false;
@@ -340,24 +1060,30 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	
 	template<class Type>
 	bool ColumnBaseTyped<Type>::minus(ColumnPtr column){
+		//the values can be in a different order afterwards
+		this->is_sorted_=false;
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
 		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
 		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)-=typed_column->operator[](i);
+		for(TID i=0;i<this->size();i++){
+			this->operator[](i)-=typed_column->getValue(i);
 		}			
+		this->rebuildIndexes();
 		return true;
 	}	
 
 
 	template<class Type>
 	bool ColumnBaseTyped<Type>::multiply(const boost::any& new_value){
+		//the values can be in a different order afterwards
+		this->is_sorted_=false;
 		if(new_value.empty()) return false;
 		if(typeid(Type)==new_value.type()){
 			 Type value = boost::any_cast<Type>(new_value);
-			 for(unsigned int i=0;i<this->size();i++){
+			 for(TID i=0;i<this->size();i++){
 					this->operator[](i)*=value;
 			 }
+			 this->rebuildIndexes();
 			 return true;
 		}
 		return false;
@@ -365,12 +1091,15 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	
 	template<class Type>
 	bool ColumnBaseTyped<Type>::multiply(ColumnPtr column){
+		//the values can be in a different order afterwards
+		this->is_sorted_=false;
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
 		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
 		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)*=typed_column->operator[](i);
+		for(TID i=0;i<this->size();i++){
+			this->operator[](i)*=typed_column->getValue(i);
 		}			
+		this->rebuildIndexes();
 		return true;
 	}
 
@@ -378,14 +1107,17 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 
 	template<class Type>
 	bool ColumnBaseTyped<Type>::division(const boost::any& new_value){
+		//the values can be in a different order afterwards
+		this->is_sorted_=false;
 		if(new_value.empty()) return false;
 		if(typeid(Type)==new_value.type()){
 			 Type value = boost::any_cast<Type>(new_value);
 			 //check that we do not devide by zero
 			 if(value==0) return false;
-			 for(unsigned int i=0;i<this->size();i++){
+			 for(TID i=0;i<this->size();i++){
 					this->operator[](i)/=value;
 			 }
+			 this->rebuildIndexes();
 			 return true;
 		}
 		return false;
@@ -393,12 +1125,15 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	
 	template<class Type>
 	bool ColumnBaseTyped<Type>::division(ColumnPtr column){
+		//the values can be in a different order afterwards
+		this->is_sorted_=false;
 		//std::transform ( first, first+5, second, results, std::plus<int>() );		
 		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<Type> > typed_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<Type> >(column);
 		if(!column) return false;
-		for(unsigned int i=0;i<this->size();i++){
-			this->operator[](i)/=typed_column->operator[](i);
+		for(TID i=0;i<this->size();i++){
+			this->operator[](i)/=typed_column->getValue(i);
 		}			
+		this->rebuildIndexes();
 		return true;
 	}
 
@@ -424,5 +1159,26 @@ const PositionListPtr ColumnBaseTyped<T>::selection(const boost::any& value_for_
 	template<>
 	inline bool ColumnBaseTyped<std::string>::division(ColumnPtr){ return false;	}
 
+	//numeric computations are undefined on booleans as well
+	template<>
+	inline bool ColumnBaseTyped<bool>::add(const boost::any&){ return false;	}
+	template<>
+	inline bool ColumnBaseTyped<bool>::add(ColumnPtr){ return false;	}
+
+	template<>
+	inline bool ColumnBaseTyped<bool>::minus(const boost::any&){ return false;	}
+	template<>
+	inline bool ColumnBaseTyped<bool>::minus(ColumnPtr){ return false;	}
+
+	template<>
+	inline bool ColumnBaseTyped<bool>::multiply(const boost::any&){ return false;	}
+	template<>
+	inline bool ColumnBaseTyped<bool>::multiply(ColumnPtr){ return false;	}
+
+	template<>
+	inline bool ColumnBaseTyped<bool>::division(const boost::any&){ return false;	}
+	template<>
+	inline bool ColumnBaseTyped<bool>::division(ColumnPtr){ return false;	}
+
 }; //end namespace CogaDB
 
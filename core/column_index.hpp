@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <core/base_column.hpp>
+#include <core/column_input_file.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     Base class of the secondary indexes, which can be attached to a CoGaDB::ColumnBaseTyped.
+ *  \details   An index maps values to the TIDs of the rows, which contain them. The column keeps its indexes up to date: it inserts an entry for every
+ *  appended row, replaces the entry of an updated row and removes the entries of removed rows. Removing rows shifts all following TIDs, so
+ *  renumber() adjusts the remaining entries. An index is stored as its list of entries and rebuilt on load.
+ */
+template<class T>
+class ColumnIndex{
+	public:
+	typedef shared_pointer_namespace::shared_ptr<ColumnIndex<T> > ColumnIndexPtr;
+
+	virtual ~ColumnIndex(){}
+	virtual IndexType getIndexType() const throw()=0;
+	/*! \brief adds the entry (value,tid)*/
+	virtual void insert(const T& value, TID tid)=0;
+	/*! \brief removes the entry (value,tid)*/
+	virtual void remove(const T& value, TID tid)=0;
+	/*! \brief every TID decreases by the number of removed_tids before it, removed_tids is sorted ascending and its entries are already removed*/
+	virtual void renumber(const PositionList& removed_tids)=0;
+	/*! \brief removes the entries (values[i],removed_tids[i]) of removed rows and renumbers the remaining entries like renumber()
+	 *  \details The default removes every entry with remove(), an index, which can remove many entries in one pass, overrides it.*/
+	virtual void removeRows(const std::vector<T>& values, const PositionList& removed_tids);
+	virtual void clear()=0;
+	/*! \brief appends all entries to values and tids*/
+	virtual void getEntries(std::vector<T>& values, PositionList& tids) const=0;
+	/*! \brief returns a deep copy, which is used by copies of the indexed column*/
+	virtual ColumnIndexPtr clone() const=0;
+	virtual size_t size() const throw()=0;
+	virtual size_t getSizeinBytes() const throw()=0;
+
+	/*! \brief writes all entries to the file path*/
+	bool store(const std::string& path) const;
+	/*! \brief replaces the entries with the entries in the file path*/
+	bool load(const std::string& path);
+
+	/*! \brief returns the new TID of tid after the rows removed_tids were removed*/
+	static TID renumberTID(TID tid, const PositionList& removed_tids);
+	/*! \brief returns the name of the file of an index of type index_type on column column_name in directory path*/
+	static const std::string getFileName(const std::string& path, const std::string& column_name, IndexType index_type);
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	bool ColumnIndex<T>::store(const std::string& path) const{
+		std::vector<T> values;
+		PositionList tids;
+		getEntries(values,tids);
+		std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
+		if(!outfile.good()) return false;
+		boost::archive::binary_oarchive oa(outfile);
+		oa << values;
+		oa << tids;
+		outfile.flush();
+		outfile.close();
+		return true;
+	}
+
+	template<class T>
+	bool ColumnIndex<T>::load(const std::string& path){
+		ColumnInputFile infile (path);
+		if(!infile.good()) return false;
+		std::vector<T> values;
+		PositionList tids;
+		boost::archive::binary_iarchive ia(infile);
+		ia >> values;
+		ia >> tids;
+		infile.close();
+		clear();
+		for(size_t i=0;i<values.size();i++){
+			insert(values[i],tids[i]);
+		}
+		return true;
+	}
+
+	template<class T>
+	void ColumnIndex<T>::removeRows(const std::vector<T>& values, const PositionList& removed_tids){
+		for(size_t i=0;i<removed_tids.size();i++){
+			remove(values[i],removed_tids[i]);
+		}
+		renumber(removed_tids);
+	}
+
+	template<class T>
+	TID ColumnIndex<T>::renumberTID(TID tid, const PositionList& removed_tids){
+		return tid-(std::lower_bound(removed_tids.begin(),removed_tids.end(),tid)-removed_tids.begin());
+	}
+
+	template<class T>
+	const std::string ColumnIndex<T>::getFileName(const std::string& path, const std::string& column_name, IndexType index_type){
+		if(index_type==HASH_INDEX) return path+"/"+column_name+"-hash_index";
+		if(index_type==BPLUS_TREE_INDEX) return path+"/"+column_name+"-bplus_tree_index";
+		return path+"/"+column_name+"-cracker_index";
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <fstream>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <core/global_definitions.hpp>
+
+namespace CoGaDB{
+
+typedef shared_pointer_namespace::shared_ptr<std::vector<char> > FileBufferPtr;
+
+/*!
+ *  \brief     Registry of files, which were read into main memory ahead of time, e.g., by a CoGaDB::ColumnLoader.
+ *  \details   A prefetched file is handed out once: CoGaDB::ColumnInputFile takes it from the registry and frees the buffer, when it is closed.
+ */
+class PrefetchedFiles{
+	public:
+	static PrefetchedFiles& instance();
+
+	void insert(const std::string& path, FileBufferPtr buffer);
+	/*! \brief removes the prefetched file path from the registry
+	 *  \return the content of the file, or a null pointer, if the file was not prefetched*/
+	FileBufferPtr take(const std::string& path);
+	size_t size() const;
+
+	private:
+	PrefetchedFiles();
+	PrefetchedFiles(const PrefetchedFiles&);
+	PrefetchedFiles& operator=(const PrefetchedFiles&);
+
+	std::map<std::string,FileBufferPtr> files_;
+	mutable std::mutex mutex_;
+};
+
+/*!
+ *  \brief     Input stream for the load() methods of the columns, which reads a prefetched file from main memory and all other files from disk.
+ */
+class ColumnInputFile : public std::istream{
+	public:
+	explicit ColumnInputFile(const std::string& path);
+	void close();
+
+	private:
+	ColumnInputFile(const ColumnInputFile&);
+	ColumnInputFile& operator=(const ColumnInputFile&);
+
+	/*! \brief stream buffer over the content of a prefetched file*/
+	class MemoryBuffer : public std::streambuf{
+		public:
+		MemoryBuffer();
+		void setBuffer(FileBufferPtr buffer);
+		private:
+		FileBufferPtr buffer_;
+	};
+
+	MemoryBuffer memory_buffer_;
+	std::filebuf file_buffer_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline PrefetchedFiles& PrefetchedFiles::instance(){
+		static PrefetchedFiles files;
+		return files;
+	}
+
+	inline PrefetchedFiles::PrefetchedFiles() : files_(), mutex_(){
+
+	}
+
+	inline void PrefetchedFiles::insert(const std::string& path, FileBufferPtr buffer){
+		std::lock_guard<std::mutex> lock(mutex_);
+		files_[path]=buffer;
+	}
+
+	inline FileBufferPtr PrefetchedFiles::take(const std::string& path){
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::map<std::string,FileBufferPtr>::iterator it=files_.find(path);
+		if(it==files_.end()) return FileBufferPtr();
+		FileBufferPtr buffer=it->second;
+		files_.erase(it);
+		return buffer;
+	}
+
+	inline size_t PrefetchedFiles::size() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return files_.size();
+	}
+
+	inline ColumnInputFile::MemoryBuffer::MemoryBuffer() : std::streambuf(), buffer_(){
+
+	}
+
+	inline void ColumnInputFile::MemoryBuffer::setBuffer(FileBufferPtr buffer){
+		buffer_=buffer;
+		char* begin=buffer_->empty() ? NULL : &(*buffer_)[0];
+		setg(begin,begin,begin+buffer_->size());
+	}
+
+	inline ColumnInputFile::ColumnInputFile(const std::string& path) : std::istream(NULL), memory_buffer_(), file_buffer_(){
+		FileBufferPtr buffer=PrefetchedFiles::instance().take(path);
+		if(buffer){
+			memory_buffer_.setBuffer(buffer);
+			rdbuf(&memory_buffer_);
+		}else if(file_buffer_.open(path.c_str(),std::ios_base::binary | std::ios_base::in)){
+			rdbuf(&file_buffer_);
+		}else{
+			setstate(std::ios_base::failbit);
+		}
+	}
+
+	inline void ColumnInputFile::close(){
+		if(file_buffer_.is_open()) file_buffer_.close();
+		memory_buffer_.setBuffer(FileBufferPtr(new std::vector<char>()));
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
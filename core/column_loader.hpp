@@ -0,0 +1,328 @@
+#pragma once
+
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <core/base_column.hpp>
+#include <core/column_input_file.hpp>
+#include <core/io_uring.hpp>
+#include <core/parallel.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     Loads the columns of a table in parallel: the files of all columns are read concurrently, and each column is deserialized as soon as
+ *  its files are in main memory, while the files of the other columns are still read.
+ *  \details   The files of a column are its file in the directory and the files, whose name is the column name followed by a known suffix,
+ *  i.e., the '-meta' file of a compressed column and the stored indexes. The files of a column 'a-b' are not files of a column 'a'. The files are read with io_uring, if the kernel supports it, otherwise with one
+ *  reader thread per available thread. A completed file is handed to the load() method of its column through CoGaDB::PrefetchedFiles, so
+ *  load() deserializes from main memory. Every column can be used as soon as waitForColumn() returned for it.
+ */
+class ColumnLoader{
+	public:
+	explicit ColumnLoader(const std::string& path, unsigned int number_of_threads=getNumberOfAvailableThreads());
+	~ColumnLoader();
+
+	/*! \brief adds an empty column, which is loaded from the directory of the loader
+	 *  \return the id of the column for waitForColumn()*/
+	size_t addColumn(ColumnPtr column);
+	/*! \brief starts reading and loading all added columns and returns immediately*/
+	void start();
+	/*! \brief waits until the column with id column_id is loaded
+	 *  \return true, if the column was loaded successfully*/
+	bool waitForColumn(size_t column_id);
+	/*! \brief waits until all columns are loaded
+	 *  \return true, if all columns were loaded successfully*/
+	bool waitForAll();
+	/*! \brief returns true, if the files were read with io_uring*/
+	bool usesIOUring() const;
+
+	private:
+	ColumnLoader(const ColumnLoader&);
+	ColumnLoader& operator=(const ColumnLoader&);
+
+	enum ColumnState{COLUMN_PENDING,COLUMN_LOADED,COLUMN_FAILED};
+
+	struct FileRead{
+		std::string path;
+		size_t column_id;
+		int fd;
+		FileBufferPtr buffer;
+		/*! number of bytes, which were read so far*/
+		size_t offset;
+		struct iovec iov;
+	};
+
+	/*! \brief returns true, if file_name is the file of the column column_name or one of the files, which columns store next to it*/
+	static bool isFileOfColumn(const std::string& file_name, const std::string& column_name);
+	/*! \brief opens the files of all columns*/
+	void openFiles();
+	void readWithIOUring(IOUring& ring);
+	void readWithThreads();
+	/*! \brief entry point of the reader thread*/
+	void readFiles();
+	/*! \brief hands a completely read file to its column, a file, which could not be read, is read by load() itself*/
+	void fileCompleted(size_t file_id, bool success);
+	/*! \brief entry point of the worker threads, which load the columns, whose files are read*/
+	void loadColumns();
+
+	std::string path_;
+	unsigned int number_of_threads_;
+	std::vector<ColumnPtr> columns_;
+	std::vector<FileRead> files_;
+	std::vector<size_t> number_of_pending_files_;
+	std::vector<ColumnState> column_states_;
+	/*! ids of the columns, whose files are read, but which are not loaded yet*/
+	std::vector<size_t> load_queue_;
+	size_t number_of_queued_columns_;
+	bool uses_io_uring_;
+	bool started_;
+	std::thread reader_;
+	std::vector<std::thread> workers_;
+	mutable std::mutex mutex_;
+	std::condition_variable load_queue_changed_;
+	std::condition_variable column_loaded_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline ColumnLoader::ColumnLoader(const std::string& path, unsigned int number_of_threads) : path_(path), number_of_threads_(std::max(1u,number_of_threads)),
+		columns_(), files_(), number_of_pending_files_(), column_states_(), load_queue_(), number_of_queued_columns_(0), uses_io_uring_(false),
+		started_(false), reader_(), workers_(), mutex_(), load_queue_changed_(), column_loaded_(){
+
+	}
+
+	inline ColumnLoader::~ColumnLoader(){
+		waitForAll();
+	}
+
+	inline size_t ColumnLoader::addColumn(ColumnPtr column){
+		columns_.push_back(column);
+		number_of_pending_files_.push_back(0);
+		column_states_.push_back(COLUMN_PENDING);
+		return columns_.size()-1;
+	}
+
+	inline bool ColumnLoader::isFileOfColumn(const std::string& file_name, const std::string& column_name){
+		if(file_name.compare(0,column_name.size(),column_name)!=0) return false;
+		//the suffixes of ColumnIndex<T>::getFileName() and of the meta data of the compressed columns
+		static const char* const suffixes[]={"","-meta","-hash_index","-bplus_tree_index","-cracker_index"};
+		for(size_t i=0;i<sizeof(suffixes)/sizeof(suffixes[0]);i++){
+			if(file_name.compare(column_name.size(),std::string::npos,suffixes[i])==0) return true;
+		}
+		return false;
+	}
+
+	inline void ColumnLoader::openFiles(){
+		DIR* directory=opendir(path_.c_str());
+		if(!directory){
+			std::cout << "Fatal Error! Could not open directory " << path_ << std::endl;
+			return;
+		}
+		std::vector<std::string> file_names;
+		while(struct dirent* entry=readdir(directory)){
+			file_names.push_back(entry->d_name);
+		}
+		closedir(directory);
+		for(size_t column_id=0;column_id<columns_.size();column_id++){
+			const std::string name=columns_[column_id]->getName();
+			for(size_t i=0;i<file_names.size();i++){
+				if(!isFileOfColumn(file_names[i],name)) continue;
+				//the same path as the load() methods use, so they find the prefetched file
+				FileRead file={path_+"/"+file_names[i],column_id,-1,FileBufferPtr(),0,iovec()};
+				file.fd=open(file.path.c_str(),O_RDONLY);
+				struct stat file_status;
+				if(file.fd<0 || fstat(file.fd,&file_status)!=0 || !S_ISREG(file_status.st_mode)){
+					if(file.fd>=0) close(file.fd);
+					continue;
+				}
+				file.buffer=FileBufferPtr(new std::vector<char>(file_status.st_size));
+				files_.push_back(file);
+				++number_of_pending_files_[column_id];
+			}
+		}
+	}
+
+	inline void ColumnLoader::start(){
+		if(started_) return;
+		started_=true;
+		openFiles();
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for(size_t column_id=0;column_id<columns_.size();column_id++){
+				if(number_of_pending_files_[column_id]==0) load_queue_.push_back(column_id);
+			}
+			number_of_queued_columns_=load_queue_.size();
+		}
+		reader_=std::thread(&ColumnLoader::readFiles,this);
+		unsigned int number_of_workers=std::min<size_t>(number_of_threads_,std::max<size_t>(columns_.size(),1));
+		for(unsigned int i=0;i<number_of_workers;i++){
+			workers_.push_back(std::thread(&ColumnLoader::loadColumns,this));
+		}
+	}
+
+	inline void ColumnLoader::readFiles(){
+		IOUring ring(64);
+		if(ring.isAvailable()){
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				uses_io_uring_=true;
+			}
+			readWithIOUring(ring);
+		}else{
+			readWithThreads();
+		}
+	}
+
+	inline void ColumnLoader::readWithIOUring(IOUring& ring){
+		//files, which have bytes left to read and no read in flight
+		std::vector<size_t> pending_reads;
+		for(size_t file_id=files_.size();file_id>0;file_id--){
+			if(files_[file_id-1].buffer->empty()){
+				fileCompleted(file_id-1,true);
+			}else{
+				pending_reads.push_back(file_id-1);
+			}
+		}
+		unsigned int number_of_reads_in_flight=0;
+		std::vector<unsigned char> in_flight(files_.size(),0);
+		while(!pending_reads.empty() || number_of_reads_in_flight>0){
+			//at most one read per entry is in flight, so the completion queue can not overflow
+			while(!pending_reads.empty() && number_of_reads_in_flight<ring.getNumberOfEntries()){
+				FileRead& file=files_[pending_reads.back()];
+				file.iov.iov_base=&(*file.buffer)[file.offset];
+				file.iov.iov_len=file.buffer->size()-file.offset;
+				if(!ring.prepareRead(file.fd,&file.iov,file.offset,pending_reads.back())) break;
+				in_flight[pending_reads.back()]=1;
+				pending_reads.pop_back();
+				++number_of_reads_in_flight;
+			}
+			if(!ring.submitAndWait(1)){
+				if(errno==EINTR) continue;
+				//the ring failed, load() reads the remaining files itself
+				std::cout << "Fatal Error! io_uring_enter failed while loading columns from " << path_ << std::endl;
+				for(size_t i=0;i<pending_reads.size();i++) fileCompleted(pending_reads[i],false);
+				for(size_t i=0;i<in_flight.size();i++){
+					if(in_flight[i]) fileCompleted(i,false);
+				}
+				return;
+			}
+			uint64_t file_id=0;
+			int result=0;
+			while(ring.popCompletion(file_id,result)){
+				--number_of_reads_in_flight;
+				in_flight[file_id]=0;
+				FileRead& file=files_[file_id];
+				if(result<=0){
+					fileCompleted(file_id,false);
+					continue;
+				}
+				file.offset+=result;
+				//a short read is continued from the new offset
+				if(file.offset<file.buffer->size()){
+					pending_reads.push_back(file_id);
+				}else{
+					fileCompleted(file_id,true);
+				}
+			}
+		}
+	}
+
+	inline void ColumnLoader::readWithThreads(){
+		parallel_for(0,files_.size(),[this](TID begin, TID end){
+			for(TID file_id=begin;file_id<end;file_id++){
+				FileRead& file=files_[file_id];
+				bool success=true;
+				while(success && file.offset<file.buffer->size()){
+					ssize_t result=pread(file.fd,&(*file.buffer)[file.offset],file.buffer->size()-file.offset,file.offset);
+					if(result<=0) success=false;
+					else file.offset+=result;
+				}
+				fileCompleted(file_id,success);
+			}
+		},number_of_threads_,1);
+	}
+
+	inline void ColumnLoader::fileCompleted(size_t file_id, bool success){
+		FileRead& file=files_[file_id];
+		close(file.fd);
+		file.fd=-1;
+		if(success) PrefetchedFiles::instance().insert(file.path,file.buffer);
+		file.buffer.reset();
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(--number_of_pending_files_[file.column_id]==0){
+			load_queue_.push_back(file.column_id);
+			++number_of_queued_columns_;
+			load_queue_changed_.notify_all();
+		}
+	}
+
+	inline void ColumnLoader::loadColumns(){
+		while(true){
+			size_t column_id=0;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				while(load_queue_.empty() && number_of_queued_columns_<columns_.size()){
+					load_queue_changed_.wait(lock);
+				}
+				if(load_queue_.empty()){
+					//every column was queued and is loaded by another worker
+					load_queue_changed_.notify_all();
+					return;
+				}
+				column_id=load_queue_.back();
+				load_queue_.pop_back();
+			}
+			bool loaded=columns_[column_id]->load(path_);
+			//drop the prefetched files, which load() did not read, e.g., of an index, which is not attached
+			for(size_t file_id=0;file_id<files_.size();file_id++){
+				if(files_[file_id].column_id==column_id) PrefetchedFiles::instance().take(files_[file_id].path);
+			}
+			std::lock_guard<std::mutex> lock(mutex_);
+			column_states_[column_id]=loaded ? COLUMN_LOADED : COLUMN_FAILED;
+			column_loaded_.notify_all();
+			if(number_of_queued_columns_==columns_.size()) load_queue_changed_.notify_all();
+		}
+	}
+
+	inline bool ColumnLoader::waitForColumn(size_t column_id){
+		if(column_id>=columns_.size()) return false;
+		start();
+		std::unique_lock<std::mutex> lock(mutex_);
+		while(column_states_[column_id]==COLUMN_PENDING){
+			column_loaded_.wait(lock);
+		}
+		return column_states_[column_id]==COLUMN_LOADED;
+	}
+
+	inline bool ColumnLoader::waitForAll(){
+		start();
+		bool loaded=true;
+		for(size_t column_id=0;column_id<columns_.size();column_id++){
+			if(!waitForColumn(column_id)) loaded=false;
+		}
+		if(reader_.joinable()) reader_.join();
+		for(size_t i=0;i<workers_.size();i++){
+			if(workers_[i].joinable()) workers_[i].join();
+		}
+		return loaded;
+	}
+
+	inline bool ColumnLoader::usesIOUring() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return uses_io_uring_;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
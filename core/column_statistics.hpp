@@ -0,0 +1,249 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <core/global_definitions.hpp>
+#include <core/bloom_filter.hpp>
+#include <core/predicate_expression.hpp>
+
+namespace CoGaDB{
+
+/*! \brief number of values, which are sampled from a column to build its histogram*/
+const size_t statistics_sample_size=16*1024;
+/*! \brief number of buckets of the equi-depth histogram of a column*/
+const size_t number_of_histogram_buckets=64;
+
+/*!
+ *  \brief     HyperLogLog sketch, which estimates the number of distinct values of a column in 2 KB with a standard error of about 2%.
+ *  \details   The first 11 bits of the hash value of a value select a register, which keeps the maximal number of leading zeros of the
+ *  remaining bits. Two sketches are combined by taking the maximum of each register, so the sketches of a main and its delta can be merged.
+ */
+class HyperLogLog{
+	public:
+	HyperLogLog();
+
+	void insert(uint64_t hash_value);
+	void merge(const HyperLogLog& sketch);
+	size_t estimate() const;
+
+	private:
+	std::vector<unsigned char> registers_;
+};
+
+/*!
+ *  \brief     Statistics on the values of a column with type T: number of rows, minimum, maximum, number of distinct values and an equi-depth
+ *  histogram.
+ *  \details   Statistics are built in one pass over the values: insert() takes the values of all rows in order and finish() builds the
+ *  histogram. Minimum, maximum and the HyperLogLog sketch see every value, the histogram is built from every k-th value, so at most
+ *  statistics_sample_size values are sorted. The histogram stores the upper bound of every bucket, each bucket has the same number of rows.
+ *  The operators only use statistics for estimates, e.g., to pre-size results and to choose a join algorithm, so estimates may be off.
+ */
+template<class T>
+class ColumnStatistics{
+	public:
+	typedef shared_pointer_namespace::shared_ptr<const ColumnStatistics<T> > ColumnStatisticsPtr;
+
+	/*! \brief creates empty statistics for a column with number_of_rows rows*/
+	explicit ColumnStatistics(size_t number_of_rows);
+
+	/*! \brief adds the values of the next number_of_values rows, the values of all rows have to be added before finish()*/
+	void insert(const T* values, size_t number_of_values);
+	/*! \brief builds the histogram from the sampled values*/
+	void finish();
+	/*! \brief combines these statistics with the statistics of other rows, e.g., of the delta of a column*/
+	void merge(const ColumnStatistics& statistics);
+
+	size_t getNumberOfRows() const;
+	/*! \brief returns the smallest value, the value is undefined for a column without rows*/
+	const T& getMinimum() const;
+	const T& getMaximum() const;
+	size_t getNumberOfDistinctValues() const;
+	/*! \brief upper bounds of the buckets of the equi-depth histogram, sorted ascending*/
+	const std::vector<T>& getHistogram() const;
+
+	/*! \brief estimates the fraction of rows, which fulfill predicate
+	 *  \details The predicate is evaluated on the bucket bounds, every matching bound stands for the rows of its bucket. A predicate, which
+	 *  matches no bound, is assumed to match the rows of one distinct value.*/
+	double estimateSelectivity(const PredicateExpression<T>& predicate) const;
+	/*! \brief estimates the number of rows of an equi join with a column with statistics statistics*/
+	double estimateJoinSize(const ColumnStatistics& statistics) const;
+	/*! \brief returns false, if the value ranges of both columns are disjoint, so an equi join of the columns is empty*/
+	bool overlaps(const ColumnStatistics& statistics) const;
+
+	private:
+	size_t number_of_rows_;
+	/*! number of rows, which were added with insert()*/
+	size_t number_of_inserted_rows_;
+	/*! every sample_stride_-th value is sampled*/
+	size_t sample_stride_;
+	T minimum_;
+	T maximum_;
+	HyperLogLog distinct_values_;
+	std::vector<T> sample_;
+	std::vector<T> bucket_bounds_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	/*! \brief number of bits of a hash value, which select the register of a HyperLogLog sketch*/
+	const unsigned int hyper_log_log_register_bits=11;
+
+	inline HyperLogLog::HyperLogLog() : registers_(size_t(1) << hyper_log_log_register_bits,0){
+
+	}
+
+	inline void HyperLogLog::insert(uint64_t hash_value){
+		size_t index=hash_value >> (64-hyper_log_log_register_bits);
+		uint64_t remaining_bits=hash_value << hyper_log_log_register_bits;
+		unsigned char rank=remaining_bits==0 ? 64-hyper_log_log_register_bits+1 : __builtin_clzll(remaining_bits)+1;
+		if(rank>registers_[index]) registers_[index]=rank;
+	}
+
+	inline void HyperLogLog::merge(const HyperLogLog& sketch){
+		for(size_t i=0;i<registers_.size();i++){
+			registers_[i]=std::max(registers_[i],sketch.registers_[i]);
+		}
+	}
+
+	inline size_t HyperLogLog::estimate() const{
+		double number_of_registers=registers_.size();
+		double sum=0;
+		size_t number_of_empty_registers=0;
+		for(size_t i=0;i<registers_.size();i++){
+			sum+=std::ldexp(1.0,-int(registers_[i]));
+			if(registers_[i]==0) ++number_of_empty_registers;
+		}
+		double alpha=0.7213/(1.0+1.079/number_of_registers);
+		double estimate=alpha*number_of_registers*number_of_registers/sum;
+		//small cardinalities are estimated by linear counting of the empty registers
+		if(estimate<=2.5*number_of_registers && number_of_empty_registers>0){
+			estimate=number_of_registers*std::log(number_of_registers/number_of_empty_registers);
+		}
+		return size_t(estimate+0.5);
+	}
+
+	template<class T>
+	ColumnStatistics<T>::ColumnStatistics(size_t number_of_rows) : number_of_rows_(number_of_rows), number_of_inserted_rows_(0),
+		sample_stride_(std::max<size_t>(1,number_of_rows/statistics_sample_size)), minimum_(), maximum_(), distinct_values_(), sample_(),
+		bucket_bounds_(){
+
+	}
+
+	template<class T>
+	void ColumnStatistics<T>::insert(const T* values, size_t number_of_values){
+		for(size_t i=0;i<number_of_values;i++){
+			if(number_of_inserted_rows_==0 || values[i]<minimum_) minimum_=values[i];
+			if(number_of_inserted_rows_==0 || maximum_<values[i]) maximum_=values[i];
+			distinct_values_.insert(BloomFilter::hash(values[i]));
+			if(number_of_inserted_rows_%sample_stride_==0) sample_.push_back(values[i]);
+			++number_of_inserted_rows_;
+		}
+	}
+
+	template<class T>
+	void ColumnStatistics<T>::finish(){
+		std::sort(sample_.begin(),sample_.end());
+		size_t number_of_buckets=std::min(number_of_histogram_buckets,sample_.size());
+		bucket_bounds_.clear();
+		for(size_t i=0;i<number_of_buckets;i++){
+			bucket_bounds_.push_back(sample_[(i+1)*sample_.size()/number_of_buckets-1]);
+		}
+		std::vector<T>().swap(sample_);
+	}
+
+	template<class T>
+	void ColumnStatistics<T>::merge(const ColumnStatistics& statistics){
+		if(statistics.number_of_rows_==0) return;
+		if(number_of_rows_==0){
+			*this=statistics;
+			return;
+		}
+		//every bound stands for the rows of its bucket, the merged bounds are cut into buckets with the same number of rows again
+		std::vector<std::pair<T,double> > weighted_bounds;
+		for(size_t i=0;i<bucket_bounds_.size();i++){
+			weighted_bounds.push_back(std::make_pair(bucket_bounds_[i],double(number_of_rows_)/bucket_bounds_.size()));
+		}
+		for(size_t i=0;i<statistics.bucket_bounds_.size();i++){
+			weighted_bounds.push_back(std::make_pair(statistics.bucket_bounds_[i],double(statistics.number_of_rows_)/statistics.bucket_bounds_.size()));
+		}
+		std::sort(weighted_bounds.begin(),weighted_bounds.end());
+		number_of_rows_+=statistics.number_of_rows_;
+		number_of_inserted_rows_+=statistics.number_of_inserted_rows_;
+		size_t number_of_buckets=std::min(number_of_histogram_buckets,weighted_bounds.size());
+		bucket_bounds_.clear();
+		double cumulated_rows=0;
+		for(size_t i=0;i<weighted_bounds.size() && bucket_bounds_.size()<number_of_buckets;i++){
+			cumulated_rows+=weighted_bounds[i].second;
+			while(bucket_bounds_.size()<number_of_buckets && cumulated_rows>=double(bucket_bounds_.size()+1)*number_of_rows_/number_of_buckets-0.5){
+				bucket_bounds_.push_back(weighted_bounds[i].first);
+			}
+		}
+		while(bucket_bounds_.size()<number_of_buckets) bucket_bounds_.push_back(weighted_bounds.back().first);
+		if(statistics.minimum_<minimum_) minimum_=statistics.minimum_;
+		if(maximum_<statistics.maximum_) maximum_=statistics.maximum_;
+		distinct_values_.merge(statistics.distinct_values_);
+	}
+
+	template<class T>
+	size_t ColumnStatistics<T>::getNumberOfRows() const{
+		return number_of_rows_;
+	}
+
+	template<class T>
+	const T& ColumnStatistics<T>::getMinimum() const{
+		return minimum_;
+	}
+
+	template<class T>
+	const T& ColumnStatistics<T>::getMaximum() const{
+		return maximum_;
+	}
+
+	template<class T>
+	size_t ColumnStatistics<T>::getNumberOfDistinctValues() const{
+		if(number_of_rows_==0) return 0;
+		return std::max<size_t>(1,std::min(distinct_values_.estimate(),number_of_rows_));
+	}
+
+	template<class T>
+	const std::vector<T>& ColumnStatistics<T>::getHistogram() const{
+		return bucket_bounds_;
+	}
+
+	template<class T>
+	double ColumnStatistics<T>::estimateSelectivity(const PredicateExpression<T>& predicate) const{
+		if(number_of_rows_==0 || bucket_bounds_.empty()) return 0;
+		//no std::vector, std::vector<bool> has no contiguous storage
+		T bounds[number_of_histogram_buckets];
+		unsigned char matches[number_of_histogram_buckets];
+		std::copy(bucket_bounds_.begin(),bucket_bounds_.end(),bounds);
+		predicate.evaluate(bounds,bucket_bounds_.size(),matches);
+		size_t number_of_matching_buckets=0;
+		for(size_t i=0;i<bucket_bounds_.size();i++){
+			number_of_matching_buckets+=matches[i];
+		}
+		if(number_of_matching_buckets==0) return 1.0/std::max(bucket_bounds_.size(),getNumberOfDistinctValues());
+		return double(number_of_matching_buckets)/bucket_bounds_.size();
+	}
+
+	template<class T>
+	double ColumnStatistics<T>::estimateJoinSize(const ColumnStatistics& statistics) const{
+		if(!overlaps(statistics)) return 0;
+		//every value of the side with less distinct values finds its partners on the other side
+		return double(number_of_rows_)*statistics.number_of_rows_/std::max(getNumberOfDistinctValues(),statistics.getNumberOfDistinctValues());
+	}
+
+	template<class T>
+	bool ColumnStatistics<T>::overlaps(const ColumnStatistics& statistics) const{
+		if(number_of_rows_==0 || statistics.number_of_rows_==0) return false;
+		return !(maximum_<statistics.minimum_) && !(statistics.maximum_<minimum_);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
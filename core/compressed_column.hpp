@@ -37,7 +37,7 @@ class CompressedColumn : public ColumnBaseTyped<T>{
 	//virtual const boost::any* const getRawData()=0;
 	virtual void print() const throw() = 0;
 	virtual size_t size() const throw() = 0;
-	virtual unsigned int getSizeinBytes() const throw() = 0;
+	virtual size_t getSizeinBytes() const throw() = 0;
 
 	virtual const ColumnPtr copy() const = 0;
 
@@ -50,7 +50,7 @@ class CompressedColumn : public ColumnBaseTyped<T>{
 	virtual bool isCompressed() const  throw();	
 
 	//?
-	virtual T& operator[](const int index)  = 0;
+	virtual T& operator[](const TID index)  = 0;
 
 };
 
@@ -133,13 +133,13 @@ typedef CompressedColumn<std::string> CompressedStringColumn;
 	}
 
 	template<class T>
-	T& CompressedColumn<T>::operator[](const int index){
+	T& CompressedColumn<T>::operator[](const TID index){
 		static T t;
 		return t;
 	}
 
 	template<class T>
-	unsigned int CompressedColumn<T>::getSizeinBytes() const throw(){
+	size_t CompressedColumn<T>::getSizeinBytes() const throw(){
 		return values_.capacity()*sizeof(T);
 	}
 */
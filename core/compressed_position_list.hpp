@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include <boost/serialization/vector.hpp>
+
+#include <core/base_column.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A position list, which stores every TID with 32 bits, so long living position lists cost as much memory as with 32 bit TIDs.
+ *  \details   Consecutive TIDs with the same upper 32 bits form a run, which stores the upper bits once. Position lists of a single column
+ *  with less than 2^32 rows consist of one run, sorted position lists of larger columns of one run per 2^32 rows. operator[] does a binary
+ *  search over the runs.
+ */
+class CompressedPositionList{
+	public:
+	CompressedPositionList();
+	explicit CompressedPositionList(const PositionList& tids);
+
+	void push_back(TID tid);
+	TID operator[](size_t index) const;
+	size_t size() const;
+	bool empty() const;
+	void clear();
+
+	/*! \brief returns the TIDs as uncompressed position list*/
+	PositionListPtr toPositionList() const;
+	size_t getSizeinBytes() const;
+
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int){
+		ar & low_bits_;
+		ar & run_high_bits_;
+		ar & run_begin_;
+	}
+
+	private:
+	std::vector<uint32_t> low_bits_;
+	/*! upper 32 bits of the TIDs of every run*/
+	std::vector<uint32_t> run_high_bits_;
+	/*! index of the first TID of every run in low_bits_*/
+	std::vector<uint64_t> run_begin_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline CompressedPositionList::CompressedPositionList() : low_bits_(), run_high_bits_(), run_begin_(){
+
+	}
+
+	inline CompressedPositionList::CompressedPositionList(const PositionList& tids) : low_bits_(), run_high_bits_(), run_begin_(){
+		low_bits_.reserve(tids.size());
+		for(size_t i=0;i<tids.size();i++){
+			push_back(tids[i]);
+		}
+	}
+
+	inline void CompressedPositionList::push_back(TID tid){
+		uint32_t high_bits=uint32_t(tid >> 32);
+		if(run_high_bits_.empty() || run_high_bits_.back()!=high_bits){
+			run_high_bits_.push_back(high_bits);
+			run_begin_.push_back(low_bits_.size());
+		}
+		low_bits_.push_back(uint32_t(tid));
+	}
+
+	inline TID CompressedPositionList::operator[](size_t index) const{
+		//the run of index is the last run, which begins before or at index
+		size_t run=std::upper_bound(run_begin_.begin(),run_begin_.end(),uint64_t(index))-run_begin_.begin()-1;
+		return (TID(run_high_bits_[run]) << 32) | low_bits_[index];
+	}
+
+	inline size_t CompressedPositionList::size() const{
+		return low_bits_.size();
+	}
+
+	inline bool CompressedPositionList::empty() const{
+		return low_bits_.empty();
+	}
+
+	inline void CompressedPositionList::clear(){
+		low_bits_.clear();
+		run_high_bits_.clear();
+		run_begin_.clear();
+	}
+
+	inline PositionListPtr CompressedPositionList::toPositionList() const{
+		PositionListPtr tids(new PositionList(low_bits_.size()));
+		for(size_t run=0;run<run_begin_.size();run++){
+			size_t end = run+1<run_begin_.size() ? run_begin_[run+1] : low_bits_.size();
+			TID high_bits=TID(run_high_bits_[run]) << 32;
+			for(size_t i=run_begin_[run];i<end;i++){
+				(*tids)[i]=high_bits | low_bits_[i];
+			}
+		}
+		return tids;
+	}
+
+	inline size_t CompressedPositionList::getSizeinBytes() const{
+		return low_bits_.capacity()*sizeof(uint32_t)+run_high_bits_.capacity()*sizeof(uint32_t)+run_begin_.capacity()*sizeof(uint64_t);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <core/global_definitions.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     Reference counted storage of type T, which the copies of its owner share, until one of them modifies it (copy on write).
+ *  \details   Copying takes constant time and no memory. The first write() after a copy duplicates the storage, the other copies keep the
+ *  original, read() never duplicates. A reference returned by write() must not be used for writes after its owner was copied, because
+ *  the copy would see them. An owner must not be copied, while another thread writes it.
+ */
+template<class T>
+class CopyOnWrite{
+	public:
+	CopyOnWrite();
+	explicit CopyOnWrite(const T& value);
+
+	const T& read() const;
+	/*! \brief returns the storage for modification, it is duplicated first, if a copy of the owner shares it*/
+	T& write();
+	/*! \brief returns true, if a copy of the owner shares the storage*/
+	bool isShared() const;
+
+	private:
+	shared_pointer_namespace::shared_ptr<T> value_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	CopyOnWrite<T>::CopyOnWrite() : value_(new T()){
+
+	}
+
+	template<class T>
+	CopyOnWrite<T>::CopyOnWrite(const T& value) : value_(new T(value)){
+
+	}
+
+	template<class T>
+	const T& CopyOnWrite<T>::read() const{
+		return *value_;
+	}
+
+	template<class T>
+	T& CopyOnWrite<T>::write(){
+		if(!value_.unique()) value_.reset(new T(*value_));
+		return *value_;
+	}
+
+	template<class T>
+	bool CopyOnWrite<T>::isShared() const{
+		return !value_.unique();
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
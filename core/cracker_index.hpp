@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <core/column_index.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     An adaptive index for range and equality predicates (database cracking), which is built as a side effect of the range selections.
+ *  \details   The index keeps a copy of the values and their TIDs. Every lookup partitions the copy around the bounds of the predicate, like
+ *  one step of quicksort, and remembers the position of each bound (a crack). A later lookup only partitions the piece between the two
+ *  neighbouring cracks of its bound, so the copy converges to a sorted array for the queried ranges, while ranges, which are never queried,
+ *  are never reorganized. A crack (v,inclusive) at position p means, that the entries before p have values lesser than v (lesser or equal
+ *  to v, if inclusive), and all other entries do not. Inserts and removes keep the cracks by moving one entry per following piece (ripple).
+ *  Removing rows from the column compacts all pieces in one pass instead, which also renumbers the TIDs. Lookups modify the index, so all
+ *  methods lock it.
+ */
+template<class T>
+class CrackerIndex : public ColumnIndex<T>{
+	public:
+	typedef typename ColumnIndex<T>::ColumnIndexPtr ColumnIndexPtr;
+
+	CrackerIndex();
+	CrackerIndex(const CrackerIndex& index);
+
+	virtual IndexType getIndexType() const throw();
+	virtual void insert(const T& value, TID tid);
+	virtual void remove(const T& value, TID tid);
+	virtual void renumber(const PositionList& removed_tids);
+	/*! \brief removes the entries of the rows removed_tids and renumbers the remaining entries in one pass over the index*/
+	virtual void removeRows(const std::vector<T>& values, const PositionList& removed_tids);
+	virtual void clear();
+	virtual void getEntries(std::vector<T>& values, PositionList& tids) const;
+	virtual ColumnIndexPtr clone() const;
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	/*! \brief returns the TIDs of all rows with a value between lower and upper, a null bound is unbounded, sorted ascending
+	 *  \details Cracks the pieces, which contain the bounds.*/
+	const PositionListPtr lookup(const T* lower, bool lower_inclusive, const T* upper, bool upper_inclusive);
+	/*! \brief number of pieces, in which the cracks divide the values*/
+	size_t getNumberOfPieces() const;
+
+	private:
+	/*! a bound and whether the entries equal to the bound are before the crack, (v,false) is ordered before (v,true) like their positions*/
+	typedef std::pair<T,bool> Crack;
+	typedef std::map<Crack,TID> CrackMap;
+
+	CrackerIndex& operator=(const CrackerIndex&);
+
+	static bool isBeforeCrack(const T& value, const Crack& crack);
+	/*! \brief partitions the piece, which contains crack, and returns the position of crack, the caller has to hold the lock*/
+	TID crack(const Crack& crack);
+
+	std::vector<T> values_;
+	PositionList tids_;
+	CrackMap cracks_;
+	mutable std::mutex mutex_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	CrackerIndex<T>::CrackerIndex() : ColumnIndex<T>(), values_(), tids_(), cracks_(), mutex_(){
+
+	}
+
+	template<class T>
+	CrackerIndex<T>::CrackerIndex(const CrackerIndex& index) : ColumnIndex<T>(), values_(), tids_(), cracks_(), mutex_(){
+		std::lock_guard<std::mutex> lock(index.mutex_);
+		values_=index.values_;
+		tids_=index.tids_;
+		cracks_=index.cracks_;
+	}
+
+	template<class T>
+	IndexType CrackerIndex<T>::getIndexType() const throw(){
+		return CRACKER_INDEX;
+	}
+
+	template<class T>
+	bool CrackerIndex<T>::isBeforeCrack(const T& value, const Crack& crack){
+		return crack.second ? !(crack.first<value) : value<crack.first;
+	}
+
+	template<class T>
+	void CrackerIndex<T>::insert(const T& value, TID tid){
+		std::lock_guard<std::mutex> lock(mutex_);
+		//the new entry is appended to the last piece, the first entry of every following piece moves to its end to open a slot in the right piece
+		TID hole=values_.size();
+		values_.push_back(value);
+		tids_.push_back(tid);
+		for(typename CrackMap::reverse_iterator it=cracks_.rbegin();it!=cracks_.rend() && isBeforeCrack(value,it->first);++it){
+			values_[hole]=values_[it->second];
+			tids_[hole]=tids_[it->second];
+			hole=it->second;
+			++it->second;
+		}
+		values_[hole]=value;
+		tids_[hole]=tid;
+	}
+
+	template<class T>
+	void CrackerIndex<T>::remove(const T& value, TID tid){
+		std::lock_guard<std::mutex> lock(mutex_);
+		//the entry is in the piece between the last crack before value and the first crack after it,
+		//value is not before (value,false) and before all following cracks
+		typename CrackMap::iterator next_crack=cracks_.upper_bound(Crack(value,false));
+		TID begin=next_crack==cracks_.begin() ? 0 : std::prev(next_crack)->second;
+		TID end=next_crack==cracks_.end() ? values_.size() : next_crack->second;
+		TID hole=begin;
+		while(hole<end && (tids_[hole]!=tid || !(values_[hole]==value))) ++hole;
+		if(hole==end) return;
+		//the last entry of the piece and of every following piece fills the hole, which moves to the end
+		for(typename CrackMap::iterator it=next_crack;it!=cracks_.end();++it){
+			values_[hole]=values_[it->second-1];
+			tids_[hole]=tids_[it->second-1];
+			hole=it->second-1;
+			--it->second;
+		}
+		values_[hole]=values_.back();
+		tids_[hole]=tids_.back();
+		values_.pop_back();
+		tids_.pop_back();
+	}
+
+	template<class T>
+	void CrackerIndex<T>::renumber(const PositionList& removed_tids){
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(size_t i=0;i<tids_.size();i++){
+			tids_[i]=ColumnIndex<T>::renumberTID(tids_[i],removed_tids);
+		}
+	}
+
+	template<class T>
+	void CrackerIndex<T>::removeRows(const std::vector<T>&, const PositionList& removed_tids){
+		std::lock_guard<std::mutex> lock(mutex_);
+		//the remaining entries keep their order, so every crack moves to the number of remaining entries before it
+		typename CrackMap::iterator next_crack=cracks_.begin();
+		TID number_of_kept_entries=0;
+		for(TID i=0;i<values_.size();i++){
+			for(;next_crack!=cracks_.end() && next_crack->second==i;++next_crack){
+				next_crack->second=number_of_kept_entries;
+			}
+			PositionList::const_iterator removed=std::lower_bound(removed_tids.begin(),removed_tids.end(),tids_[i]);
+			if(removed!=removed_tids.end() && *removed==tids_[i]) continue;
+			values_[number_of_kept_entries]=values_[i];
+			tids_[number_of_kept_entries]=tids_[i]-(removed-removed_tids.begin());
+			++number_of_kept_entries;
+		}
+		for(;next_crack!=cracks_.end();++next_crack){
+			next_crack->second=number_of_kept_entries;
+		}
+		values_.resize(number_of_kept_entries);
+		tids_.resize(number_of_kept_entries);
+	}
+
+	template<class T>
+	void CrackerIndex<T>::clear(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		values_.clear();
+		tids_.clear();
+		cracks_.clear();
+	}
+
+	template<class T>
+	void CrackerIndex<T>::getEntries(std::vector<T>& values, PositionList& tids) const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		values.insert(values.end(),values_.begin(),values_.end());
+		tids.insert(tids.end(),tids_.begin(),tids_.end());
+	}
+
+	template<class T>
+	typename CrackerIndex<T>::ColumnIndexPtr CrackerIndex<T>::clone() const{
+		return ColumnIndexPtr(new CrackerIndex<T>(*this));
+	}
+
+	template<class T>
+	size_t CrackerIndex<T>::size() const throw(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		return values_.size();
+	}
+
+	template<class T>
+	size_t CrackerIndex<T>::getSizeinBytes() const throw(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		//a map node stores the crack, its position and three pointers
+		return values_.capacity()*sizeof(T)+tids_.capacity()*sizeof(TID)+cracks_.size()*(sizeof(Crack)+sizeof(TID)+3*sizeof(void*));
+	}
+
+	template<class T>
+	TID CrackerIndex<T>::crack(const Crack& crack){
+		typename CrackMap::iterator next_crack=cracks_.lower_bound(crack);
+		if(next_crack!=cracks_.end() && !(crack<next_crack->first)) return next_crack->second;
+		TID begin=next_crack==cracks_.begin() ? 0 : std::prev(next_crack)->second;
+		TID end=next_crack==cracks_.end() ? values_.size() : next_crack->second;
+		//partition the piece [begin,end) like quicksort: entries before the crack to the front, all others to the back
+		while(begin<end){
+			if(isBeforeCrack(values_[begin],crack)){
+				++begin;
+			}else{
+				--end;
+				//no std::swap, the elements of a std::vector<bool> are proxies
+				T value=values_[begin];
+				values_[begin]=values_[end];
+				values_[end]=value;
+				std::swap(tids_[begin],tids_[end]);
+			}
+		}
+		cracks_.insert(next_crack,std::make_pair(crack,begin));
+		return begin;
+	}
+
+	template<class T>
+	const PositionListPtr CrackerIndex<T>::lookup(const T* lower, bool lower_inclusive, const T* upper, bool upper_inclusive){
+		std::lock_guard<std::mutex> lock(mutex_);
+		//v>=lower starts after the entries lesser than lower, v>lower after the entries lesser or equal to lower
+		TID begin=lower ? crack(Crack(*lower,!lower_inclusive)) : 0;
+		TID end=upper ? crack(Crack(*upper,upper_inclusive)) : values_.size();
+		PositionListPtr tids(new PositionList());
+		if(begin>=end) return tids;
+		tids->assign(tids_.begin()+begin,tids_.begin()+end);
+		std::sort(tids->begin(),tids->end());
+		return tids;
+	}
+
+	template<class T>
+	size_t CrackerIndex<T>::getNumberOfPieces() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return cracks_.size()+1;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,39 @@
+#pragma once
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A small ring of values, which columns that do not store plain values of type T use to return a reference from operator[].
+ *  \details   store() copies a decoded value into the next slot of the ring and returns a reference to it. The reference stays valid for the
+ *  next number_of_slots-1 calls of store(), which is enough for the generic algorithms that compare a few values at a time.
+ */
+template<class T, unsigned int number_of_slots=8>
+class DecodeBuffer{
+	public:
+	DecodeBuffer();
+	T& store(const T& value);
+	private:
+	//a plain array, std::vector<bool> can not hand out references
+	T slots_[number_of_slots];
+	unsigned int next_slot_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T, unsigned int number_of_slots>
+	DecodeBuffer<T,number_of_slots>::DecodeBuffer() : slots_(), next_slot_(0){
+
+	}
+
+	template<class T, unsigned int number_of_slots>
+	T& DecodeBuffer<T,number_of_slots>::store(const T& value){
+		T& slot=slots_[next_slot_];
+		next_slot_=(next_slot_+1)%number_of_slots;
+		slot=value;
+		return slot;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     Epoch based memory reclamation for objects that are read without locks, e.g., the versions of a CoGaDB::VersionedColumn.
+ *  \details   A reader pins the current global epoch with a Guard before it loads a shared pointer and keeps the guard while it uses the object.
+ *  A writer that replaced an object hands the old one to retire(). Retired objects are deleted as soon as every thread that was pinned
+ *  when the object was retired has left its epoch. Pinning costs one store to a thread local slot and no reference counting, so scans
+ *  run at full speed. Guards nest and have to be destroyed by the thread that created them.
+ */
+class EpochManager{
+	public:
+	/*! \brief pins the current epoch for the calling thread while the guard exists*/
+	class Guard{
+		public:
+		explicit Guard(EpochManager& manager=EpochManager::instance());
+		~Guard();
+		private:
+		Guard(const Guard&);
+		Guard& operator=(const Guard&);
+		EpochManager& manager_;
+	};
+
+	static EpochManager& instance();
+
+	~EpochManager();
+
+	void enter();
+	void leave();
+
+	/*! \brief deletes object once no thread can hold a reference to it anymore*/
+	template<class Object>
+	void retire(Object* object);
+
+	/*! \brief deletes all retired objects that are no longer reachable by any pinned thread*/
+	void reclaim();
+
+	/*! \brief number of retired objects, which are still waiting for deletion*/
+	size_t getNumberOfRetiredObjects();
+
+	private:
+	/*! \brief maximal number of threads, which can be pinned at the same time*/
+	static const unsigned int max_number_of_threads_=256;
+	/*! \brief epoch of a thread that is not pinned*/
+	static const uint64_t inactive_=0;
+
+	struct alignas(64) Slot{
+		std::atomic<uint64_t> epoch;
+		std::atomic<bool> in_use;
+	};
+
+	/*! \brief per thread state, releases the thread's slot when the thread terminates*/
+	struct ThreadState{
+		ThreadState();
+		~ThreadState();
+		Slot* slot;
+		unsigned int nesting_depth;
+		private:
+		ThreadState(const ThreadState&);
+		ThreadState& operator=(const ThreadState&);
+	};
+
+	struct RetiredObject{
+		uint64_t epoch;
+		void* object;
+		void (*deleter)(void*);
+	};
+
+	template<class Object>
+	static void deleteObject(void* object);
+
+	EpochManager();
+	EpochManager(const EpochManager&);
+	EpochManager& operator=(const EpochManager&);
+
+	Slot* acquireSlot();
+	static ThreadState& getThreadState();
+
+	Slot slots_[max_number_of_threads_];
+	std::atomic<uint64_t> global_epoch_;
+	std::mutex retired_mutex_;
+	std::vector<RetiredObject> retired_objects_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline EpochManager::Guard::Guard(EpochManager& manager) : manager_(manager){
+		manager_.enter();
+	}
+
+	inline EpochManager::Guard::~Guard(){
+		manager_.leave();
+	}
+
+	inline EpochManager& EpochManager::instance(){
+		static EpochManager manager;
+		return manager;
+	}
+
+	inline EpochManager::EpochManager() : global_epoch_(1), retired_mutex_(), retired_objects_(){
+		for(unsigned int i=0;i<max_number_of_threads_;i++){
+			slots_[i].epoch.store(inactive_);
+			slots_[i].in_use.store(false);
+		}
+	}
+
+	inline EpochManager::~EpochManager(){
+		for(unsigned int i=0;i<retired_objects_.size();i++){
+			retired_objects_[i].deleter(retired_objects_[i].object);
+		}
+	}
+
+	inline EpochManager::ThreadState::ThreadState() : slot(NULL), nesting_depth(0){
+	}
+
+	inline EpochManager::ThreadState::~ThreadState(){
+		if(slot){
+			slot->epoch.store(inactive_);
+			slot->in_use.store(false);
+		}
+	}
+
+	inline EpochManager::ThreadState& EpochManager::getThreadState(){
+		static thread_local ThreadState state;
+		return state;
+	}
+
+	inline EpochManager::Slot* EpochManager::acquireSlot(){
+		while(true){
+			for(unsigned int i=0;i<max_number_of_threads_;i++){
+				bool in_use=false;
+				if(!slots_[i].in_use.load() && slots_[i].in_use.compare_exchange_strong(in_use,true)){
+					return &slots_[i];
+				}
+			}
+			//all slots are taken, wait for a thread to terminate
+			std::this_thread::yield();
+		}
+	}
+
+	inline void EpochManager::enter(){
+		ThreadState& state=getThreadState();
+		if(state.nesting_depth++>0) return;
+		if(!state.slot) state.slot=acquireSlot();
+		//announce the epoch before loading any shared pointer, the sequentially consistent store orders the two
+		state.slot->epoch.store(global_epoch_.load());
+	}
+
+	inline void EpochManager::leave(){
+		ThreadState& state=getThreadState();
+		if(--state.nesting_depth>0) return;
+		state.slot->epoch.store(inactive_,std::memory_order_release);
+	}
+
+	template<class Object>
+	void EpochManager::deleteObject(void* object){
+		delete static_cast<Object*>(object);
+	}
+
+	template<class Object>
+	void EpochManager::retire(Object* object){
+		if(!object) return;
+		{
+			std::lock_guard<std::mutex> lock(retired_mutex_);
+			RetiredObject retired_object={global_epoch_.fetch_add(1),object,&EpochManager::deleteObject<Object>};
+			retired_objects_.push_back(retired_object);
+		}
+		reclaim();
+	}
+
+	inline void EpochManager::reclaim(){
+		uint64_t oldest_pinned_epoch=global_epoch_.load();
+		for(unsigned int i=0;i<max_number_of_threads_;i++){
+			uint64_t epoch=slots_[i].epoch.load();
+			if(epoch!=inactive_ && epoch<oldest_pinned_epoch) oldest_pinned_epoch=epoch;
+		}
+		std::vector<RetiredObject> reclaimable_objects;
+		{
+			std::lock_guard<std::mutex> lock(retired_mutex_);
+			std::vector<RetiredObject> remaining_objects;
+			for(unsigned int i=0;i<retired_objects_.size();i++){
+				//a thread pinned in the retire epoch or earlier may still hold a reference
+				if(retired_objects_[i].epoch<oldest_pinned_epoch){
+					reclaimable_objects.push_back(retired_objects_[i]);
+				}else{
+					remaining_objects.push_back(retired_objects_[i]);
+				}
+			}
+			retired_objects_.swap(remaining_objects);
+		}
+		for(unsigned int i=0;i<reclaimable_objects.size();i++){
+			reclaimable_objects[i].deleter(reclaimable_objects[i].object);
+		}
+	}
+
+	inline size_t EpochManager::getNumberOfRetiredObjects(){
+		std::lock_guard<std::mutex> lock(retired_mutex_);
+		return retired_objects_.size();
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
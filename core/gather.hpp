@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <core/global_definitions.hpp>
+#include <core/parallel.hpp>
+
+namespace CoGaDB{
+
+	/*! \brief number of rows, which the gather loops prefetch ahead*/
+	const size_t gather_prefetch_distance=16;
+
+	/*! \brief writes values[tids[i]] to output[i] for all i<number_of_tids
+	 *  \details Random accesses into a large array stall on every cache miss. The loop prefetches the value gather_prefetch_distance rows ahead,
+	 *  so several misses are in flight at the same time. Fixed width types use AVX2 gather instructions, if the CPU supports AVX2. The AVX2
+	 *  loops are compiled for AVX2 with a target attribute, independent of the flags of the build, and only called after a check of the CPU.
+	 */
+	template<class T>
+	void gatherValues(const T* values, const TID* tids, size_t number_of_tids, T* output);
+
+	/*! \brief the prefetching loop of gatherValues() without SIMD instructions*/
+	template<class T>
+	inline void gatherScalarValues(const T* values, const TID* tids, size_t number_of_tids, T* output){
+		size_t i=0;
+		for(;i+gather_prefetch_distance<number_of_tids;i++){
+			__builtin_prefetch(&values[tids[i+gather_prefetch_distance]]);
+			output[i]=values[tids[i]];
+		}
+		for(;i<number_of_tids;i++){
+			output[i]=values[tids[i]];
+		}
+	}
+
+	template<class T>
+	void gatherValues(const T* values, const TID* tids, size_t number_of_tids, T* output){
+		gatherScalarValues(values,tids,number_of_tids,output);
+	}
+
+#if defined(__x86_64__)
+	/*! \brief gathers four 32 bit values per instruction, returns the number of gathered values, the caller copies the rest, requires AVX2*/
+	__attribute__((target("avx2"))) inline size_t gatherValues32(const void* values, const TID* tids, size_t number_of_tids, void* output){
+		size_t i=0;
+		for(;i+4+gather_prefetch_distance<=number_of_tids;i+=4){
+			for(size_t j=0;j<4;j++) __builtin_prefetch(static_cast<const int32_t*>(values)+tids[i+gather_prefetch_distance+j]);
+			__m256i indices=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tids[i]));
+			__m128i gathered_values=_mm256_i64gather_epi32(static_cast<const int*>(values),indices,4);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<int32_t*>(output)+i),gathered_values);
+		}
+		return i;
+	}
+
+	/*! \brief gathers four 64 bit values per instruction, returns the number of gathered values, the caller copies the rest, requires AVX2*/
+	__attribute__((target("avx2"))) inline size_t gatherValues64(const void* values, const TID* tids, size_t number_of_tids, void* output){
+		size_t i=0;
+		for(;i+4+gather_prefetch_distance<=number_of_tids;i+=4){
+			for(size_t j=0;j<4;j++) __builtin_prefetch(static_cast<const int64_t*>(values)+tids[i+gather_prefetch_distance+j]);
+			__m256i indices=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tids[i]));
+			__m256i gathered_values=_mm256_i64gather_epi64(static_cast<const long long*>(values),indices,8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(static_cast<int64_t*>(output)+i),gathered_values);
+		}
+		return i;
+	}
+
+	template<>
+	inline void gatherValues<int>(const int* values, const TID* tids, size_t number_of_tids, int* output){
+		size_t i=hasAVX2() ? gatherValues32(values,tids,number_of_tids,output) : 0;
+		gatherScalarValues(values,tids+i,number_of_tids-i,output+i);
+	}
+
+	template<>
+	inline void gatherValues<float>(const float* values, const TID* tids, size_t number_of_tids, float* output){
+		size_t i=hasAVX2() ? gatherValues32(values,tids,number_of_tids,output) : 0;
+		gatherScalarValues(values,tids+i,number_of_tids-i,output+i);
+	}
+
+	template<>
+	inline void gatherValues<double>(const double* values, const TID* tids, size_t number_of_tids, double* output){
+		size_t i=hasAVX2() ? gatherValues64(values,tids,number_of_tids,output) : 0;
+		gatherScalarValues(values,tids+i,number_of_tids-i,output+i);
+	}
+
+	template<>
+	inline void gatherValues<TID>(const TID* values, const TID* tids, size_t number_of_tids, TID* output){
+		size_t i=hasAVX2() ? gatherValues64(values,tids,number_of_tids,output) : 0;
+		gatherScalarValues(values,tids+i,number_of_tids-i,output+i);
+	}
+#endif
+
+}; //end namespace CogaDB
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <vector>
 #include <list>
 #include <map>
@@ -21,12 +22,16 @@ enum AggregationMethod{SUM,MIN,MAX};
 
 enum ValueComparator{LESSER,GREATER,EQUAL};
 
+enum ArithmeticOperator{ADDITION,SUBTRACTION,MULTIPLICATION,DIVISION};
+
 enum SortOrder{ASCENDING,DESCENDING};
 
 enum Operation{SELECTION,PROJECTION,JOIN,GROUPBY,SORT,COPY,AGGREGATION,FULL_SCAN,INDEX_SCAN};
 
 enum JoinAlgorithm{SORT_MERGE_JOIN,NESTED_LOOP_JOIN,HASH_JOIN};
 
+enum IndexType{HASH_INDEX,BPLUS_TREE_INDEX,CRACKER_INDEX};
+
 enum MaterializationStatus{MATERIALIZE,LOOKUP};
 
 enum ParallelizationMode{SERIAL,PARALLEL};
@@ -43,7 +48,7 @@ enum DebugMode{quiet=1,
 //					verbose=1,
 //					debug=1};
 
-typedef unsigned int TID;
+typedef uint64_t TID;
 
 typedef std::pair<TID,TID> TID_Pair;
 
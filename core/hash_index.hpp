@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <boost/functional/hash.hpp>
+
+#include <core/column_index.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A secondary index for equality predicates, which stores its entries in an open addressing hash table with linear probing.
+ *  \details   Every distinct value has one slot, which keeps the TIDs of its rows sorted ascending, so duplicates neither lengthen the probe
+ *  sequences nor have to be sorted by a lookup. A lookup reads a few adjacent slots instead of following pointers. The slot of a value, whose
+ *  last entry was removed, becomes a tombstone, which is reused by later inserts. The table doubles, when more than half of its slots are used.
+ */
+template<class T>
+class HashIndex : public ColumnIndex<T>{
+	public:
+	typedef typename ColumnIndex<T>::ColumnIndexPtr ColumnIndexPtr;
+
+	HashIndex();
+
+	virtual IndexType getIndexType() const throw();
+	virtual void insert(const T& value, TID tid);
+	virtual void remove(const T& value, TID tid);
+	virtual void renumber(const PositionList& removed_tids);
+	/*! \brief erases the removed TIDs of every value in one pass over the TIDs of its slot, instead of one erase per removed row*/
+	virtual void removeRows(const std::vector<T>& values, const PositionList& removed_tids);
+	virtual void clear();
+	virtual void getEntries(std::vector<T>& values, PositionList& tids) const;
+	virtual ColumnIndexPtr clone() const;
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	/*! \brief returns the TIDs of all rows with value, sorted ascending*/
+	const PositionListPtr lookup(const T& value) const;
+
+	private:
+	enum SlotState{EMPTY_SLOT,USED_SLOT,DELETED_SLOT};
+	struct Slot{
+		Slot() : value(), tids(), state(EMPTY_SLOT){}
+		T value;
+		/*! TIDs of the rows with value, sorted ascending*/
+		PositionList tids;
+		unsigned char state;
+	};
+
+	size_t getFirstSlot(const T& value) const;
+	/*! \brief returns the slot of value, or the slot, in which value is inserted, if it has none, requires a table with an empty slot*/
+	size_t findSlot(const T& value) const;
+	void rehash(size_t number_of_slots);
+
+	std::vector<Slot> slots_;
+	size_t number_of_entries_;
+	/*! number of distinct values, which have a slot*/
+	size_t number_of_values_;
+	/*! number of slots, which are not empty, including tombstones*/
+	size_t number_of_used_slots_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	HashIndex<T>::HashIndex() : ColumnIndex<T>(), slots_(), number_of_entries_(0), number_of_values_(0), number_of_used_slots_(0){
+
+	}
+
+	template<class T>
+	IndexType HashIndex<T>::getIndexType() const throw(){
+		return HASH_INDEX;
+	}
+
+	template<class T>
+	size_t HashIndex<T>::getFirstSlot(const T& value) const{
+		//the number of slots is a power of two
+		return boost::hash<T>()(value) & (slots_.size()-1);
+	}
+
+	template<class T>
+	size_t HashIndex<T>::findSlot(const T& value) const{
+		size_t free_slot=slots_.size();
+		for(size_t slot=getFirstSlot(value);;slot=(slot+1) & (slots_.size()-1)){
+			if(slots_[slot].state==EMPTY_SLOT) return free_slot<slots_.size() ? free_slot : slot;
+			if(slots_[slot].state==DELETED_SLOT){
+				if(free_slot==slots_.size()) free_slot=slot;
+			}else if(slots_[slot].value==value){
+				return slot;
+			}
+		}
+	}
+
+	template<class T>
+	void HashIndex<T>::rehash(size_t number_of_slots){
+		std::vector<Slot> old_slots(number_of_slots);
+		old_slots.swap(slots_);
+		number_of_used_slots_=0;
+		//every value has one slot, so the TID lists move without probing for duplicates
+		for(size_t i=0;i<old_slots.size();i++){
+			if(old_slots[i].state!=USED_SLOT) continue;
+			size_t slot=getFirstSlot(old_slots[i].value);
+			while(slots_[slot].state!=EMPTY_SLOT){
+				slot=(slot+1) & (slots_.size()-1);
+			}
+			slots_[slot].value=old_slots[i].value;
+			slots_[slot].tids.swap(old_slots[i].tids);
+			slots_[slot].state=USED_SLOT;
+			++number_of_used_slots_;
+		}
+	}
+
+	template<class T>
+	void HashIndex<T>::insert(const T& value, TID tid){
+		if(2*(number_of_used_slots_+1)>slots_.size()){
+			//grow only, if the values fill the table, otherwise rehashing just drops the tombstones
+			size_t number_of_slots=std::max(size_t(16),slots_.size());
+			while(4*(number_of_values_+1)>number_of_slots) number_of_slots*=2;
+			rehash(number_of_slots);
+		}
+		Slot& slot=slots_[findSlot(value)];
+		if(slot.state!=USED_SLOT){
+			if(slot.state==EMPTY_SLOT) ++number_of_used_slots_;
+			slot.value=value;
+			slot.state=USED_SLOT;
+			++number_of_values_;
+		}
+		//rows are appended with ascending TIDs, only updates insert in the middle
+		if(slot.tids.empty() || slot.tids.back()<tid){
+			slot.tids.push_back(tid);
+		}else{
+			slot.tids.insert(std::lower_bound(slot.tids.begin(),slot.tids.end(),tid),tid);
+		}
+		++number_of_entries_;
+	}
+
+	template<class T>
+	void HashIndex<T>::remove(const T& value, TID tid){
+		if(slots_.empty()) return;
+		Slot& slot=slots_[findSlot(value)];
+		if(slot.state!=USED_SLOT) return;
+		PositionList::iterator it=std::lower_bound(slot.tids.begin(),slot.tids.end(),tid);
+		if(it==slot.tids.end() || *it!=tid) return;
+		slot.tids.erase(it);
+		--number_of_entries_;
+		if(slot.tids.empty()){
+			PositionList().swap(slot.tids);
+			slot.state=DELETED_SLOT;
+			--number_of_values_;
+		}
+	}
+
+	template<class T>
+	void HashIndex<T>::renumber(const PositionList& removed_tids){
+		for(size_t i=0;i<slots_.size();i++){
+			if(slots_[i].state!=USED_SLOT) continue;
+			//renumbering keeps the order of the TIDs
+			for(size_t j=0;j<slots_[i].tids.size();j++){
+				slots_[i].tids[j]=ColumnIndex<T>::renumberTID(slots_[i].tids[j],removed_tids);
+			}
+		}
+	}
+
+	template<class T>
+	void HashIndex<T>::removeRows(const std::vector<T>& values, const PositionList& removed_tids){
+		if(slots_.empty()) return;
+		//(slot,tid) pairs of the removed entries, sorted, so the removed TIDs of a slot are adjacent and ascending
+		std::vector<std::pair<size_t,TID> > removed_entries;
+		removed_entries.reserve(removed_tids.size());
+		for(size_t i=0;i<removed_tids.size();i++){
+			size_t slot=findSlot(values[i]);
+			if(slots_[slot].state==USED_SLOT) removed_entries.push_back(std::make_pair(slot,removed_tids[i]));
+		}
+		std::sort(removed_entries.begin(),removed_entries.end());
+		size_t begin=0;
+		while(begin<removed_entries.size()){
+			Slot& slot=slots_[removed_entries[begin].first];
+			size_t end=begin;
+			while(end<removed_entries.size() && removed_entries[end].first==removed_entries[begin].first) ++end;
+			//both TID lists are sorted ascending, so they are merged
+			PositionList::iterator write=slot.tids.begin();
+			size_t removed=begin;
+			for(PositionList::iterator read=slot.tids.begin();read!=slot.tids.end();++read){
+				while(removed<end && removed_entries[removed].second<*read) ++removed;
+				if(removed<end && removed_entries[removed].second==*read) continue;
+				*write++=*read;
+			}
+			number_of_entries_-=slot.tids.end()-write;
+			slot.tids.erase(write,slot.tids.end());
+			if(slot.tids.empty()){
+				PositionList().swap(slot.tids);
+				slot.state=DELETED_SLOT;
+				--number_of_values_;
+			}
+			begin=end;
+		}
+		renumber(removed_tids);
+	}
+
+	template<class T>
+	void HashIndex<T>::clear(){
+		slots_.clear();
+		number_of_entries_=0;
+		number_of_values_=0;
+		number_of_used_slots_=0;
+	}
+
+	template<class T>
+	void HashIndex<T>::getEntries(std::vector<T>& values, PositionList& tids) const{
+		for(size_t i=0;i<slots_.size();i++){
+			if(slots_[i].state==USED_SLOT){
+				values.insert(values.end(),slots_[i].tids.size(),slots_[i].value);
+				tids.insert(tids.end(),slots_[i].tids.begin(),slots_[i].tids.end());
+			}
+		}
+	}
+
+	template<class T>
+	typename HashIndex<T>::ColumnIndexPtr HashIndex<T>::clone() const{
+		return ColumnIndexPtr(new HashIndex<T>(*this));
+	}
+
+	template<class T>
+	size_t HashIndex<T>::size() const throw(){
+		return number_of_entries_;
+	}
+
+	template<class T>
+	size_t HashIndex<T>::getSizeinBytes() const throw(){
+		size_t size_in_bytes=slots_.capacity()*sizeof(Slot);
+		for(size_t i=0;i<slots_.size();i++){
+			size_in_bytes+=slots_[i].tids.capacity()*sizeof(TID);
+		}
+		return size_in_bytes;
+	}
+
+	template<class T>
+	const PositionListPtr HashIndex<T>::lookup(const T& value) const{
+		if(slots_.empty()) return PositionListPtr(new PositionList());
+		const Slot& slot=slots_[findSlot(value)];
+		if(slot.state!=USED_SLOT) return PositionListPtr(new PositionList());
+		return PositionListPtr(new PositionList(slot.tids));
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A minimal io_uring submission and completion queue for asynchronous reads, which uses the system calls directly, so no liburing
+ *  is needed.
+ *  \details   isAvailable() is false, if the kernel does not support io_uring or a seccomp filter blocks it, the caller then has to read
+ *  synchronously. The ring is not thread safe, one thread submits and reaps.
+ */
+class IOUring{
+	public:
+	explicit IOUring(unsigned int number_of_entries);
+	~IOUring();
+
+	bool isAvailable() const throw();
+	/*! \brief number of reads, which can be queued at most*/
+	unsigned int getNumberOfEntries() const throw();
+	/*! \brief queues a read of the buffer iov from offset of file descriptor fd, iov has to stay valid until the read completed
+	 *  \return false, if the submission queue is full*/
+	bool prepareRead(int fd, const struct iovec* iov, uint64_t offset, uint64_t user_data);
+	/*! \brief submits all queued reads and waits until at least min_complete reads completed*/
+	bool submitAndWait(unsigned int min_complete);
+	/*! \brief takes one completion from the completion queue
+	 *  \return false, if the completion queue is empty*/
+	bool popCompletion(uint64_t& user_data, int& result);
+
+	private:
+	IOUring(const IOUring&);
+	IOUring& operator=(const IOUring&);
+
+	int ring_fd_;
+	unsigned int number_of_entries_;
+	/*! number of reads, which were queued but not yet submitted*/
+	unsigned int number_of_queued_reads_;
+	void* sq_ring_;
+	size_t sq_ring_size_;
+	void* cq_ring_;
+	size_t cq_ring_size_;
+	struct io_uring_sqe* sqes_;
+	size_t sqes_size_;
+	unsigned int* sq_tail_;
+	unsigned int* sq_mask_;
+	unsigned int* sq_array_;
+	unsigned int* cq_head_;
+	unsigned int* cq_tail_;
+	unsigned int* cq_mask_;
+	struct io_uring_cqe* cqes_;
+	unsigned int* sq_head_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline IOUring::IOUring(unsigned int number_of_entries) : ring_fd_(-1), number_of_entries_(0), number_of_queued_reads_(0), sq_ring_(MAP_FAILED),
+		sq_ring_size_(0), cq_ring_(MAP_FAILED), cq_ring_size_(0), sqes_(NULL), sqes_size_(0), sq_tail_(NULL), sq_mask_(NULL), sq_array_(NULL),
+		cq_head_(NULL), cq_tail_(NULL), cq_mask_(NULL), cqes_(NULL), sq_head_(NULL){
+		struct io_uring_params params;
+		std::memset(&params,0,sizeof(params));
+		ring_fd_=syscall(__NR_io_uring_setup,number_of_entries,&params);
+		if(ring_fd_<0) return;
+		sq_ring_size_=params.sq_off.array+params.sq_entries*sizeof(unsigned int);
+		cq_ring_size_=params.cq_off.cqes+params.cq_entries*sizeof(struct io_uring_cqe);
+		if(params.features & IORING_FEAT_SINGLE_MMAP){
+			if(cq_ring_size_>sq_ring_size_) sq_ring_size_=cq_ring_size_;
+			cq_ring_size_=sq_ring_size_;
+		}
+		sq_ring_=mmap(NULL,sq_ring_size_,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,ring_fd_,IORING_OFF_SQ_RING);
+		if(params.features & IORING_FEAT_SINGLE_MMAP){
+			cq_ring_=sq_ring_;
+		}else{
+			cq_ring_=mmap(NULL,cq_ring_size_,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,ring_fd_,IORING_OFF_CQ_RING);
+		}
+		sqes_size_=params.sq_entries*sizeof(struct io_uring_sqe);
+		void* sqes=mmap(NULL,sqes_size_,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,ring_fd_,IORING_OFF_SQES);
+		if(sq_ring_==MAP_FAILED || cq_ring_==MAP_FAILED || sqes==MAP_FAILED){
+			if(sqes!=MAP_FAILED) munmap(sqes,sqes_size_);
+			sqes_size_=0;
+			return;
+		}
+		sqes_=static_cast<struct io_uring_sqe*>(sqes);
+		char* sq_ring=static_cast<char*>(sq_ring_);
+		char* cq_ring=static_cast<char*>(cq_ring_);
+		sq_head_=reinterpret_cast<unsigned int*>(sq_ring+params.sq_off.head);
+		sq_tail_=reinterpret_cast<unsigned int*>(sq_ring+params.sq_off.tail);
+		sq_mask_=reinterpret_cast<unsigned int*>(sq_ring+params.sq_off.ring_mask);
+		sq_array_=reinterpret_cast<unsigned int*>(sq_ring+params.sq_off.array);
+		cq_head_=reinterpret_cast<unsigned int*>(cq_ring+params.cq_off.head);
+		cq_tail_=reinterpret_cast<unsigned int*>(cq_ring+params.cq_off.tail);
+		cq_mask_=reinterpret_cast<unsigned int*>(cq_ring+params.cq_off.ring_mask);
+		cqes_=reinterpret_cast<struct io_uring_cqe*>(cq_ring+params.cq_off.cqes);
+		number_of_entries_=params.sq_entries;
+	}
+
+	inline IOUring::~IOUring(){
+		if(sqes_) munmap(sqes_,sqes_size_);
+		if(cq_ring_!=MAP_FAILED && cq_ring_!=sq_ring_) munmap(cq_ring_,cq_ring_size_);
+		if(sq_ring_!=MAP_FAILED) munmap(sq_ring_,sq_ring_size_);
+		if(ring_fd_>=0) close(ring_fd_);
+	}
+
+	inline bool IOUring::isAvailable() const throw(){
+		return sqes_!=NULL;
+	}
+
+	inline unsigned int IOUring::getNumberOfEntries() const throw(){
+		return number_of_entries_;
+	}
+
+	inline bool IOUring::prepareRead(int fd, const struct iovec* iov, uint64_t offset, uint64_t user_data){
+		unsigned int tail=*sq_tail_;
+		//the kernel advances the head, when it consumed a submission
+		unsigned int head=__atomic_load_n(sq_head_,__ATOMIC_ACQUIRE);
+		if(tail+number_of_queued_reads_-head>=number_of_entries_) return false;
+		unsigned int index=(tail+number_of_queued_reads_) & *sq_mask_;
+		struct io_uring_sqe* sqe=&sqes_[index];
+		std::memset(sqe,0,sizeof(*sqe));
+		sqe->opcode=IORING_OP_READV;
+		sqe->fd=fd;
+		sqe->addr=reinterpret_cast<uint64_t>(iov);
+		sqe->len=1;
+		sqe->off=offset;
+		sqe->user_data=user_data;
+		sq_array_[index]=index;
+		++number_of_queued_reads_;
+		return true;
+	}
+
+	inline bool IOUring::submitAndWait(unsigned int min_complete){
+		unsigned int number_of_reads=number_of_queued_reads_;
+		//publish the queued submissions, the release store orders the writes to the entries before the new tail
+		__atomic_store_n(sq_tail_,*sq_tail_+number_of_reads,__ATOMIC_RELEASE);
+		number_of_queued_reads_=0;
+		int result=syscall(__NR_io_uring_enter,ring_fd_,number_of_reads,min_complete,IORING_ENTER_GETEVENTS,NULL,0);
+		return result>=0;
+	}
+
+	inline bool IOUring::popCompletion(uint64_t& user_data, int& result){
+		unsigned int head=*cq_head_;
+		if(head==__atomic_load_n(cq_tail_,__ATOMIC_ACQUIRE)) return false;
+		const struct io_uring_cqe& cqe=cqes_[head & *cq_mask_];
+		user_data=cqe.user_data;
+		result=cqe.res;
+		__atomic_store_n(cq_head_,head+1,__ATOMIC_RELEASE);
+		return true;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -1,10 +1,12 @@
 
 #pragma once
 
+#include <cassert>
+
 #include <core/column_base_typed.hpp>
 #include <core/column.hpp>
-#include <lookup_table/lookup_column.hpp>
-#include <core/base_table.hpp>
+#include <core/bit_packed_column.hpp>
+#include <core/gather.hpp>
 
 namespace CoGaDB{
 
@@ -14,12 +16,28 @@ namespace CoGaDB{
  *  \brief     A LookupArray is a LookupColumn which is applied on a materialized column (of the table that is indexed by the Lookup column) and hence has a Type. 
  * 				This class represents a column with type T, which is essentially a tid list describing which values of a typed materialized column are included in the LookupArray.
  *  \details   This class is indentended to be a base class, so it has a virtual destruktor and pure virtual methods, which need to be implemented in a derived class. 
+ * 				A LookupArray on a LookupArray resolves every access through both TID lists. flatten() composes the chain into a single TID list
+ * 				on the materialized column and materialize() copies the values into a new column with a batched gather.
+ * 				A LookupArray is a read only view on an intermediate result: insert(), update() and the arithmetic operations reject the
+ * 				modification and return false, instead of writing through to the source column, which belongs to another table. Materialize the
+ * 				LookupArray first to modify its values. remove() only removes rows from the view.
  *  \author    Sebastian Breß
  *  \version   0.2
  *  \date      2013
  *  \copyright GNU LESSER GENERAL PUBLIC LICENSE - Version 3, http://www.gnu.org/licenses/lgpl-3.0.txt
  */	
 
+/*! \brief type of the column, into which a LookupArray<T> materializes its values*/
+template<class T>
+struct MaterializedColumnType{
+	typedef Column<T> type;
+};
+
+template<>
+struct MaterializedColumnType<bool>{
+	typedef BitPackedColumn type;
+};
+
 template<class T>
 class LookupArray : public ColumnBaseTyped<T>{
 	public:
@@ -31,6 +49,14 @@ class LookupArray : public ColumnBaseTyped<T>{
 	virtual bool insert(const T& new_Value);
 	virtual bool update(TID tid, const boost::any& new_value);
 	virtual bool update(PositionListPtr tid, const boost::any& new_value);	
+	virtual bool add(const boost::any& new_value);
+	virtual bool add(ColumnPtr column);
+	virtual bool minus(const boost::any& new_value);
+	virtual bool minus(ColumnPtr column);
+	virtual bool multiply(const boost::any& new_value);
+	virtual bool multiply(ColumnPtr column);
+	virtual bool division(const boost::any& new_value);
+	virtual bool division(ColumnPtr column);
 	
 	virtual bool remove(TID tid);
 	//assumes tid list is sorted ascending
@@ -41,7 +67,7 @@ class LookupArray : public ColumnBaseTyped<T>{
 	//virtual const boost::any* const getRawData()=0;
 	virtual void print() const throw();
 	virtual size_t size() const throw();
-	virtual unsigned int getSizeinBytes() const throw();
+	virtual size_t getSizeinBytes() const throw();
 
 	virtual const ColumnPtr copy() const;
 
@@ -50,8 +76,23 @@ class LookupArray : public ColumnBaseTyped<T>{
 	virtual bool isMaterialized() const  throw();
 	virtual bool isCompressed() const  throw();		
 	/*! \brief returns type information of internal values*/
-	virtual T& operator[](const int index);
+	virtual T getValue(TID tid);
+	virtual T& operator[](const TID index);
+	virtual void gather(const PositionList& tids, T* output);
+
+	/*! \brief returns a LookupArray with the same values, which references the materialized column directly*/
+	const shared_pointer_namespace::shared_ptr<LookupArray<T> > flatten() const;
+	/*! \brief copies the values into a new column*/
+	const shared_pointer_namespace::shared_ptr<typename MaterializedColumnType<T>::type> materialize() const;
+
+	const ColumnPtr getSourceColumn() const;
+	const PositionListPtr getPositionList() const;
 	private:
+	/*! \brief copies the TID list before it is modified, if another LookupArray shares it*/
+	void detachPositionList();
+	/*! \brief reports that the values of the view can not be modified and returns false*/
+	bool rejectModification() const;
+
 	shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > column_;
 	PositionListPtr tids_;
 };
@@ -79,38 +120,103 @@ class LookupArray : public ColumnBaseTyped<T>{
 	}
 
 	template<class T>
-	bool LookupArray<T>::insert(const boost::any& ){
+	void LookupArray<T>::detachPositionList(){
+		if(!tids_.unique()){
+			tids_=PositionListPtr(new PositionList(*tids_));
+		}
+	}
+
+	template<class T>
+	bool LookupArray<T>::rejectModification() const{
+		std::cout << "Fatal Error! LookupArray " << this->name_ << " is a read only view on column " << column_->getName()
+			<< ", materialize it before modifying its values" << std::endl;
 		return false;
 	}
+
+	//a LookupArray is a view on an intermediate result, the values of the source column are not modified through it
+	template<class T>
+	bool LookupArray<T>::insert(const boost::any&){
+		return rejectModification();
+	}
 	template<class T>
 	bool LookupArray<T>::insert(const T&){
-		return false;
+		return rejectModification();
 	}
 	template<class T>
-	bool LookupArray<T>::update(TID , const boost::any& ){
-		return  false;
+	bool LookupArray<T>::update(TID, const boost::any&){
+		return rejectModification();
 	}
 
 	template<class T>
 	bool LookupArray<T>::update(PositionListPtr, const boost::any&){
-		return  false;			
+		return rejectModification();
 	}
-	
+
 	template<class T>
-	bool LookupArray<T>::remove(TID ){
+	bool LookupArray<T>::add(const boost::any&){
+		return rejectModification();
+	}
 
-		return false;
+	template<class T>
+	bool LookupArray<T>::add(ColumnPtr){
+		return rejectModification();
+	}
+
+	template<class T>
+	bool LookupArray<T>::minus(const boost::any&){
+		return rejectModification();
+	}
+
+	template<class T>
+	bool LookupArray<T>::minus(ColumnPtr){
+		return rejectModification();
+	}
+
+	template<class T>
+	bool LookupArray<T>::multiply(const boost::any&){
+		return rejectModification();
+	}
+
+	template<class T>
+	bool LookupArray<T>::multiply(ColumnPtr){
+		return rejectModification();
+	}
+
+	template<class T>
+	bool LookupArray<T>::division(const boost::any&){
+		return rejectModification();
+	}
+
+	template<class T>
+	bool LookupArray<T>::division(ColumnPtr){
+		return rejectModification();
+	}
+	
+	//removing rows only removes them from the view, the source column is not changed
+	template<class T>
+	bool LookupArray<T>::remove(TID tid){
+		if(tid>=tids_->size()) return false;
+		detachPositionList();
+		tids_->erase(tids_->begin()+tid);
+		return true;
 	}
 	
 	//assumes tid list is sorted ascending
 	template<class T>
-	bool LookupArray<T>::remove(PositionListPtr){
-		return false;
+	bool LookupArray<T>::remove(PositionListPtr tids){
+		if(!tids || tids->empty()) return false;
+		detachPositionList();
+		for(PositionList::reverse_iterator rit=tids->rbegin();rit!=tids->rend();++rit){
+			if(*rit>=tids_->size()) return false;
+			tids_->erase(tids_->begin()+(*rit));
+		}
+		return true;
 	}
 
 	template<class T>
 	bool LookupArray<T>::clearContent(){
-		return false;
+		tids_=PositionListPtr(new PositionList());
+		return true;
 	}
 	
 	template<class T>
@@ -131,7 +237,7 @@ class LookupArray : public ColumnBaseTyped<T>{
 			std::cout << "which is a LookupArray of a Lookup column" << std::endl;
 		}
 		std::cout << "| values | Translatetion TIDS | Index in Lookup Table |" << std::endl;
-		for(unsigned int i=0;i<tids->size();i++){
+		for(size_t i=0;i<tids->size();i++){
 			std::cout << "| " << (*column_)[(*tids_)[i]] << " | " << (*tids_)[i] << " | " << i << " |" << std::endl;
 		}
 
@@ -167,13 +273,22 @@ class LookupArray : public ColumnBaseTyped<T>{
 //	const std::vector<TID_Pair> LookupArray<T>::nested_loop_join(ColumnPtr join_LookupArray, const ComputeDevice comp_dev) const{
 //		return false;
 //	}
+	//a LookupArray is stored as the column it materializes to, load() restores it as a LookupArray on this column
 	template<class T>
-	bool LookupArray<T>::store(const std::string&){
-		return false;
+	bool LookupArray<T>::store(const std::string& path){
+		return materialize()->store(path);
 	}
 	template<class T>
-	bool LookupArray<T>::load(const std::string&){
-		return false;
+	bool LookupArray<T>::load(const std::string& path){
+		shared_pointer_namespace::shared_ptr<typename MaterializedColumnType<T>::type> column(new typename MaterializedColumnType<T>::type(this->name_,this->db_type_));
+		if(!column->load(path)) return false;
+		PositionListPtr tids(new PositionList(column->size()));
+		for(TID i=0;i<tids->size();i++){
+			(*tids)[i]=i;
+		}
+		column_=column;
+		tids_=tids;
+		return true;
 	}
 	template<class T>
 	bool LookupArray<T>::isMaterialized() const  throw(){
@@ -184,12 +299,73 @@ class LookupArray : public ColumnBaseTyped<T>{
 		return false;
 	}
 	template<class T>
-	T& LookupArray<T>::operator[](const int index){
+	T LookupArray<T>::getValue(TID tid){
+		return column_->getValue((*tids_)[tid]);
+	}
+
+	template<class T>
+	T& LookupArray<T>::operator[](const TID index){
 		return (*column_)[(*tids_)[index]];
 	}
 
 	template<class T>
-	unsigned int LookupArray<T>::getSizeinBytes() const throw(){
+	void LookupArray<T>::gather(const PositionList& tids, T* output){
+		//translate the TIDs into TIDs of the source column and let the source gather in one batch
+		PositionList source_tids(tids.size());
+		gatherValues(tids_->data(),tids.data(),tids.size(),source_tids.data());
+		column_->gather(source_tids,output);
+	}
+
+	template<class T>
+	const shared_pointer_namespace::shared_ptr<LookupArray<T> > LookupArray<T>::flatten() const{
+		typedef shared_pointer_namespace::shared_ptr<LookupArray<T> > LookupArrayPtr;
+		const LookupArray<T>* lookup_array=dynamic_cast<const LookupArray<T>*>(column_.get());
+		if(!lookup_array){
+			return LookupArrayPtr(new LookupArray<T>(this->name_,this->db_type_,column_,tids_));
+		}
+		//compose the TID lists from the source column on, tids[i]=inner_tids[tids_[i]]
+		LookupArrayPtr inner=lookup_array->flatten();
+		PositionListPtr tids(new PositionList(tids_->size()));
+		gatherValues(inner->tids_->data(),tids_->data(),tids_->size(),tids->data());
+		return LookupArrayPtr(new LookupArray<T>(this->name_,this->db_type_,inner->column_,tids));
+	}
+
+	/*! \brief appends the values of source on the positions tids to target*/
+	template<class T>
+	void gatherInto(ColumnBaseTyped<T>& source, const PositionList& tids, Column<T>& target){
+		size_t size=target.size();
+		target.getContent().resize(size+tids.size());
+		source.gather(tids,target.getContent().data()+size);
+	}
+
+	inline void gatherInto(ColumnBaseTyped<bool>& source, const PositionList& tids, BitPackedColumn& target){
+		//std::vector<bool> has no contiguous storage, so the bits are appended one by one
+		for(size_t i=0;i<tids.size();i++){
+			target.insert(bool(source[tids[i]]));
+		}
+	}
+
+	template<class T>
+	const shared_pointer_namespace::shared_ptr<typename MaterializedColumnType<T>::type> LookupArray<T>::materialize() const{
+		typedef typename MaterializedColumnType<T>::type ColumnType;
+		shared_pointer_namespace::shared_ptr<LookupArray<T> > lookup_array=flatten();
+		shared_pointer_namespace::shared_ptr<ColumnType> column(new ColumnType(this->name_,this->db_type_));
+		gatherInto(*lookup_array->column_,*lookup_array->tids_,*column);
+		return column;
+	}
+
+	template<class T>
+	const ColumnPtr LookupArray<T>::getSourceColumn() const{
+		return column_;
+	}
+
+	template<class T>
+	const PositionListPtr LookupArray<T>::getPositionList() const{
+		return tids_;
+	}
+
+	template<class T>
+	size_t LookupArray<T>::getSizeinBytes() const throw(){
 		return tids_->capacity()*sizeof(typename PositionList::value_type);
 	}
 
@@ -0,0 +1,489 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <core/column_base_typed.hpp>
+#include <core/memory_manager.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *  \brief     A proxy of a typed column, whose memory is accounted by a CoGaDB::MemoryManager, which spills the column to disk, when the
+ *  memory budget is exceeded and this column is among the least recently used ones.
+ *  \details   A spilled column is written with store() to a subdirectory of the spill directory, which has to exist, and cleared. Every managed
+ *  column has its own subdirectory, so columns with the same name do not overwrite each other's files. The subdirectory is deleted with the
+ *  managed column. Every method reloads a spilled
+ *  column with load() before it forwards the call, so spilling is transparent to the caller. A column is not spilled while one of its
+ *  methods runs. References returned by operator[] stay valid until the column is spilled. A dictionary compressed column, which shares its
+ *  dictionary, gets a private dictionary on reload. copy() returns an unmanaged copy of the column.
+ */
+template<class T>
+class ManagedColumn : public ColumnBaseTyped<T>, public SpillableColumn{
+	public:
+	typedef shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > ColumnTypedPtr;
+
+	/*! \brief manages column, which is spilled to spill_path*/
+	ManagedColumn(ColumnTypedPtr column, const std::string& spill_path, MemoryManager& manager=MemoryManager::instance());
+	virtual ~ManagedColumn();
+
+	virtual bool insert(const boost::any& new_value);
+	virtual bool insert(const T& new_value);
+	virtual bool update(TID tid, const boost::any& new_value);
+	virtual bool update(PositionListPtr tids, const boost::any& new_value);
+	virtual bool update(TID tid, const T& new_value);
+	virtual bool remove(TID tid);
+	virtual bool remove(PositionListPtr tids);
+	virtual bool clearContent();
+
+	virtual const boost::any get(TID tid);
+	virtual T getValue(TID tid);
+	virtual void print() const throw();
+	virtual size_t size() const throw();
+	/*! \brief footprint of the column in main memory, 0 while it is spilled*/
+	virtual size_t getSizeinBytes() const throw();
+	virtual const ColumnPtr copy() const;
+
+	virtual const PositionListPtr sort(SortOrder order);
+	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+	virtual const PositionListPtr predicate_selection(const PredicateExpression<T>& predicate);
+	virtual const PositionListPtr parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads);
+	virtual const PositionListPairPtr hash_join(ColumnPtr join_column);
+	virtual const PositionListPairPtr sort_merge_join(ColumnPtr join_column);
+	virtual const PositionListPairPtr nested_loop_join(ColumnPtr join_column);
+	virtual const PositionListPairPtr join(ColumnPtr join_column);
+	virtual const typename ColumnStatistics<T>::ColumnStatisticsPtr getStatistics();
+
+	virtual bool add(const boost::any& new_value);
+	virtual bool add(ColumnPtr column);
+	virtual bool minus(const boost::any& new_value);
+	virtual bool minus(ColumnPtr column);
+	virtual bool multiply(const boost::any& new_value);
+	virtual bool multiply(ColumnPtr column);
+	virtual bool division(const boost::any& new_value);
+	virtual bool division(ColumnPtr column);
+
+	virtual bool store(const std::string& path);
+	virtual bool load(const std::string& path);
+	virtual bool isMaterialized() const throw();
+	virtual bool isCompressed() const throw();
+
+	virtual T& operator[](const TID index);
+	virtual void gather(const PositionList& tids, T* output);
+	virtual void decodeRange(TID begin, TID end, T* output);
+
+	virtual bool spill();
+	virtual uint64_t getLastAccess() const;
+	virtual size_t getResidentSizeinBytes() const;
+	bool isResident() const;
+	/*! \brief returns the managed column after reloading it, e.g., to attach an index, it may be spilled again afterwards*/
+	const ColumnTypedPtr getColumn();
+
+	private:
+	ManagedColumn(const ManagedColumn&);
+	ManagedColumn& operator=(const ManagedColumn&);
+
+	enum AccessMode{READ_ACCESS,ROW_MODIFICATION,BULK_MODIFICATION};
+
+	/*! \brief keeps the column resident while it exists*/
+	class Pin{
+		public:
+		Pin(const ManagedColumn<T>& column, AccessMode mode);
+		~Pin();
+		ColumnBaseTyped<T>* operator->() const;
+		ColumnBaseTyped<T>& operator*() const;
+		private:
+		Pin(const Pin&);
+		Pin& operator=(const Pin&);
+		ManagedColumn<T>& column_;
+		AccessMode mode_;
+	};
+
+	/*! \brief returns a name for the subdirectory of a managed column, which no other managed column uses*/
+	static const std::string createSpillDirectoryName(const std::string& spill_path);
+	/*! \brief reloads the column, if it is spilled, and prevents spilling until unpin()*/
+	void pin();
+	/*! \brief reports the new footprint after bulk modifications and after every footprint_refresh_interval_ row modifications*/
+	void unpin(AccessMode mode);
+
+	/*! number of row modifications, after which the footprint is computed again*/
+	static const unsigned int footprint_refresh_interval_=1024;
+
+	ColumnTypedPtr column_;
+	/*! private subdirectory of the spill directory*/
+	std::string spill_path_;
+	/*! true, if spill_path_ was created*/
+	bool has_spill_directory_;
+	MemoryManager& manager_;
+	bool resident_;
+	/*! number of rows of the spilled column*/
+	size_t number_of_rows_;
+	unsigned int number_of_pins_;
+	/*! counted by unpin() without the lock, which must not be held while the manager is called*/
+	std::atomic<unsigned int> number_of_row_modifications_;
+	std::atomic<uint64_t> last_access_;
+	mutable std::mutex mutex_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	ManagedColumn<T>::ManagedColumn(ColumnTypedPtr column, const std::string& spill_path, MemoryManager& manager)
+		: ColumnBaseTyped<T>(column->getName(),column->getType()), SpillableColumn(), column_(column),
+		spill_path_(createSpillDirectoryName(spill_path)), has_spill_directory_(false), manager_(manager),
+		resident_(true), number_of_rows_(0), number_of_pins_(0), number_of_row_modifications_(0), last_access_(manager.tick()), mutex_(){
+		manager_.registerColumn(this);
+		manager_.updateFootprint(this,column_->getSizeinBytes());
+	}
+
+	template<class T>
+	ManagedColumn<T>::~ManagedColumn(){
+		manager_.unregisterColumn(this);
+		if(!has_spill_directory_) return;
+		//the subdirectory only contains the files of this column
+		if(DIR* directory=opendir(spill_path_.c_str())){
+			while(struct dirent* entry=readdir(directory)){
+				const std::string file_name=entry->d_name;
+				if(file_name!="." && file_name!="..") std::remove((spill_path_+"/"+file_name).c_str());
+			}
+			closedir(directory);
+		}
+		rmdir(spill_path_.c_str());
+	}
+
+	template<class T>
+	const std::string ManagedColumn<T>::createSpillDirectoryName(const std::string& spill_path){
+		//the process id separates processes, which spill to the same directory
+		static std::atomic<uint64_t> number_of_spill_directories(0);
+		return spill_path+"/managed_column_"+std::to_string(getpid())+"_"+std::to_string(number_of_spill_directories++);
+	}
+
+	template<class T>
+	ManagedColumn<T>::Pin::Pin(const ManagedColumn<T>& column, AccessMode mode) : column_(const_cast<ManagedColumn<T>&>(column)), mode_(mode){
+		column_.pin();
+	}
+
+	template<class T>
+	ManagedColumn<T>::Pin::~Pin(){
+		column_.unpin(mode_);
+	}
+
+	template<class T>
+	ColumnBaseTyped<T>* ManagedColumn<T>::Pin::operator->() const{
+		return column_.column_.get();
+	}
+
+	template<class T>
+	ColumnBaseTyped<T>& ManagedColumn<T>::Pin::operator*() const{
+		return *column_.column_;
+	}
+
+	template<class T>
+	void ManagedColumn<T>::pin(){
+		bool reloaded=false;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if(!resident_){
+				if(!column_->load(spill_path_)){
+					std::cout << "Fatal Error! Could not reload spilled column " << this->name_ << " from " << spill_path_ << std::endl;
+				}
+				resident_=true;
+				reloaded=true;
+			}
+			++number_of_pins_;
+		}
+		last_access_.store(manager_.tick());
+		//the manager must not be called while the lock is held, it may spill other columns
+		if(reloaded) manager_.updateFootprint(this,column_->getSizeinBytes());
+	}
+
+	template<class T>
+	void ManagedColumn<T>::unpin(AccessMode mode){
+		if(mode==BULK_MODIFICATION || (mode==ROW_MODIFICATION && (number_of_row_modifications_.fetch_add(1)+1)%footprint_refresh_interval_==0)){
+			manager_.updateFootprint(this,column_->getSizeinBytes());
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		--number_of_pins_;
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::spill(){
+		std::unique_lock<std::mutex> lock(mutex_,std::try_to_lock);
+		if(!lock.owns_lock() || number_of_pins_>0 || !resident_) return false;
+		if(!has_spill_directory_){
+			if(mkdir(spill_path_.c_str(),S_IRWXU)!=0 && errno!=EEXIST){
+				std::cout << "Fatal Error! Could not create spill directory " << spill_path_ << std::endl;
+				return false;
+			}
+			has_spill_directory_=true;
+		}
+		if(!column_->store(spill_path_)){
+			std::cout << "Fatal Error! Could not spill column " << this->name_ << " to " << spill_path_ << std::endl;
+			return false;
+		}
+		number_of_rows_=column_->size();
+		column_->clearContent();
+		resident_=false;
+		return true;
+	}
+
+	template<class T>
+	uint64_t ManagedColumn<T>::getLastAccess() const{
+		return last_access_.load();
+	}
+
+	template<class T>
+	size_t ManagedColumn<T>::getResidentSizeinBytes() const{
+		return getSizeinBytes();
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::isResident() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return resident_;
+	}
+
+	template<class T>
+	const typename ManagedColumn<T>::ColumnTypedPtr ManagedColumn<T>::getColumn(){
+		Pin pin(*this,BULK_MODIFICATION);
+		return column_;
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::insert(const boost::any& new_value){
+		Pin pin(*this,ROW_MODIFICATION);
+		return pin->insert(new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::insert(const T& new_value){
+		Pin pin(*this,ROW_MODIFICATION);
+		return pin->insert(new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::update(TID tid, const boost::any& new_value){
+		Pin pin(*this,ROW_MODIFICATION);
+		return pin->update(tid,new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->update(tids,new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::update(TID tid, const T& new_value){
+		Pin pin(*this,ROW_MODIFICATION);
+		return pin->update(tid,new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::remove(TID tid){
+		Pin pin(*this,ROW_MODIFICATION);
+		return pin->remove(tid);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::remove(PositionListPtr tids){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->remove(tids);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::clearContent(){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->clearContent();
+	}
+
+	template<class T>
+	const boost::any ManagedColumn<T>::get(TID tid){
+		Pin pin(*this,READ_ACCESS);
+		return pin->get(tid);
+	}
+
+	template<class T>
+	T ManagedColumn<T>::getValue(TID tid){
+		Pin pin(*this,READ_ACCESS);
+		return pin->getValue(tid);
+	}
+
+	template<class T>
+	void ManagedColumn<T>::print() const throw(){
+		Pin pin(*this,READ_ACCESS);
+		pin->print();
+	}
+
+	template<class T>
+	size_t ManagedColumn<T>::size() const throw(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(!resident_) return number_of_rows_;
+		return column_->size();
+	}
+
+	template<class T>
+	size_t ManagedColumn<T>::getSizeinBytes() const throw(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(!resident_) return 0;
+		return column_->getSizeinBytes();
+	}
+
+	template<class T>
+	const ColumnPtr ManagedColumn<T>::copy() const{
+		Pin pin(*this,READ_ACCESS);
+		return pin->copy();
+	}
+
+	template<class T>
+	const PositionListPtr ManagedColumn<T>::sort(SortOrder order){
+		Pin pin(*this,READ_ACCESS);
+		return pin->sort(order);
+	}
+
+	template<class T>
+	const PositionListPtr ManagedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+		Pin pin(*this,READ_ACCESS);
+		return pin->selection(value_for_comparison,comp);
+	}
+
+	template<class T>
+	const PositionListPtr ManagedColumn<T>::predicate_selection(const PredicateExpression<T>& predicate){
+		Pin pin(*this,READ_ACCESS);
+		return pin->predicate_selection(predicate);
+	}
+
+	template<class T>
+	const PositionListPtr ManagedColumn<T>::parallel_selection(const boost::any& value_for_comparison, const ValueComparator comp, unsigned int number_of_threads){
+		Pin pin(*this,READ_ACCESS);
+		return pin->parallel_selection(value_for_comparison,comp,number_of_threads);
+	}
+
+	template<class T>
+	const PositionListPairPtr ManagedColumn<T>::hash_join(ColumnPtr join_column){
+		Pin pin(*this,READ_ACCESS);
+		return pin->hash_join(join_column);
+	}
+
+	template<class T>
+	const PositionListPairPtr ManagedColumn<T>::sort_merge_join(ColumnPtr join_column){
+		Pin pin(*this,READ_ACCESS);
+		return pin->sort_merge_join(join_column);
+	}
+
+	template<class T>
+	const PositionListPairPtr ManagedColumn<T>::nested_loop_join(ColumnPtr join_column){
+		Pin pin(*this,READ_ACCESS);
+		return pin->nested_loop_join(join_column);
+	}
+
+	template<class T>
+	const PositionListPairPtr ManagedColumn<T>::join(ColumnPtr join_column){
+		Pin pin(*this,READ_ACCESS);
+		return pin->join(join_column);
+	}
+
+	template<class T>
+	const typename ColumnStatistics<T>::ColumnStatisticsPtr ManagedColumn<T>::getStatistics(){
+		Pin pin(*this,READ_ACCESS);
+		return pin->getStatistics();
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::add(const boost::any& new_value){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->add(new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::add(ColumnPtr column){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->add(column);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::minus(const boost::any& new_value){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->minus(new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::minus(ColumnPtr column){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->minus(column);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::multiply(const boost::any& new_value){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->multiply(new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::multiply(ColumnPtr column){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->multiply(column);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::division(const boost::any& new_value){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->division(new_value);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::division(ColumnPtr column){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->division(column);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::store(const std::string& path){
+		Pin pin(*this,READ_ACCESS);
+		return pin->store(path);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::load(const std::string& path){
+		Pin pin(*this,BULK_MODIFICATION);
+		return pin->load(path);
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::isMaterialized() const throw(){
+		return column_->isMaterialized();
+	}
+
+	template<class T>
+	bool ManagedColumn<T>::isCompressed() const throw(){
+		return column_->isCompressed();
+	}
+
+	template<class T>
+	T& ManagedColumn<T>::operator[](const TID index){
+		Pin pin(*this,READ_ACCESS);
+		return (*pin)[index];
+	}
+
+	template<class T>
+	void ManagedColumn<T>::gather(const PositionList& tids, T* output){
+		Pin pin(*this,READ_ACCESS);
+		pin->gather(tids,output);
+	}
+
+	template<class T>
+	void ManagedColumn<T>::decodeRange(TID begin, TID end, T* output){
+		Pin pin(*this,READ_ACCESS);
+		pin->decodeRange(begin,end,output);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+
+#include <core/global_definitions.hpp>
+
+namespace CoGaDB{
+
+/*! size of a huge page on x86-64, chunks of a CoGaDB::MemoryArena are multiples of it*/
+const size_t HUGE_PAGE_SIZE=2*1024*1024;
+/*! smallest block of a CoGaDB::MemoryArena, a returned block keeps the pointer to the next free block of its size*/
+const size_t MIN_ARENA_BLOCK_SIZE=16;
+
+/*!
+ *  \brief     An arena for column storage, which hands out memory from large chunks backed by 2 MB huge pages.
+ *  \details   A chunk is mapped with MAP_HUGETLB, if the system has reserved huge pages, otherwise it is aligned to 2 MB and transparent
+ *  huge pages are requested with madvise(). Each chunk is bound to a NUMA node before it is touched: either to a fixed node or to the node of
+ *  the thread, which allocates the chunk, e.g., the thread, which loads the column. Every allocation is rounded up to a power of two (a size
+ *  class). A returned block is handed out again to the next allocation of its size class, so node based containers, e.g., the maps of a
+ *  dictionary, which insert and erase single nodes, reuse their memory. An allocation without a free block of its size class splits the
+ *  smallest free block of a larger class, e.g., the old buffer of a grown vector, and only bumps a pointer, if there is none. A returned
+ *  block of at least HUGE_PAGE_SIZE bytes gives its pages back to the operating system with madvise(MADV_DONTNEED) and keeps its addresses,
+ *  so a vector, which grows by doubling, does not keep all of its old buffers resident. Chunks of reserved huge pages can not give back
+ *  parts of a page and keep them. All chunks are unmapped, when the last allocation is returned, so clearing all containers, which use an arena, releases its memory at once.
+ */
+class MemoryArena{
+	public:
+	/*! \brief numa_node -1 places every chunk on the node of the thread, which allocates it*/
+	explicit MemoryArena(size_t chunk_size=HUGE_PAGE_SIZE, int numa_node=-1);
+	~MemoryArena();
+
+	void* allocate(size_t number_of_bytes, size_t alignment);
+	void deallocate(void* pointer, size_t number_of_bytes);
+	/*! \brief unmaps all chunks, no allocation of the arena may be used afterwards*/
+	void release();
+
+	/*! \brief number of mapped bytes*/
+	size_t getSizeinBytes() const;
+	/*! \brief number of chunks, which are backed by reserved huge pages instead of transparent huge pages*/
+	size_t getNumberOfHugeTLBChunks() const;
+	int getNumaNode() const throw();
+
+	/*! \brief returns the NUMA node of the CPU, which runs the calling thread*/
+	static int getCurrentNumaNode();
+
+	private:
+	MemoryArena(const MemoryArena&);
+	MemoryArena& operator=(const MemoryArena&);
+
+	struct Chunk{
+		char* begin;
+		size_t size;
+		bool huge_tlb;
+	};
+
+	void allocateChunk(size_t min_size);
+	void unmapChunks();
+	static void bindToNumaNode(void* begin, size_t size, int numa_node);
+	/*! \brief returns the size class of number_of_bytes, the size of its blocks is 1 << size class*/
+	static unsigned int getSizeClass(size_t number_of_bytes);
+	/*! \brief hands out the first block of size_class of the smallest free block of a larger class with alignment and adds the rest of it
+	 *  to the free blocks of the classes between them, returns NULL, if there is no such block*/
+	char* splitLargerBlock(unsigned int size_class, size_t alignment);
+	/*! \brief gives the pages of the free block back to the operating system, except the page, which keeps the pointer to the next block*/
+	static void releasePages(char* block, size_t block_size);
+
+	std::vector<Chunk> chunks_;
+	char* current_;
+	char* end_;
+	/*! first free block of every size class, the first bytes of a free block point to the next free block of its size class*/
+	std::vector<char*> free_blocks_;
+	size_t chunk_size_;
+	int numa_node_;
+	size_t number_of_live_allocations_;
+	mutable std::mutex mutex_;
+};
+
+typedef shared_pointer_namespace::shared_ptr<MemoryArena> MemoryArenaPtr;
+
+/*!
+ *  \brief     Allocator of the storage of columns, which allocates from a CoGaDB::MemoryArena, if it has one, otherwise with operator new.
+ *  \details   Copies of a container share the arena of the container.
+ */
+template<class T>
+class ColumnAllocator{
+	public:
+	typedef T value_type;
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	ColumnAllocator() throw();
+	explicit ColumnAllocator(const MemoryArenaPtr& arena) throw();
+	template<class U>
+	ColumnAllocator(const ColumnAllocator<U>& allocator) throw();
+
+	T* allocate(size_t n);
+	void deallocate(T* pointer, size_t n);
+
+	const MemoryArenaPtr& getArena() const throw();
+
+	private:
+	MemoryArenaPtr arena_;
+};
+
+template<class T, class U>
+bool operator==(const ColumnAllocator<T>& lhs, const ColumnAllocator<U>& rhs){
+	return lhs.getArena()==rhs.getArena();
+}
+
+template<class T, class U>
+bool operator!=(const ColumnAllocator<T>& lhs, const ColumnAllocator<U>& rhs){
+	return !(lhs==rhs);
+}
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline MemoryArena::MemoryArena(size_t chunk_size, int numa_node) : chunks_(), current_(NULL), end_(NULL), free_blocks_(8*sizeof(size_t),NULL),
+		chunk_size_((chunk_size+HUGE_PAGE_SIZE-1)/HUGE_PAGE_SIZE*HUGE_PAGE_SIZE), numa_node_(numa_node), number_of_live_allocations_(0), mutex_(){
+
+	}
+
+	inline MemoryArena::~MemoryArena(){
+		release();
+	}
+
+	inline unsigned int MemoryArena::getSizeClass(size_t number_of_bytes){
+		if(number_of_bytes<=MIN_ARENA_BLOCK_SIZE) number_of_bytes=MIN_ARENA_BLOCK_SIZE;
+		return 8*sizeof(unsigned long long)-__builtin_clzll(number_of_bytes-1);
+	}
+
+	inline void* MemoryArena::allocate(size_t number_of_bytes, size_t alignment){
+		std::lock_guard<std::mutex> lock(mutex_);
+		unsigned int size_class=getSizeClass(number_of_bytes);
+		size_t block_size=size_t(1) << size_class;
+		++number_of_live_allocations_;
+		char* begin=free_blocks_[size_class];
+		if(begin!=NULL && reinterpret_cast<uintptr_t>(begin)%alignment==0){
+			free_blocks_[size_class]=*reinterpret_cast<char**>(begin);
+			return begin;
+		}
+		begin=splitLargerBlock(size_class,alignment);
+		if(begin!=NULL) return begin;
+		//blocks are aligned to at least a pointer, so a free block can keep the pointer to the next one
+		alignment=std::max(alignment,alignof(char*));
+		begin=reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(current_)+alignment-1) & ~uintptr_t(alignment-1));
+		if(current_==NULL || begin+block_size>end_){
+			allocateChunk(block_size+alignment);
+			begin=reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(current_)+alignment-1) & ~uintptr_t(alignment-1));
+		}
+		current_=begin+block_size;
+		return begin;
+	}
+
+	inline void MemoryArena::deallocate(void* pointer, size_t number_of_bytes){
+		std::lock_guard<std::mutex> lock(mutex_);
+		--number_of_live_allocations_;
+		if(number_of_live_allocations_==0){
+			unmapChunks();
+			return;
+		}
+		//the block is handed out again to the next allocation of its size class
+		unsigned int size_class=getSizeClass(number_of_bytes);
+		char* block=static_cast<char*>(pointer);
+		if((size_t(1) << size_class)>=HUGE_PAGE_SIZE) releasePages(block,size_t(1) << size_class);
+		*reinterpret_cast<char**>(block)=free_blocks_[size_class];
+		free_blocks_[size_class]=block;
+	}
+
+	inline char* MemoryArena::splitLargerBlock(unsigned int size_class, size_t alignment){
+		for(unsigned int larger_class=size_class+1;larger_class<free_blocks_.size();larger_class++){
+			char* block=free_blocks_[larger_class];
+			if(block==NULL || reinterpret_cast<uintptr_t>(block)%alignment!=0) continue;
+			free_blocks_[larger_class]=*reinterpret_cast<char**>(block);
+			//the upper half of the block becomes a free block of the next smaller class, until the lower half has the requested size
+			for(unsigned int split_class=larger_class;split_class>size_class;split_class--){
+				char* upper_half=block+(size_t(1) << (split_class-1));
+				*reinterpret_cast<char**>(upper_half)=free_blocks_[split_class-1];
+				free_blocks_[split_class-1]=upper_half;
+			}
+			return block;
+		}
+		return NULL;
+	}
+
+	inline void MemoryArena::releasePages(char* block, size_t block_size){
+		const uintptr_t page_size=sysconf(_SC_PAGESIZE);
+		uintptr_t begin=(reinterpret_cast<uintptr_t>(block)+sizeof(char*)+page_size-1) & ~(page_size-1);
+		uintptr_t end=(reinterpret_cast<uintptr_t>(block)+block_size) & ~(page_size-1);
+		//fails on chunks of reserved huge pages, which keep their pages
+		if(begin<end) madvise(reinterpret_cast<void*>(begin),end-begin,MADV_DONTNEED);
+	}
+
+	inline void MemoryArena::release(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		unmapChunks();
+	}
+
+	inline void MemoryArena::unmapChunks(){
+		for(size_t i=0;i<chunks_.size();i++){
+			munmap(chunks_[i].begin,chunks_[i].size);
+		}
+		chunks_.clear();
+		current_=NULL;
+		end_=NULL;
+		std::fill(free_blocks_.begin(),free_blocks_.end(),static_cast<char*>(NULL));
+		number_of_live_allocations_=0;
+	}
+
+	inline void MemoryArena::allocateChunk(size_t min_size){
+		size_t size=std::max(chunk_size_,(min_size+HUGE_PAGE_SIZE-1)/HUGE_PAGE_SIZE*HUGE_PAGE_SIZE);
+		Chunk chunk={NULL,size,true};
+		void* memory=MAP_FAILED;
+#ifdef MAP_HUGETLB
+		memory=mmap(NULL,size,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,-1,0);
+#endif
+		if(memory==MAP_FAILED){
+			//no reserved huge pages: map one extra huge page, so the chunk can start at a huge page boundary
+			chunk.huge_tlb=false;
+			memory=mmap(NULL,size+HUGE_PAGE_SIZE,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+			if(memory==MAP_FAILED) throw std::bad_alloc();
+			char* mapping=static_cast<char*>(memory);
+			char* aligned=reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(mapping)+HUGE_PAGE_SIZE-1) & ~uintptr_t(HUGE_PAGE_SIZE-1));
+			if(aligned>mapping) munmap(mapping,aligned-mapping);
+			munmap(aligned+size,mapping+HUGE_PAGE_SIZE-aligned);
+			memory=aligned;
+#ifdef MADV_HUGEPAGE
+			madvise(memory,size,MADV_HUGEPAGE);
+#endif
+		}
+		chunk.begin=static_cast<char*>(memory);
+		bindToNumaNode(chunk.begin,size,numa_node_<0 ? getCurrentNumaNode() : numa_node_);
+		chunks_.push_back(chunk);
+		current_=chunk.begin;
+		end_=chunk.begin+size;
+	}
+
+	inline void MemoryArena::bindToNumaNode(void* begin, size_t size, int numa_node){
+		//MPOL_PREFERRED falls back to other nodes, if the node runs out of memory, the call fails harmlessly on kernels without NUMA support
+		const size_t bits_per_word=8*sizeof(unsigned long);
+		std::vector<unsigned long> node_mask(numa_node/bits_per_word+1,0);
+		node_mask[numa_node/bits_per_word]|=1UL << (numa_node%bits_per_word);
+		syscall(SYS_mbind,begin,size,MPOL_PREFERRED,node_mask.data(),node_mask.size()*bits_per_word+1,0);
+	}
+
+	inline int MemoryArena::getCurrentNumaNode(){
+		unsigned int cpu=0;
+		unsigned int numa_node=0;
+		if(syscall(SYS_getcpu,&cpu,&numa_node,NULL)!=0) return 0;
+		return numa_node;
+	}
+
+	inline size_t MemoryArena::getSizeinBytes() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		size_t size_in_bytes=0;
+		for(size_t i=0;i<chunks_.size();i++){
+			size_in_bytes+=chunks_[i].size;
+		}
+		return size_in_bytes;
+	}
+
+	inline size_t MemoryArena::getNumberOfHugeTLBChunks() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		size_t number_of_chunks=0;
+		for(size_t i=0;i<chunks_.size();i++){
+			if(chunks_[i].huge_tlb) ++number_of_chunks;
+		}
+		return number_of_chunks;
+	}
+
+	inline int MemoryArena::getNumaNode() const throw(){
+		return numa_node_;
+	}
+
+	template<class T>
+	ColumnAllocator<T>::ColumnAllocator() throw() : arena_(){
+
+	}
+
+	template<class T>
+	ColumnAllocator<T>::ColumnAllocator(const MemoryArenaPtr& arena) throw() : arena_(arena){
+
+	}
+
+	template<class T>
+	template<class U>
+	ColumnAllocator<T>::ColumnAllocator(const ColumnAllocator<U>& allocator) throw() : arena_(allocator.getArena()){
+
+	}
+
+	template<class T>
+	T* ColumnAllocator<T>::allocate(size_t n){
+		if(!arena_) return static_cast<T*>(::operator new(n*sizeof(T)));
+		return static_cast<T*>(arena_->allocate(n*sizeof(T),alignof(T)));
+	}
+
+	template<class T>
+	void ColumnAllocator<T>::deallocate(T* pointer, size_t n){
+		if(!arena_){
+			::operator delete(pointer);
+			return;
+		}
+		arena_->deallocate(pointer,n*sizeof(T));
+	}
+
+	template<class T>
+	const MemoryArenaPtr& ColumnAllocator<T>::getArena() const throw(){
+		return arena_;
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
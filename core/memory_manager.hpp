@@ -0,0 +1,204 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace CoGaDB{
+
+/*! \brief returns the number of bytes, which value allocated on the heap, e.g., the characters of a long string*/
+template<class T>
+inline size_t getHeapSizeinBytes(const T&){
+	return 0;
+}
+
+template<>
+inline size_t getHeapSizeinBytes<std::string>(const std::string& value){
+	//short strings live inside the string object and need no extra allocation
+	const char* data=value.data();
+	const char* object=reinterpret_cast<const char*>(&value);
+	if(data>=object && data<object+sizeof(std::string)) return 0;
+	return value.capacity()+1;
+}
+
+/*! \brief returns the number of bytes of a node of a std::map with value_type T: the value, three pointers and the color*/
+template<class T>
+inline size_t getTreeNodeSizeinBytes(){
+	return 4*sizeof(void*)+sizeof(T);
+}
+
+/*!
+ *  \brief     Interface of columns, whose memory is managed by the CoGaDB::MemoryManager.
+ */
+class SpillableColumn{
+	public:
+	virtual ~SpillableColumn(){}
+	/*! \brief writes the column to disk and frees its memory
+	 *  \return false, if the column is in use or not resident*/
+	virtual bool spill()=0;
+	/*! \brief returns the time of the last access, as returned by MemoryManager::tick()*/
+	virtual uint64_t getLastAccess() const=0;
+	/*! \brief returns the footprint of the column in main memory, 0 while it is spilled*/
+	virtual size_t getResidentSizeinBytes() const=0;
+};
+
+/*!
+ *  \brief     Process wide accountant of the memory of managed columns, e.g., CoGaDB::ManagedColumn objects, with a memory budget.
+ *  \details   Every managed column reports its footprint after it changed. When the sum of all footprints exceeds the budget, the least recently
+ *  used columns are spilled to disk until the footprints fit into the budget again. The column, which reported the new footprint, is never
+ *  spilled for its own report. Columns, which are in use, are skipped. A budget of 0 disables spilling. The least recently used columns are
+ *  chosen under the lock of the manager, but spilled without it, so other columns can report their footprints meanwhile. A column is not
+ *  unregistered while it is spilled.
+ */
+class MemoryManager{
+	public:
+	static MemoryManager& instance();
+
+	MemoryManager();
+
+	void setBudget(size_t budget_in_bytes);
+	size_t getBudget() const;
+	/*! \brief sum of the footprints of all resident managed columns*/
+	size_t getResidentSizeinBytes() const;
+	size_t getFootprint(const SpillableColumn* column) const;
+	/*! \brief number of spills since the manager was created*/
+	size_t getNumberOfSpills() const;
+
+	void registerColumn(SpillableColumn* column);
+	void unregisterColumn(SpillableColumn* column);
+	/*! \brief sets the footprint of column and spills least recently used columns, while the footprints exceed the budget*/
+	void updateFootprint(SpillableColumn* column, size_t size_in_bytes);
+	/*! \brief returns a new point in time, which is later than all points in time returned before*/
+	uint64_t tick();
+
+	private:
+	MemoryManager(const MemoryManager&);
+	MemoryManager& operator=(const MemoryManager&);
+
+	/*! \brief spills least recently used columns, while the footprints exceed the budget, lock has to own the lock of the manager, which
+	 *  is released during every spill*/
+	void enforceBudget(std::unique_lock<std::mutex>& lock, const SpillableColumn* reporting_column);
+
+	static bool lessRecentlyUsed(const SpillableColumn* lhs, const SpillableColumn* rhs);
+
+	std::map<SpillableColumn*,size_t> footprints_;
+	size_t budget_;
+	size_t resident_size_;
+	size_t number_of_spills_;
+	/*! columns, which are spilled at the moment without the lock*/
+	std::set<SpillableColumn*> spilling_columns_;
+	std::atomic<uint64_t> clock_;
+	mutable std::mutex mutex_;
+	std::condition_variable spill_finished_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline MemoryManager& MemoryManager::instance(){
+		static MemoryManager manager;
+		return manager;
+	}
+
+	inline MemoryManager::MemoryManager() : footprints_(), budget_(0), resident_size_(0), number_of_spills_(0), spilling_columns_(), clock_(0), mutex_(),
+		spill_finished_(){
+
+	}
+
+	inline void MemoryManager::setBudget(size_t budget_in_bytes){
+		std::unique_lock<std::mutex> lock(mutex_);
+		budget_=budget_in_bytes;
+		enforceBudget(lock,NULL);
+	}
+
+	inline size_t MemoryManager::getBudget() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return budget_;
+	}
+
+	inline size_t MemoryManager::getResidentSizeinBytes() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return resident_size_;
+	}
+
+	inline size_t MemoryManager::getFootprint(const SpillableColumn* column) const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::map<SpillableColumn*,size_t>::const_iterator it=footprints_.find(const_cast<SpillableColumn*>(column));
+		if(it==footprints_.end()) return 0;
+		return it->second;
+	}
+
+	inline size_t MemoryManager::getNumberOfSpills() const{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return number_of_spills_;
+	}
+
+	inline void MemoryManager::registerColumn(SpillableColumn* column){
+		std::lock_guard<std::mutex> lock(mutex_);
+		footprints_.insert(std::make_pair(column,size_t(0)));
+	}
+
+	inline void MemoryManager::unregisterColumn(SpillableColumn* column){
+		std::unique_lock<std::mutex> lock(mutex_);
+		//the column is destroyed after it is unregistered, so a running spill has to finish first
+		while(spilling_columns_.count(column)>0){
+			spill_finished_.wait(lock);
+		}
+		std::map<SpillableColumn*,size_t>::iterator it=footprints_.find(column);
+		if(it==footprints_.end()) return;
+		resident_size_-=it->second;
+		footprints_.erase(it);
+	}
+
+	inline void MemoryManager::updateFootprint(SpillableColumn* column, size_t size_in_bytes){
+		std::unique_lock<std::mutex> lock(mutex_);
+		std::map<SpillableColumn*,size_t>::iterator it=footprints_.find(column);
+		if(it==footprints_.end()) return;
+		resident_size_=resident_size_-it->second+size_in_bytes;
+		it->second=size_in_bytes;
+		enforceBudget(lock,column);
+	}
+
+	inline uint64_t MemoryManager::tick(){
+		return ++clock_;
+	}
+
+	inline bool MemoryManager::lessRecentlyUsed(const SpillableColumn* lhs, const SpillableColumn* rhs){
+		return lhs->getLastAccess()<rhs->getLastAccess();
+	}
+
+	inline void MemoryManager::enforceBudget(std::unique_lock<std::mutex>& lock, const SpillableColumn* reporting_column){
+		if(budget_==0 || resident_size_<=budget_) return;
+		std::vector<SpillableColumn*> candidates;
+		for(std::map<SpillableColumn*,size_t>::const_iterator it=footprints_.begin();it!=footprints_.end();++it){
+			if(it->first!=reporting_column && it->second>0 && spilling_columns_.count(it->first)==0) candidates.push_back(it->first);
+		}
+		std::sort(candidates.begin(),candidates.end(),&MemoryManager::lessRecentlyUsed);
+		for(size_t i=0;i<candidates.size() && budget_>0 && resident_size_>budget_;i++){
+			//other threads may have spilled or unregistered the candidate, while the lock was released for a previous spill
+			if(footprints_.count(candidates[i])==0 || spilling_columns_.count(candidates[i])>0) continue;
+			spilling_columns_.insert(candidates[i]);
+			lock.unlock();
+			bool spilled=candidates[i]->spill();
+			lock.lock();
+			spilling_columns_.erase(candidates[i]);
+			spill_finished_.notify_all();
+			if(!spilled) continue;
+			//the column may have been reloaded meanwhile, so its footprint is asked for instead of assumed to be 0
+			size_t& footprint=footprints_[candidates[i]];
+			size_t size_in_bytes=candidates[i]->getResidentSizeinBytes();
+			resident_size_=resident_size_-footprint+size_in_bytes;
+			footprint=size_in_bytes;
+			++number_of_spills_;
+		}
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <core/global_definitions.hpp>
+
+namespace CoGaDB{
+
+	/*! \brief returns the number of threads the parallel column algorithms may use (at least one)*/
+	inline unsigned int getNumberOfAvailableThreads(){
+		unsigned int number_of_threads = std::thread::hardware_concurrency();
+		if(number_of_threads==0) return 1;
+		return number_of_threads;
+	}
+
+	/*! \brief returns true, if the CPU, which runs the program, supports AVX2, so functions compiled with target("avx2") may be called*/
+	inline bool hasAVX2(){
+#if defined(__x86_64__) || defined(__i386__)
+		static const bool has_avx2=(__builtin_cpu_init(),__builtin_cpu_supports("avx2")!=0);
+		return has_avx2;
+#else
+		return false;
+#endif
+	}
+
+	/*! \brief number of rows, which a thread encodes at least, when a compressed column is built from a bulk insert*/
+	const TID parallel_encoding_block_size=64*1024;
+
+	/*! \brief number of rows, which a thread scans at least in a parallel selection, smaller columns are scanned by the calling thread*/
+	const TID parallel_selection_block_size=64*1024;
+
+	/*! \brief splits the range [begin,end) into one contiguous chunk per thread and calls func(chunk_begin,chunk_end) for every chunk concurrently
+	 *  \details Ranges with less than min_chunk_size elements per thread use fewer threads, small ranges are processed by the calling thread only.
+	 *  The calling thread processes the last chunk itself and returns after all chunks are processed.*/
+	template<class Function>
+	void parallel_for(TID begin, TID end, Function func, unsigned int number_of_threads=getNumberOfAvailableThreads(), TID min_chunk_size=64*1024){
+		if(end<=begin) return;
+		TID number_of_elements=end-begin;
+		TID max_number_of_chunks=(number_of_elements+min_chunk_size-1)/min_chunk_size;
+		if(number_of_threads>max_number_of_chunks) number_of_threads=max_number_of_chunks;
+		if(number_of_threads<=1){
+			func(begin,end);
+			return;
+		}
+
+		TID chunk_size=(number_of_elements+number_of_threads-1)/number_of_threads;
+		std::vector<std::thread> threads;
+		threads.reserve(number_of_threads-1);
+		TID chunk_begin=begin;
+		for(unsigned int i=0;i<number_of_threads-1;i++){
+			TID chunk_end=std::min(end,chunk_begin+chunk_size);
+			threads.push_back(std::thread(func,chunk_begin,chunk_end));
+			chunk_begin=chunk_end;
+		}
+		func(chunk_begin,end);
+		for(unsigned int i=0;i<threads.size();i++){
+			threads[i].join();
+		}
+	}
+
+}; //end namespace CogaDB
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <core/base_column.hpp>
+#include <core/lookup_array.hpp>
+#include <core/gather.hpp>
+
+namespace CoGaDB{
+
+/*! \brief returns a LookupArray, which contains the rows tids of column*/
+inline const ColumnPtr createLookupArray(ColumnPtr column, PositionListPtr tids){
+	if(column->type()==typeid(int)){
+		return ColumnPtr(new LookupArray<int>(column->getName(),column->getType(),column,tids));
+	}else if(column->type()==typeid(float)){
+		return ColumnPtr(new LookupArray<float>(column->getName(),column->getType(),column,tids));
+	}else if(column->type()==typeid(double)){
+		return ColumnPtr(new LookupArray<double>(column->getName(),column->getType(),column,tids));
+	}else if(column->type()==typeid(std::string)){
+		return ColumnPtr(new LookupArray<std::string>(column->getName(),column->getType(),column,tids));
+	}else if(column->type()==typeid(bool)){
+		return ColumnPtr(new LookupArray<bool>(column->getName(),column->getType(),column,tids));
+	}
+	std::cout << "Fatal Error! invalid type for LookupArray on Column: " << column->getName() << std::endl;
+	return ColumnPtr();
+}
+
+/*! \brief copies the rows tids of column into a new column*/
+inline const ColumnPtr materializeColumn(ColumnPtr column, PositionListPtr tids){
+	ColumnPtr lookup_array=createLookupArray(column,tids);
+	if(!lookup_array) return ColumnPtr();
+	if(column->type()==typeid(int)){
+		return shared_pointer_namespace::static_pointer_cast<LookupArray<int> >(lookup_array)->materialize();
+	}else if(column->type()==typeid(float)){
+		return shared_pointer_namespace::static_pointer_cast<LookupArray<float> >(lookup_array)->materialize();
+	}else if(column->type()==typeid(double)){
+		return shared_pointer_namespace::static_pointer_cast<LookupArray<double> >(lookup_array)->materialize();
+	}else if(column->type()==typeid(std::string)){
+		return shared_pointer_namespace::static_pointer_cast<LookupArray<std::string> >(lookup_array)->materialize();
+	}
+	return shared_pointer_namespace::static_pointer_cast<LookupArray<bool> >(lookup_array)->materialize();
+}
+
+class IntermediateResult;
+typedef shared_pointer_namespace::shared_ptr<IntermediateResult> IntermediateResultPtr;
+
+/*!
+ *  \brief     The result of a physical operator: the rows of one or more tables, which are referenced by position lists (late materialization).
+ *  \details   Row i of the result consists of the rows tids[t][i] of every table t. A table, whose rows are all included in their original
+ *  order, has no position list. Operators pass intermediate results on without copying values, only getColumn() or a
+ *  CoGaDB::ProjectionOperator materialize values.
+ */
+class IntermediateResult{
+	public:
+	/*! \brief a result, which consists of all rows of table*/
+	explicit IntermediateResult(const ColumnVector& table);
+
+	/*! \brief number of rows*/
+	size_t size() const;
+
+	/*! \brief returns a view on the values of column name, which is the column itself or a LookupArray on it, or a null pointer if no table has this column*/
+	const ColumnPtr getView(const std::string& name) const;
+
+	/*! \brief returns the values of column name in a new column*/
+	const ColumnPtr getColumn(const std::string& name) const;
+
+	/*! \brief returns a result, which keeps the rows on the positions rows of this result*/
+	const IntermediateResultPtr filter(const PositionList& rows) const;
+
+	/*! \brief returns a result, whose row i consists of row join_rows.first[i] of left and row join_rows.second[i] of right*/
+	static const IntermediateResultPtr join(const IntermediateResult& left, const IntermediateResult& right, const PositionListPair& join_rows);
+
+	private:
+	IntermediateResult();
+
+	/*! \brief returns true and the source column and its position list, if a table has a column with name*/
+	bool findColumn(const std::string& name, ColumnPtr* column, PositionListPtr* tids) const;
+
+	/*! \brief returns tids[rows[i]] for all i, tids is null for all rows of a table*/
+	static const PositionListPtr compose(const PositionListPtr tids, const PositionList& rows);
+
+	std::vector<ColumnVector> tables_;
+	std::vector<PositionListPtr> tids_;
+	size_t size_;
+};
+
+/*! \brief base class of all physical operators, every operator pulls the result of its child operators in execute()*/
+class PhysicalOperator{
+	public:
+	virtual ~PhysicalOperator();
+	/*! \return the result of the operator, or a null pointer in case an error occured*/
+	virtual const IntermediateResultPtr execute()=0;
+};
+
+typedef shared_pointer_namespace::shared_ptr<PhysicalOperator> PhysicalOperatorPtr;
+
+/*! \brief returns all rows of a table*/
+class ScanOperator : public PhysicalOperator{
+	public:
+	explicit ScanOperator(const ColumnVector& table);
+	virtual const IntermediateResultPtr execute();
+	private:
+	ColumnVector table_;
+};
+
+/*! \brief keeps the rows, whose value in column column_name fulfills the comparison with value*/
+class FilterOperator : public PhysicalOperator{
+	public:
+	FilterOperator(PhysicalOperatorPtr child, const std::string& column_name, const boost::any& value, ValueComparator comp);
+	virtual const IntermediateResultPtr execute();
+	private:
+	PhysicalOperatorPtr child_;
+	std::string column_name_;
+	boost::any value_;
+	ValueComparator comp_;
+};
+
+/*! \brief equi joins the results of two operators, the join columns choose the join algorithm and the build side of a hash join*/
+class JoinOperator : public PhysicalOperator{
+	public:
+	JoinOperator(PhysicalOperatorPtr left, PhysicalOperatorPtr right, const std::string& left_column_name, const std::string& right_column_name);
+	virtual const IntermediateResultPtr execute();
+	private:
+	PhysicalOperatorPtr left_;
+	PhysicalOperatorPtr right_;
+	std::string left_column_name_;
+	std::string right_column_name_;
+};
+
+/*! \brief materializes the columns column_names of the result of its child, the result consists of a single table of materialized columns*/
+class ProjectionOperator : public PhysicalOperator{
+	public:
+	ProjectionOperator(PhysicalOperatorPtr child, const std::vector<std::string>& column_names);
+	virtual const IntermediateResultPtr execute();
+	private:
+	PhysicalOperatorPtr child_;
+	std::vector<std::string> column_names_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline IntermediateResult::IntermediateResult() : tables_(), tids_(), size_(0){
+
+	}
+
+	inline IntermediateResult::IntermediateResult(const ColumnVector& table) : tables_(1,table), tids_(1), size_(table.empty() ? 0 : table.front()->size()){
+
+	}
+
+	inline size_t IntermediateResult::size() const{
+		return size_;
+	}
+
+	inline bool IntermediateResult::findColumn(const std::string& name, ColumnPtr* column, PositionListPtr* tids) const{
+		for(size_t t=0;t<tables_.size();t++){
+			for(size_t c=0;c<tables_[t].size();c++){
+				if(tables_[t][c]->getName()==name){
+					*column=tables_[t][c];
+					*tids=tids_[t];
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	inline const ColumnPtr IntermediateResult::getView(const std::string& name) const{
+		ColumnPtr column;
+		PositionListPtr tids;
+		if(!findColumn(name,&column,&tids)){
+			std::cout << "Fatal Error! Column " << name << " is not part of the intermediate result" << std::endl;
+			return ColumnPtr();
+		}
+		if(!tids) return column;
+		return createLookupArray(column,tids);
+	}
+
+	inline const ColumnPtr IntermediateResult::getColumn(const std::string& name) const{
+		ColumnPtr column;
+		PositionListPtr tids;
+		if(!findColumn(name,&column,&tids)){
+			std::cout << "Fatal Error! Column " << name << " is not part of the intermediate result" << std::endl;
+			return ColumnPtr();
+		}
+		if(!tids) return column->copy();
+		return materializeColumn(column,tids);
+	}
+
+	inline const PositionListPtr IntermediateResult::compose(const PositionListPtr tids, const PositionList& rows){
+		if(!tids) return PositionListPtr(new PositionList(rows));
+		PositionListPtr result(new PositionList(rows.size()));
+		gatherValues(tids->data(),rows.data(),rows.size(),result->data());
+		return result;
+	}
+
+	inline const IntermediateResultPtr IntermediateResult::filter(const PositionList& rows) const{
+		IntermediateResultPtr result(new IntermediateResult());
+		result->tables_=tables_;
+		for(size_t t=0;t<tids_.size();t++){
+			result->tids_.push_back(compose(tids_[t],rows));
+		}
+		result->size_=rows.size();
+		return result;
+	}
+
+	inline const IntermediateResultPtr IntermediateResult::join(const IntermediateResult& left, const IntermediateResult& right, const PositionListPair& join_rows){
+		IntermediateResultPtr result(new IntermediateResult());
+		result->tables_=left.tables_;
+		result->tables_.insert(result->tables_.end(),right.tables_.begin(),right.tables_.end());
+		for(size_t t=0;t<left.tids_.size();t++){
+			result->tids_.push_back(compose(left.tids_[t],*join_rows.first));
+		}
+		for(size_t t=0;t<right.tids_.size();t++){
+			result->tids_.push_back(compose(right.tids_[t],*join_rows.second));
+		}
+		result->size_=join_rows.first->size();
+		return result;
+	}
+
+	inline PhysicalOperator::~PhysicalOperator(){
+
+	}
+
+	inline ScanOperator::ScanOperator(const ColumnVector& table) : PhysicalOperator(), table_(table){
+
+	}
+
+	inline const IntermediateResultPtr ScanOperator::execute(){
+		return IntermediateResultPtr(new IntermediateResult(table_));
+	}
+
+	inline FilterOperator::FilterOperator(PhysicalOperatorPtr child, const std::string& column_name, const boost::any& value, ValueComparator comp)
+		: PhysicalOperator(), child_(child), column_name_(column_name), value_(value), comp_(comp){
+
+	}
+
+	inline const IntermediateResultPtr FilterOperator::execute(){
+		IntermediateResultPtr input=child_->execute();
+		if(!input) return IntermediateResultPtr();
+		ColumnPtr column=input->getView(column_name_);
+		if(!column) return IntermediateResultPtr();
+		//unfiltered columns use their own selection, e.g., on compressed data
+		PositionListPtr rows=column->selection(value_,comp_);
+		if(!rows) return IntermediateResultPtr();
+		return input->filter(*rows);
+	}
+
+	inline JoinOperator::JoinOperator(PhysicalOperatorPtr left, PhysicalOperatorPtr right, const std::string& left_column_name, const std::string& right_column_name)
+		: PhysicalOperator(), left_(left), right_(right), left_column_name_(left_column_name), right_column_name_(right_column_name){
+
+	}
+
+	inline const IntermediateResultPtr JoinOperator::execute(){
+		IntermediateResultPtr left=left_->execute();
+		IntermediateResultPtr right=right_->execute();
+		if(!left || !right) return IntermediateResultPtr();
+		ColumnPtr left_column=left->getView(left_column_name_);
+		ColumnPtr right_column=right->getView(right_column_name_);
+		if(!left_column || !right_column) return IntermediateResultPtr();
+
+		PositionListPairPtr join_rows=left_column->join(right_column);
+		if(!join_rows || !join_rows->first || !join_rows->second) return IntermediateResultPtr();
+		return IntermediateResult::join(*left,*right,*join_rows);
+	}
+
+	inline ProjectionOperator::ProjectionOperator(PhysicalOperatorPtr child, const std::vector<std::string>& column_names)
+		: PhysicalOperator(), child_(child), column_names_(column_names){
+
+	}
+
+	inline const IntermediateResultPtr ProjectionOperator::execute(){
+		IntermediateResultPtr input=child_->execute();
+		if(!input) return IntermediateResultPtr();
+		ColumnVector columns;
+		for(size_t i=0;i<column_names_.size();i++){
+			ColumnPtr column=input->getColumn(column_names_[i]);
+			if(!column) return IntermediateResultPtr();
+			columns.push_back(column);
+		}
+		return IntermediateResultPtr(new IntermediateResult(columns));
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <core/global_definitions.hpp>
+#include <core/bloom_filter.hpp>
+
+namespace CoGaDB{
+
+/*! \brief number of rows, which a predicate expression evaluates at once*/
+const size_t predicate_chunk_size=1024;
+
+/*!
+ *  \brief     A predicate on the values of a column with type T, e.g., v BETWEEN 10 AND 20 AND v<>15.
+ *  \details   Predicates are evaluated chunk wise: evaluate() computes the result of the predicate for up to predicate_chunk_size values at once
+ *  and writes one byte (0 or 1) per value. Every leaf predicate is a class template, which is instantiated per comparator and type, so the
+ *  loop over the values contains no branch on the kind of comparison and can be vectorized by the compiler. Conjunctions and disjunctions
+ *  combine the byte masks of their children, so a complex predicate is evaluated in a single pass over the column.
+ */
+template<class T>
+class PredicateExpression{
+	public:
+	typedef shared_pointer_namespace::shared_ptr<PredicateExpression<T> > PredicateExpressionPtr;
+
+	virtual ~PredicateExpression(){}
+	/*! \brief writes 1 to result[i], if values[i] fulfills the predicate, otherwise 0, number_of_values must not exceed predicate_chunk_size*/
+	virtual void evaluate(const T* values, size_t number_of_values, unsigned char* result) const=0;
+	/*! \brief returns true and the bounds, if the predicate is lower <= v AND v <= upper, sorted columns answer such predicates with a binary search*/
+	virtual bool getRange(T*, T*) const{ return false; }
+};
+
+/*! \brief compares every value with a constant value, Comparator is a function object like std::less<T>*/
+template<class T, class Comparator>
+class ComparisonPredicate : public PredicateExpression<T>{
+	public:
+	explicit ComparisonPredicate(const T& value) : PredicateExpression<T>(), value_(value){}
+
+	virtual void evaluate(const T* values, size_t number_of_values, unsigned char* result) const{
+		Comparator comparator;
+		const T value=value_;
+		for(size_t i=0;i<number_of_values;i++){
+			result[i]=comparator(values[i],value);
+		}
+	}
+
+	private:
+	T value_;
+};
+
+/*! \brief lower <= v AND v <= upper*/
+template<class T>
+class BetweenPredicate : public PredicateExpression<T>{
+	public:
+	BetweenPredicate(const T& lower, const T& upper) : PredicateExpression<T>(), lower_(lower), upper_(upper){}
+
+	virtual void evaluate(const T* values, size_t number_of_values, unsigned char* result) const{
+		const T lower=lower_;
+		const T upper=upper_;
+		for(size_t i=0;i<number_of_values;i++){
+			//non short-circuit and, so the loop has no branches, a NaN compares false and is never in the range
+			result[i]=(lower<=values[i]) & (values[i]<=upper);
+		}
+	}
+
+	virtual bool getRange(T* lower, T* upper) const{
+		*lower=lower_;
+		*upper=upper_;
+		return true;
+	}
+
+	private:
+	T lower_;
+	T upper_;
+};
+
+/*! \brief v IN (values), short lists are compared element wise, long lists are looked up in a hash set*/
+template<class T>
+class InPredicate : public PredicateExpression<T>{
+	public:
+	explicit InPredicate(const std::vector<T>& values) : PredicateExpression<T>(), values_(values), value_set_(values.begin(),values.end()){}
+
+	virtual void evaluate(const T* values, size_t number_of_values, unsigned char* result) const{
+		if(values_.size()>16){
+			for(size_t i=0;i<number_of_values;i++){
+				result[i]=value_set_.find(values[i])!=value_set_.end();
+			}
+			return;
+		}
+		for(size_t i=0;i<number_of_values;i++){
+			result[i]=0;
+		}
+		//one pass per list element keeps the inner loop free of branches
+		for(size_t j=0;j<values_.size();j++){
+			const T value=values_[j];
+			for(size_t i=0;i<number_of_values;i++){
+				result[i]|=(values[i]==value);
+			}
+		}
+	}
+
+	private:
+	std::vector<T> values_;
+	boost::unordered_set<T> value_set_;
+};
+
+/*! \brief conjunction (is_conjunction=true) or disjunction of several predicates*/
+template<class T, bool is_conjunction>
+class JunctionPredicate : public PredicateExpression<T>{
+	public:
+	typedef typename PredicateExpression<T>::PredicateExpressionPtr PredicateExpressionPtr;
+
+	explicit JunctionPredicate(const std::vector<PredicateExpressionPtr>& children) : PredicateExpression<T>(), children_(children){}
+
+	virtual void evaluate(const T* values, size_t number_of_values, unsigned char* result) const{
+		if(children_.empty()){
+			for(size_t i=0;i<number_of_values;i++) result[i]=is_conjunction;
+			return;
+		}
+		children_[0]->evaluate(values,number_of_values,result);
+		unsigned char child_result[predicate_chunk_size];
+		for(size_t c=1;c<children_.size();c++){
+			//skip the remaining children, if their result can not change the result of this chunk
+			unsigned char any_decided=0;
+			for(size_t i=0;i<number_of_values;i++){
+				any_decided|=(is_conjunction ? result[i] : !result[i]);
+			}
+			if(!any_decided) return;
+			children_[c]->evaluate(values,number_of_values,child_result);
+			for(size_t i=0;i<number_of_values;i++){
+				if(is_conjunction){
+					result[i]&=child_result[i];
+				}else{
+					result[i]|=child_result[i];
+				}
+			}
+		}
+	}
+
+	private:
+	std::vector<PredicateExpressionPtr> children_;
+};
+
+/*! \brief semi join filter: v may be contained in the column, on which filter was built, some values pass, which are not contained*/
+template<class T>
+class BloomFilterPredicate : public PredicateExpression<T>{
+	public:
+	explicit BloomFilterPredicate(BloomFilterPtr filter) : PredicateExpression<T>(), filter_(filter){}
+
+	virtual void evaluate(const T* values, size_t number_of_values, unsigned char* result) const{
+		uint64_t hash_values[predicate_chunk_size];
+		for(size_t i=0;i<number_of_values;i++){
+			hash_values[i]=BloomFilter::hash(values[i]);
+		}
+		filter_->containsBatch(hash_values,number_of_values,result);
+	}
+
+	private:
+	BloomFilterPtr filter_;
+};
+
+/*! \brief returns the TIDs offset+i of all values[i], which fulfill predicate*/
+template<class T>
+void evaluatePredicate(const PredicateExpression<T>& predicate, const T* values, size_t number_of_values, TID offset, PositionList& result){
+	unsigned char matches[predicate_chunk_size];
+	for(size_t begin=0;begin<number_of_values;begin+=predicate_chunk_size){
+		size_t chunk_size=std::min(predicate_chunk_size,number_of_values-begin);
+		predicate.evaluate(values+begin,chunk_size,matches);
+		for(size_t i=0;i<chunk_size;i++){
+			if(matches[i]) result.push_back(offset+begin+i);
+		}
+	}
+}
+
+/***************** factory functions *****************/
+
+/*! \brief returns the predicate v comp value, a null pointer for unknown comparators*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeComparison(ValueComparator comp, const T& value){
+	typedef typename PredicateExpression<T>::PredicateExpressionPtr PredicateExpressionPtr;
+	if(comp==LESSER){
+		return PredicateExpressionPtr(new ComparisonPredicate<T,std::less<T> >(value));
+	}else if(comp==GREATER){
+		return PredicateExpressionPtr(new ComparisonPredicate<T,std::greater<T> >(value));
+	}else if(comp==EQUAL){
+		return PredicateExpressionPtr(new ComparisonPredicate<T,std::equal_to<T> >(value));
+	}
+	return PredicateExpressionPtr();
+}
+
+/*! \brief returns the predicate v <> value*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeNotEqual(const T& value){
+	return typename PredicateExpression<T>::PredicateExpressionPtr(new ComparisonPredicate<T,std::not_equal_to<T> >(value));
+}
+
+/*! \brief returns the predicate v BETWEEN lower AND upper (both inclusive)*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeBetween(const T& lower, const T& upper){
+	return typename PredicateExpression<T>::PredicateExpressionPtr(new BetweenPredicate<T>(lower,upper));
+}
+
+/*! \brief returns the predicate v IN (values)*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeIn(const std::vector<T>& values){
+	return typename PredicateExpression<T>::PredicateExpressionPtr(new InPredicate<T>(values));
+}
+
+/*! \brief returns a predicate, which keeps the values, which pass filter*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeBloomFilterPredicate(BloomFilterPtr filter){
+	return typename PredicateExpression<T>::PredicateExpressionPtr(new BloomFilterPredicate<T>(filter));
+}
+
+/*! \brief returns the conjunction of all children*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeConjunction(const std::vector<typename PredicateExpression<T>::PredicateExpressionPtr>& children){
+	return typename PredicateExpression<T>::PredicateExpressionPtr(new JunctionPredicate<T,true>(children));
+}
+
+/*! \brief returns the disjunction of all children*/
+template<class T>
+const typename PredicateExpression<T>::PredicateExpressionPtr makeDisjunction(const std::vector<typename PredicateExpression<T>::PredicateExpressionPtr>& children){
+	return typename PredicateExpression<T>::PredicateExpressionPtr(new JunctionPredicate<T,false>(children));
+}
+
+}; //end namespace CogaDB
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+
+#include <core/column_base_typed.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *
+ *
+ *  \brief     This class represents an uncompressed column with type T, to which many threads can append concurrently without locks.
+ *  \details   The values are stored in fixed size chunks, which are found through a two level chunk directory. Directory blocks and chunks
+ *  are allocated on demand and installed with compare and swap, so the directory grows without locking. An append reserves a range of
+ *  row ids with a single fetch and add and writes its values into the reserved slots. Afterwards it marks its rows in the completion bitmap
+ *  of their chunks, one atomic or per 64 rows, and returns without waiting for other appends. size() is the prefix of rows, which are
+ *  completely written: it continues the last computed prefix over the set bits of the bitmaps, so a slow append only hides the rows behind
+ *  it, until it finished, and readers can access all rows before size() with operator[]. Appended rows never move, because chunks are never
+ *  reallocated.
+ *  update() writes in place. remove() and clearContent() shift or free rows and must not run concurrently with other operations.
+ */
+template<class T>
+class SegmentedColumn : public ColumnBaseTyped<T>{
+	public:
+	/*! \brief number of values per chunk is 2^chunk_bits*/
+	static const unsigned int chunk_bits=16;
+	static const size_t chunk_size=size_t(1)<<chunk_bits;
+	/*! \brief number of chunk pointers per directory block*/
+	static const size_t directory_block_size=1024;
+	/*! \brief number of directory blocks, the column can store up to chunk_size*directory_block_size*number_of_directory_blocks rows*/
+	static const size_t number_of_directory_blocks=1024;
+
+	/***************** constructors and destructor *****************/
+	SegmentedColumn(const std::string& name, AttributeType db_type);
+	virtual ~SegmentedColumn();
+
+	virtual bool insert(const boost::any& new_value);
+	bool insert(const T& new_value);
+	template <typename InputIterator>
+	bool insert(InputIterator first, InputIterator last);
+	/*! \brief appends the values in [first,last), may be called by many threads concurrently
+	 *  \return the row id of the first appended value*/
+	template <typename InputIterator>
+	TID append(InputIterator first, InputIterator last);
+
+	virtual bool update(TID tid, const boost::any& new_value);
+	virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+	virtual bool remove(TID tid);
+	//assumes tid list is sorted ascending
+	virtual bool remove(PositionListPtr tid);
+	virtual bool clearContent();
+
+	virtual const boost::any get(TID tid);
+	virtual void print() const throw();
+	/*! \brief returns the number of published rows*/
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	virtual const ColumnPtr copy() const;
+
+	virtual bool store(const std::string& path);
+	virtual bool load(const std::string& path);
+	virtual bool isMaterialized() const  throw();
+	virtual bool isCompressed() const  throw();
+
+	virtual T& operator[](const TID index);
+
+	private:
+	/*! \brief number of rows, whose completion bits are in one word of a completion bitmap*/
+	static const size_t rows_per_completion_word=64;
+
+	struct Chunk{
+		Chunk() : values(), completed_rows(){}
+		T values[chunk_size];
+		/*! bit i is set, when row i of the chunk is completely written*/
+		std::atomic<uint64_t> completed_rows[chunk_size/rows_per_completion_word];
+	};
+
+	struct DirectoryBlock{
+		std::atomic<Chunk*> chunks[directory_block_size];
+	};
+
+	SegmentedColumn(const SegmentedColumn&);
+	SegmentedColumn& operator=(const SegmentedColumn&);
+
+	/*! \brief returns the chunk with number chunk_id and allocates it, if it does not exist yet*/
+	Chunk* getChunk(size_t chunk_id);
+	/*! \brief returns the chunk with number chunk_id, or NULL, if it does not exist yet*/
+	Chunk* findChunk(size_t chunk_id) const;
+	T& at(TID tid) const;
+	/*! \brief sets or clears the completion bits of the rows [begin,end), which are in one chunk*/
+	void markCompleted(Chunk* chunk, TID begin, TID end, bool completed);
+
+	std::atomic<DirectoryBlock*> directory_[number_of_directory_blocks];
+	/*! \brief number of reserved rows*/
+	std::atomic<size_t> reserved_rows_;
+	/*! \brief length of a prefix of completely written rows, which size() extends*/
+	mutable std::atomic<size_t> published_rows_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	const unsigned int SegmentedColumn<T>::chunk_bits;
+	template<class T>
+	const size_t SegmentedColumn<T>::chunk_size;
+	template<class T>
+	const size_t SegmentedColumn<T>::directory_block_size;
+	template<class T>
+	const size_t SegmentedColumn<T>::number_of_directory_blocks;
+	template<class T>
+	const size_t SegmentedColumn<T>::rows_per_completion_word;
+
+	template<class T>
+	SegmentedColumn<T>::SegmentedColumn(const std::string& name, AttributeType db_type) : ColumnBaseTyped<T>(name,db_type),
+		reserved_rows_(0), published_rows_(0){
+		for(size_t i=0;i<number_of_directory_blocks;i++){
+			directory_[i].store(NULL);
+		}
+	}
+
+	template<class T>
+	SegmentedColumn<T>::~SegmentedColumn(){
+		clearContent();
+	}
+
+	template<class T>
+	typename SegmentedColumn<T>::Chunk* SegmentedColumn<T>::getChunk(size_t chunk_id){
+		std::atomic<DirectoryBlock*>& block_slot=directory_[chunk_id/directory_block_size];
+		DirectoryBlock* block=block_slot.load(std::memory_order_acquire);
+		if(!block){
+			//value initialization sets all chunk pointers to NULL
+			DirectoryBlock* new_block=new DirectoryBlock();
+			if(block_slot.compare_exchange_strong(block,new_block)){
+				block=new_block;
+			}else{
+				//another thread installed the block first, block now points to it
+				delete new_block;
+			}
+		}
+		std::atomic<Chunk*>& chunk_slot=block->chunks[chunk_id%directory_block_size];
+		Chunk* chunk=chunk_slot.load(std::memory_order_acquire);
+		if(!chunk){
+			Chunk* new_chunk=new Chunk();
+			if(chunk_slot.compare_exchange_strong(chunk,new_chunk)){
+				chunk=new_chunk;
+			}else{
+				delete new_chunk;
+			}
+		}
+		return chunk;
+	}
+
+	template<class T>
+	typename SegmentedColumn<T>::Chunk* SegmentedColumn<T>::findChunk(size_t chunk_id) const{
+		DirectoryBlock* block=directory_[chunk_id/directory_block_size].load(std::memory_order_acquire);
+		if(!block) return NULL;
+		return block->chunks[chunk_id%directory_block_size].load(std::memory_order_acquire);
+	}
+
+	template<class T>
+	T& SegmentedColumn<T>::at(TID tid) const{
+		size_t chunk_id=tid>>chunk_bits;
+		DirectoryBlock* block=directory_[chunk_id/directory_block_size].load(std::memory_order_acquire);
+		return block->chunks[chunk_id%directory_block_size].load(std::memory_order_acquire)->values[tid&(chunk_size-1)];
+	}
+
+	template<class T>
+	void SegmentedColumn<T>::markCompleted(Chunk* chunk, TID begin, TID end, bool completed){
+		size_t row=begin&(chunk_size-1);
+		size_t end_row=row+(end-begin);
+		while(row<end_row){
+			size_t word=row/rows_per_completion_word;
+			size_t number_of_bits=std::min(end_row,(word+1)*rows_per_completion_word)-row;
+			uint64_t mask=(number_of_bits==rows_per_completion_word ? ~uint64_t(0) : (uint64_t(1) << number_of_bits)-1) << (row%rows_per_completion_word);
+			//the release orders the writes of the values before the bits, which readers load with acquire
+			if(completed){
+				chunk->completed_rows[word].fetch_or(mask,std::memory_order_release);
+			}else{
+				chunk->completed_rows[word].fetch_and(~mask,std::memory_order_release);
+			}
+			row+=number_of_bits;
+		}
+	}
+
+	template<class T>
+	template <typename InputIterator>
+	TID SegmentedColumn<T>::append(InputIterator first, InputIterator last){
+		size_t number_of_values=std::distance(first,last);
+		size_t begin=reserved_rows_.fetch_add(number_of_values);
+		if(begin+number_of_values>chunk_size*directory_block_size*number_of_directory_blocks){
+			std::cout << "Fatal Error!!! Column " << this->name_ << " exceeds the maximal number of rows" << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		size_t tid=begin;
+		InputIterator it=first;
+		while(tid<begin+number_of_values){
+			Chunk* chunk=getChunk(tid>>chunk_bits);
+			size_t begin_of_rows=tid;
+			size_t end_of_chunk=std::min(begin+number_of_values,((tid>>chunk_bits)+1)<<chunk_bits);
+			for(;tid<end_of_chunk;++tid,++it){
+				chunk->values[tid&(chunk_size-1)]=*it;
+			}
+			markCompleted(chunk,begin_of_rows,end_of_chunk,true);
+		}
+		return begin;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::insert(const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(typeid(T)==new_value.type()){
+			T value=boost::any_cast<T>(new_value);
+			append(&value,&value+1);
+			return true;
+		}
+		return false;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::insert(const T& new_value){
+		append(&new_value,&new_value+1);
+		return true;
+	}
+
+	template <typename T>
+	template <typename InputIterator>
+	bool SegmentedColumn<T>::insert(InputIterator first, InputIterator last){
+		append(first,last);
+		return true;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::update(TID tid, const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(tid>=size()){
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+		}else if(typeid(T)==new_value.type()){
+			at(tid)=boost::any_cast<T>(new_value);
+			return true;
+		}else{
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+		}
+		return false;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+		if(!tids)
+			return false;
+		for(size_t i=0;i<tids->size();i++){
+			if(!update((*tids)[i],new_value)) return false;
+		}
+		return true;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::remove(TID tid){
+		PositionListPtr tids(new PositionList(1,tid));
+		return remove(tids);
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::remove(PositionListPtr tids){
+		if(!tids)
+			return false;
+		//test whether tid list has at least one element, if not, return with error
+		if(tids->empty())
+			return false;
+
+		//compact the rows in one pass, every row moves by the number of removed rows before it
+		size_t number_of_rows=size();
+		TID write_position=(*tids)[0];
+		size_t next_removed=0;
+		for(TID tid=(*tids)[0];tid<number_of_rows;tid++){
+			if(next_removed<tids->size() && (*tids)[next_removed]==tid){
+				++next_removed;
+				continue;
+			}
+			at(write_position++)=at(tid);
+		}
+		//the rows behind the remaining rows are reserved again by the next appends, which set their bits
+		for(TID tid=write_position;tid<number_of_rows;){
+			TID end_of_chunk=std::min<TID>(number_of_rows,((tid>>chunk_bits)+1)<<chunk_bits);
+			markCompleted(findChunk(tid>>chunk_bits),tid,end_of_chunk,false);
+			tid=end_of_chunk;
+		}
+		reserved_rows_.store(write_position);
+		published_rows_.store(write_position);
+		return true;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::clearContent(){
+		for(size_t i=0;i<number_of_directory_blocks;i++){
+			DirectoryBlock* block=directory_[i].exchange(NULL);
+			if(!block) continue;
+			for(size_t j=0;j<directory_block_size;j++){
+				delete block->chunks[j].load();
+			}
+			delete block;
+		}
+		reserved_rows_.store(0);
+		published_rows_.store(0);
+		return true;
+	}
+
+	template<class T>
+	const boost::any SegmentedColumn<T>::get(TID tid){
+		if(tid<size())
+			return boost::any(at(tid));
+		else{
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+		}
+		return boost::any();
+	}
+
+	template<class T>
+	void SegmentedColumn<T>::print() const throw(){
+		std::cout << "| " << this->name_ << " |" << std::endl;
+		std::cout << "________________________" << std::endl;
+		size_t number_of_rows=size();
+		for(TID i=0;i<number_of_rows;i++){
+			std::cout << "| " << at(i) << " |" << std::endl;
+		}
+	}
+
+	template<class T>
+	size_t SegmentedColumn<T>::size() const throw(){
+		size_t published_rows=published_rows_.load(std::memory_order_acquire);
+		size_t reserved_rows=reserved_rows_.load(std::memory_order_acquire);
+		//extend the prefix over the completed rows behind it, 64 rows per word of the bitmap
+		size_t completed_rows=published_rows;
+		while(completed_rows<reserved_rows){
+			Chunk* chunk=findChunk(completed_rows>>chunk_bits);
+			if(!chunk) break;
+			size_t row=completed_rows&(chunk_size-1);
+			uint64_t bits=chunk->completed_rows[row/rows_per_completion_word].load(std::memory_order_acquire) >> (row%rows_per_completion_word);
+			size_t number_of_bits=rows_per_completion_word-row%rows_per_completion_word;
+			size_t number_of_completed_rows=~bits==0 ? number_of_bits : std::min<size_t>(number_of_bits,__builtin_ctzll(~bits));
+			if(number_of_completed_rows==0) break;
+			completed_rows+=number_of_completed_rows;
+		}
+		completed_rows=std::min(completed_rows,reserved_rows);
+		//other readers may have extended the prefix further in the meantime
+		while(published_rows<completed_rows && !published_rows_.compare_exchange_weak(published_rows,completed_rows,std::memory_order_acq_rel)){
+		}
+		return std::max(published_rows,completed_rows);
+	}
+
+	template<class T>
+	size_t SegmentedColumn<T>::getSizeinBytes() const throw(){
+		size_t number_of_chunks=(reserved_rows_.load()+chunk_size-1)/chunk_size;
+		return number_of_chunks*sizeof(Chunk);
+	}
+
+	template<class T>
+	const ColumnPtr SegmentedColumn<T>::copy() const{
+		SegmentedColumn<T>* column=new SegmentedColumn<T>(this->name_,this->db_type_);
+		size_t number_of_rows=size();
+		for(TID tid=0;tid<number_of_rows;tid+=chunk_size){
+			const T* chunk=&at(tid);
+			size_t number_of_values=std::min(chunk_size,number_of_rows-tid);
+			column->append(chunk,chunk+number_of_values);
+		}
+		return ColumnPtr(column);
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::store(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		std::vector<T> values;
+		size_t number_of_rows=size();
+		values.reserve(number_of_rows);
+		for(TID tid=0;tid<number_of_rows;tid++){
+			values.push_back(at(tid));
+		}
+		//same file format as Column<T>
+		std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
+		boost::archive::binary_oarchive oa(outfile);
+		oa << values;
+		outfile.flush();
+		outfile.close();
+		return true;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::load(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		std::vector<T> values;
+		ColumnInputFile infile (path);
+		boost::archive::binary_iarchive ia(infile);
+		ia >> values;
+		infile.close();
+		//the loaded rows replace the current rows, clearContent() frees the chunks with their completion bitmaps
+		clearContent();
+		append(values.begin(),values.end());
+		return true;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::isMaterialized() const  throw(){
+		return true;
+	}
+
+	template<class T>
+	bool SegmentedColumn<T>::isCompressed() const  throw(){
+		return false;
+	}
+
+	template<class T>
+	T& SegmentedColumn<T>::operator[](const TID index){
+		return at(index);
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,519 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <fstream>
+
+#include <boost/utility/string_view.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <core/column_base_typed.hpp>
+#include <core/decode_buffer.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *
+ *
+ *  \brief     This class represents an uncompressed VARCHAR column, which stores the bytes of all strings in one contiguous heap.
+ *  \details   Every row is described by a reference into the heap: a 64 bit offset, a 64 bit length and the first four bytes of the
+ *  string as inline prefix, so the heap may grow beyond 4 GB. Comparisons first compare the prefixes, which decides most comparisons without touching the heap.
+ *  selection, sort and hash_join work on string views into the heap. Updated and removed strings leave dead bytes in the heap, which
+ *  are reclaimed by compactHeap() as soon as they make up half of the heap. An update of many rows stores the new string once, the rows
+ *  share it and its bytes are dead, when the last of them is updated or removed. operator[] has to return a std::string and copies the
+ *  string into a DecodeBuffer, use getView() to avoid the copy. The column calls the modification hooks, so it keeps its sortedness,
+ *  indexes and statistics, which selection(), sort() and hash_join() use like the other columns.
+ */
+class StringHeapColumn : public ColumnBaseTyped<std::string>{
+	public:
+	typedef boost::string_view StringView;
+	/***************** constructors and destructor *****************/
+	StringHeapColumn(const std::string& name, AttributeType db_type);
+	virtual ~StringHeapColumn();
+
+	virtual bool insert(const boost::any& new_value);
+	bool insert(const std::string& new_value);
+	template <typename InputIterator>
+	bool insert(InputIterator first, InputIterator last);
+
+	virtual bool update(TID tid, const boost::any& new_value);
+	virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+	virtual bool remove(TID tid);
+	//assumes tid list is sorted ascending
+	virtual bool remove(PositionListPtr tid);
+	virtual bool clearContent();
+
+	virtual const boost::any get(TID tid);
+	virtual std::string getValue(TID tid);
+	virtual void print() const throw();
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	virtual const ColumnPtr copy() const;
+
+	virtual const PositionListPtr sort(SortOrder order);
+	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+	virtual const PositionListPairPtr hash_join(ColumnPtr join_column);
+
+	virtual bool store(const std::string& path);
+	virtual bool load(const std::string& path);
+	virtual bool isMaterialized() const  throw();
+	virtual bool isCompressed() const  throw();
+
+	virtual std::string& operator[](const TID index);
+	virtual void gather(const PositionList& tids, std::string* output);
+
+	/*! \brief returns a view of the string on position tid, the view is invalidated by the next modification of the column*/
+	StringView getView(TID tid) const;
+	/*! \brief rewrites the heap without the bytes of updated and removed strings*/
+	void compactHeap();
+
+	private:
+	struct StringReference{
+		uint64_t offset;
+		uint64_t length;
+		/*! first four bytes of the string in big endian order, padded with zeros*/
+		uint32_t prefix;
+	};
+
+	/*! \brief returns the first four bytes of value as integer, whose order is the lexicographical order of the bytes*/
+	static uint32_t computePrefix(const StringView& value);
+	/*! \brief copies value to the end of the heap and returns a reference to it*/
+	StringReference append(const StringView& value);
+	/*! \brief returns true, if the string of reference is lexicographically smaller than value (with prefix value_prefix)*/
+	bool isLesser(const StringReference& reference, const StringView& value, uint32_t value_prefix) const;
+	bool isEqual(const StringReference& reference, const StringView& value, uint32_t value_prefix) const;
+	StringView getView(const StringReference& reference) const;
+	/*! \brief compacts the heap when at least half of it consists of dead bytes*/
+	void compactHeapIfNecessary();
+	/*! \brief counts the bytes of reference as dead, unless other rows still share them*/
+	void release(const StringReference& reference);
+	/*! \brief returns true, if more than one row references the string of reference*/
+	bool isShared(const StringReference& reference) const;
+
+	std::vector<char> heap_;
+	std::vector<StringReference> references_;
+	/*! number of heap bytes, which belong to updated or removed strings*/
+	size_t dead_bytes_;
+	/*! number of rows per heap offset of a non empty string, which is shared by several rows*/
+	boost::unordered_map<uint64_t,size_t> shared_strings_;
+	DecodeBuffer<std::string> decode_buffer_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	inline StringHeapColumn::StringHeapColumn(const std::string& name, AttributeType db_type) : ColumnBaseTyped<std::string>(name,db_type),
+		heap_(), references_(), dead_bytes_(0), shared_strings_(), decode_buffer_(){
+		this->is_sorted_=true;
+		this->maintains_indexes_=true;
+	}
+
+	inline StringHeapColumn::~StringHeapColumn(){
+
+	}
+
+	inline uint32_t StringHeapColumn::computePrefix(const StringView& value){
+		uint32_t prefix=0;
+		for(unsigned int i=0;i<4;i++){
+			prefix<<=8;
+			if(i<value.size()) prefix|=static_cast<unsigned char>(value[i]);
+		}
+		return prefix;
+	}
+
+	inline StringHeapColumn::StringReference StringHeapColumn::append(const StringView& value){
+		StringReference reference;
+		reference.offset=heap_.size();
+		reference.length=value.size();
+		reference.prefix=computePrefix(value);
+		heap_.insert(heap_.end(),value.begin(),value.end());
+		return reference;
+	}
+
+	inline StringHeapColumn::StringView StringHeapColumn::getView(const StringReference& reference) const{
+		if(reference.length==0) return StringView();
+		return StringView(&heap_[reference.offset],reference.length);
+	}
+
+	inline StringHeapColumn::StringView StringHeapColumn::getView(TID tid) const{
+		return getView(references_[tid]);
+	}
+
+	inline bool StringHeapColumn::isLesser(const StringReference& reference, const StringView& value, uint32_t value_prefix) const{
+		if(reference.prefix!=value_prefix) return reference.prefix<value_prefix;
+		return getView(reference).compare(value)<0;
+	}
+
+	inline bool StringHeapColumn::isEqual(const StringReference& reference, const StringView& value, uint32_t value_prefix) const{
+		if(reference.prefix!=value_prefix || reference.length!=value.size()) return false;
+		if(reference.length<=4) return true;
+		return std::memcmp(&heap_[reference.offset],value.data(),reference.length)==0;
+	}
+
+	inline bool StringHeapColumn::insert(const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(typeid(std::string)==new_value.type()){
+			return insert(boost::any_cast<std::string>(new_value));
+		}
+		return false;
+	}
+
+	inline bool StringHeapColumn::insert(const std::string& new_value){
+		this->beforeInsert(new_value);
+		references_.push_back(append(new_value));
+		return true;
+	}
+
+	template <typename InputIterator>
+	bool StringHeapColumn::insert(InputIterator first, InputIterator last){
+		size_t old_size=references_.size();
+		for(InputIterator it=first;it!=last;++it){
+			references_.push_back(append(*it));
+		}
+		this->afterBulkInsert(old_size);
+		return true;
+	}
+
+	inline bool StringHeapColumn::update(TID tid, const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(tid>=references_.size()){
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+			return false;
+		}
+		if(typeid(std::string)==new_value.type()){
+			const std::string& value=boost::any_cast<const std::string&>(new_value);
+			this->beforeUpdate(tid,value);
+			release(references_[tid]);
+			references_[tid]=append(value);
+			compactHeapIfNecessary();
+			return true;
+		}else{
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+		}
+		return false;
+	}
+
+	inline bool StringHeapColumn::update(PositionListPtr tids, const boost::any& new_value){
+		if(!tids)
+			return false;
+		if(new_value.empty() || typeid(std::string)!=new_value.type()) return false;
+		for(size_t i=0;i<tids->size();i++){
+			if((*tids)[i]>=references_.size()) return false;
+		}
+		if(tids->empty()) return true;
+		//all rows share one copy of the new value
+		const std::string& value=boost::any_cast<const std::string&>(new_value);
+		StringReference reference=append(value);
+		size_t number_of_rows=0;
+		for(size_t i=0;i<tids->size();i++){
+			TID tid=(*tids)[i];
+			//only rows of this update reference the appended bytes, so a duplicate TID is updated and counted once
+			if(references_[tid].offset==reference.offset && references_[tid].length==reference.length) continue;
+			this->beforeUpdate(tid,value);
+			release(references_[tid]);
+			references_[tid]=reference;
+			++number_of_rows;
+		}
+		if(number_of_rows>1 && reference.length>0) shared_strings_[reference.offset]=number_of_rows;
+		compactHeapIfNecessary();
+		return true;
+	}
+
+	inline bool StringHeapColumn::remove(TID tid){
+		if(tid>=references_.size()) return false;
+		this->beforeRemove(PositionList(1,tid));
+		release(references_[tid]);
+		references_.erase(references_.begin()+tid);
+		compactHeapIfNecessary();
+		return true;
+	}
+
+	inline bool StringHeapColumn::remove(PositionListPtr tids){
+		if(!tids)
+			return false;
+		//test whether tid list has at least one element, if not, return with error
+		if(tids->empty())
+			return false;
+
+		this->beforeRemove(*tids);
+		//compact the references in one pass, every row moves by the number of removed rows before it
+		TID write_position=(*tids)[0];
+		size_t next_removed=0;
+		for(TID tid=(*tids)[0];tid<references_.size();tid++){
+			if(next_removed<tids->size() && (*tids)[next_removed]==tid){
+				release(references_[tid]);
+				++next_removed;
+				continue;
+			}
+			references_[write_position++]=references_[tid];
+		}
+		references_.resize(write_position);
+		compactHeapIfNecessary();
+		return true;
+	}
+
+	inline bool StringHeapColumn::clearContent(){
+		heap_.clear();
+		references_.clear();
+		dead_bytes_=0;
+		shared_strings_.clear();
+		this->afterClear();
+		return true;
+	}
+
+	inline void StringHeapColumn::compactHeapIfNecessary(){
+		if(dead_bytes_>4096 && 2*dead_bytes_>heap_.size()){
+			compactHeap();
+		}
+	}
+
+	inline void StringHeapColumn::release(const StringReference& reference){
+		if(isShared(reference)){
+			boost::unordered_map<uint64_t,size_t>::iterator it=shared_strings_.find(reference.offset);
+			if(--it->second>0) return;
+			shared_strings_.erase(it);
+		}
+		dead_bytes_+=reference.length;
+	}
+
+	inline bool StringHeapColumn::isShared(const StringReference& reference) const{
+		return reference.length>0 && !shared_strings_.empty() && shared_strings_.find(reference.offset)!=shared_strings_.end();
+	}
+
+	inline void StringHeapColumn::compactHeap(){
+		typedef boost::unordered_map<uint64_t,uint64_t> OffsetMap;
+		//the live bytes are counted again, dead_bytes_ only triggers the compaction, a shared string is live once
+		size_t live_bytes=0;
+		OffsetMap new_offsets;
+		for(TID i=0;i<references_.size();i++){
+			if(!isShared(references_[i]) || new_offsets.insert(std::make_pair(references_[i].offset,0)).second){
+				live_bytes+=references_[i].length;
+			}
+		}
+		new_offsets.clear();
+		std::vector<char> heap;
+		heap.reserve(live_bytes);
+		boost::unordered_map<uint64_t,size_t> shared_strings;
+		for(TID i=0;i<references_.size();i++){
+			StringReference& reference=references_[i];
+			uint64_t offset=heap.size();
+			if(isShared(reference)){
+				//the first row of a shared string copies it, the other rows are redirected to the copy
+				std::pair<OffsetMap::iterator,bool> copied=new_offsets.insert(std::make_pair(reference.offset,offset));
+				if(!copied.second){
+					reference.offset=copied.first->second;
+					continue;
+				}
+				shared_strings[offset]=shared_strings_.find(reference.offset)->second;
+			}
+			StringView value=getView(reference);
+			reference.offset=offset;
+			heap.insert(heap.end(),value.begin(),value.end());
+		}
+		heap_.swap(heap);
+		shared_strings_.swap(shared_strings);
+		dead_bytes_=0;
+	}
+
+	inline const boost::any StringHeapColumn::get(TID tid){
+		if(tid<references_.size())
+			return boost::any(getView(tid).to_string());
+		else{
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+		}
+		return boost::any();
+	}
+
+	inline std::string StringHeapColumn::getValue(TID tid){
+		return getView(tid).to_string();
+	}
+
+	inline void StringHeapColumn::print() const throw(){
+		std::cout << "| " << this->name_ << " |" << std::endl;
+		std::cout << "________________________" << std::endl;
+		for(TID i=0;i<references_.size();i++){
+			std::cout << "| " << getView(i) << " |" << std::endl;
+		}
+	}
+
+	inline size_t StringHeapColumn::size() const throw(){
+		return references_.size();
+	}
+
+	inline size_t StringHeapColumn::getSizeinBytes() const throw(){
+		//a node of the hash table of the shared strings stores the offset, the number of rows and the pointer to the next node
+		return heap_.capacity()+references_.capacity()*sizeof(StringReference)+shared_strings_.size()*(sizeof(uint64_t)+sizeof(size_t)+sizeof(void*))
+			+this->getIndexSizeinBytes();
+	}
+
+	inline const ColumnPtr StringHeapColumn::copy() const{
+		return ColumnPtr(new StringHeapColumn(*this));
+	}
+
+	inline const PositionListPtr StringHeapColumn::sort(SortOrder order){
+		if(is_sorted_) return ColumnBaseTyped<std::string>::sort(order);
+		PositionListPtr ids(new PositionList(references_.size()));
+		for(TID i=0;i<ids->size();i++){
+			(*ids)[i]=i;
+		}
+		const StringHeapColumn& column=*this;
+		if(order==ASCENDING){
+			std::stable_sort(ids->begin(),ids->end(),[&column](TID a, TID b){
+				const StringReference& b_reference=column.references_[b];
+				return column.isLesser(column.references_[a],column.getView(b_reference),b_reference.prefix);
+			});
+		}else if(order==DESCENDING){
+			std::stable_sort(ids->begin(),ids->end(),[&column](TID a, TID b){
+				const StringReference& a_reference=column.references_[a];
+				return column.isLesser(column.references_[b],column.getView(a_reference),a_reference.prefix);
+			});
+		}else{
+			std::cout << "FATAL ERROR: StringHeapColumn::sort(): Unknown Sorting Order!" << std::endl;
+		}
+		return ids;
+	}
+
+	inline const PositionListPtr StringHeapColumn::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+		if(value_for_comparison.type()!=typeid(std::string)){
+			std::cout << "Fatal Error!!! Typemismatch for column " << name_ << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		//binary search and index scan of the base class, the scan below compares prefixes instead of materializing the strings
+		if(is_sorted_ || hash_index_ || bplus_tree_index_ || cracker_index_){
+			return ColumnBaseTyped<std::string>::selection(value_for_comparison,comp);
+		}
+		const std::string& value=boost::any_cast<const std::string&>(value_for_comparison);
+		uint32_t prefix=computePrefix(value);
+		PositionListPtr result_tids(new PositionList());
+
+		if(comp==EQUAL){
+			for(TID i=0;i<references_.size();i++){
+				if(isEqual(references_[i],value,prefix)) result_tids->push_back(i);
+			}
+		}else if(comp==LESSER){
+			for(TID i=0;i<references_.size();i++){
+				if(isLesser(references_[i],value,prefix)) result_tids->push_back(i);
+			}
+		}else if(comp==GREATER){
+			for(TID i=0;i<references_.size();i++){
+				if(!isLesser(references_[i],value,prefix) && !isEqual(references_[i],value,prefix)) result_tids->push_back(i);
+			}
+		}
+		return result_tids;
+	}
+
+	inline const PositionListPairPtr StringHeapColumn::hash_join(ColumnPtr join_column_){
+		typedef boost::unordered_multimap<StringView,TID,boost::hash<StringView>, std::equal_to<StringView> > HashTable;
+
+		if(join_column_->type()!=typeid(std::string)){
+			std::cout << "Fatal Error!!! Typemismatch for columns " << this->name_  << " and " << join_column_->getName() << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+
+		PositionListPairPtr join_tids( new PositionListPair());
+		join_tids->first = PositionListPtr( new PositionList() );
+		join_tids->second = PositionListPtr( new PositionList() );
+
+		//create hash table and a Bloom filter over views into the heap
+		HashTable hashtable;
+		BloomFilter bloom_filter(references_.size());
+		for(TID i=0;i<references_.size();i++){
+			StringView value=getView(i);
+			hashtable.insert(std::pair<StringView,TID>(value,i));
+			bloom_filter.insert(BloomFilter::hash(value));
+		}
+
+		//probe with views as well, if the join column has a string heap, otherwise with the materialized strings
+		StringHeapColumn* string_heap_join_column=dynamic_cast<StringHeapColumn*>(join_column_.get());
+		shared_pointer_namespace::shared_ptr<ColumnBaseTyped<std::string> > join_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<std::string> >(join_column_);
+		for(TID i=0;i<join_column->size();i++){
+			StringView value = string_heap_join_column ? string_heap_join_column->getView(i) : StringView((*join_column)[i]);
+			//only rows passing the Bloom filter access the hash table
+			if(!bloom_filter.contains(BloomFilter::hash(value))) continue;
+			std::pair<HashTable::iterator, HashTable::iterator> range = hashtable.equal_range(value);
+			for(HashTable::iterator it=range.first;it!=range.second;it++){
+				join_tids->first->push_back(it->second);
+				join_tids->second->push_back(i);
+			}
+		}
+		return join_tids;
+	}
+
+	inline bool StringHeapColumn::store(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		compactHeap();
+		//shared strings are stored once, so the offsets are stored with the lengths, the prefixes are computed again by load()
+		std::vector<uint64_t> offsets(references_.size());
+		std::vector<uint64_t> lengths(references_.size());
+		for(TID i=0;i<references_.size();i++){
+			offsets[i]=references_[i].offset;
+			lengths[i]=references_[i].length;
+		}
+		std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
+		boost::archive::binary_oarchive oa(outfile);
+		oa << offsets;
+		oa << lengths;
+		oa << heap_;
+		outfile.flush();
+		outfile.close();
+		return this->storeIndexes(path_);
+	}
+
+	inline bool StringHeapColumn::load(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		std::vector<uint64_t> offsets;
+		std::vector<uint64_t> lengths;
+		ColumnInputFile infile (path);
+		boost::archive::binary_iarchive ia(infile);
+		ia >> offsets;
+		ia >> lengths;
+		ia >> heap_;
+		infile.close();
+
+		references_.resize(lengths.size());
+		shared_strings_.clear();
+		for(size_t i=0;i<lengths.size();i++){
+			references_[i].offset=offsets[i];
+			references_[i].length=lengths[i];
+			references_[i].prefix=computePrefix(getView(references_[i]));
+			if(lengths[i]>0) ++shared_strings_[offsets[i]];
+		}
+		//only strings of more than one row are shared
+		for(boost::unordered_map<uint64_t,size_t>::iterator it=shared_strings_.begin();it!=shared_strings_.end();){
+			if(it->second==1) it=shared_strings_.erase(it); else ++it;
+		}
+		dead_bytes_=0;
+		this->afterLoad(path_);
+		return true;
+	}
+
+	inline bool StringHeapColumn::isMaterialized() const  throw(){
+		return true;
+	}
+
+	inline bool StringHeapColumn::isCompressed() const  throw(){
+		return false;
+	}
+
+	inline void StringHeapColumn::gather(const PositionList& tids, std::string* output){
+		for(size_t i=0;i<tids.size();i++){
+			StringView value=getView(tids[i]);
+			output[i].assign(value.data(),value.size());
+		}
+	}
+
+	inline std::string& StringHeapColumn::operator[](const TID index){
+		return decode_buffer_.store(getView(index).to_string());
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
@@ -0,0 +1,517 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <fstream>
+
+#include <core/column_base_typed.hpp>
+#include <core/epoch_manager.hpp>
+
+namespace CoGaDB{
+
+/*!
+ *
+ *
+ *  \brief     This class represents an uncompressed column with type T, which can be read by many threads while another thread modifies it.
+ *  \details   The values are stored in fixed size segments. A version of the column consists of its size and the directory of its segments and is
+ *  never modified after it was published. Readers pin the current version with a Snapshot and scan it without locks. Writers are serialized
+ *  by a mutex and publish a new version: appends write to slots of the last segment, which no published version can see yet, every other
+ *  modification copies the segments it changes (copy on write). Replaced versions are reclaimed with epoch based reclamation, segments are
+ *  reference counted and shared between versions.
+ *  selection, sort and the joins run on a snapshot. operator[] reads the current version and is only safe without concurrent writers,
+ *  writing through the returned reference (e.g., in the column algebra operations) is not versioned.
+ */
+template<class T>
+class VersionedColumn : public ColumnBaseTyped<T>{
+	public:
+	/*! \brief number of values per segment*/
+	static const size_t segment_size=4096;
+	typedef std::vector<T> Segment;
+	typedef shared_pointer_namespace::shared_ptr<Segment> SegmentPtr;
+	typedef std::vector<SegmentPtr> SegmentDirectory;
+	typedef shared_pointer_namespace::shared_ptr<const SegmentDirectory> SegmentDirectoryPtr;
+
+	/*! \brief immutable state of the column at one point in time*/
+	struct Version{
+		Version(size_t size, SegmentDirectoryPtr segments);
+		size_t size;
+		SegmentDirectoryPtr segments;
+	};
+
+	/*! \brief pins the current version of a column, the version stays readable until the snapshot is destroyed
+	 *  \details A snapshot has to be destroyed by the thread that created it.*/
+	class Snapshot{
+		public:
+		explicit Snapshot(const VersionedColumn<T>& column);
+		size_t size() const;
+		const T& operator[](TID tid) const;
+		size_t getNumberOfSegments() const;
+		/*! \brief returns the values of segment segment_id*/
+		const T* getSegment(size_t segment_id) const;
+		/*! \brief returns the number of values of segment segment_id, which belong to this version*/
+		size_t getSegmentSize(size_t segment_id) const;
+		private:
+		Snapshot(const Snapshot&);
+		Snapshot& operator=(const Snapshot&);
+		EpochManager::Guard guard_;
+		const Version* version_;
+	};
+
+	/***************** constructors and destructor *****************/
+	VersionedColumn(const std::string& name, AttributeType db_type);
+	virtual ~VersionedColumn();
+
+	virtual bool insert(const boost::any& new_value);
+	bool insert(const T& new_value);
+	template <typename InputIterator>
+	bool insert(InputIterator first, InputIterator last);
+
+	virtual bool update(TID tid, const boost::any& new_value);
+	virtual bool update(PositionListPtr tid, const boost::any& new_value);
+
+	virtual bool remove(TID tid);
+	//assumes tid list is sorted ascending
+	virtual bool remove(PositionListPtr tid);
+	virtual bool clearContent();
+
+	virtual const boost::any get(TID tid);
+	virtual void print() const throw();
+	virtual size_t size() const throw();
+	virtual size_t getSizeinBytes() const throw();
+
+	/*! \brief the copy shares all full segments with this column*/
+	virtual const ColumnPtr copy() const;
+
+	virtual const PositionListPtr sort(SortOrder order);
+	virtual const PositionListPtr selection(const boost::any& value_for_comparison, const ValueComparator comp);
+	virtual const PositionListPairPtr hash_join(ColumnPtr join_column);
+
+	virtual bool store(const std::string& path);
+	virtual bool load(const std::string& path);
+	virtual bool isMaterialized() const  throw();
+	virtual bool isCompressed() const  throw();
+
+	virtual T& operator[](const TID index);
+
+	private:
+	VersionedColumn(const VersionedColumn&);
+	VersionedColumn& operator=(const VersionedColumn&);
+
+	/*! \brief makes version the current version and retires the old one, the caller has to hold the write lock*/
+	void publish(Version* version);
+	/*! \brief appends values without publishing, returns the new segment directory, the caller has to hold the write lock*/
+	template <typename InputIterator>
+	SegmentDirectoryPtr append(const Version& version, InputIterator first, InputIterator last);
+	/*! \brief returns the values of a snapshot as a plain vector*/
+	static std::vector<T> materialize(const Snapshot& snapshot);
+
+	std::atomic<Version*> current_version_;
+	std::mutex write_mutex_;
+};
+
+
+/***************** Start of Implementation Section ******************/
+
+	template<class T>
+	const size_t VersionedColumn<T>::segment_size;
+
+	template<class T>
+	VersionedColumn<T>::Version::Version(size_t size_, SegmentDirectoryPtr segments_) : size(size_), segments(segments_){
+
+	}
+
+	template<class T>
+	VersionedColumn<T>::Snapshot::Snapshot(const VersionedColumn<T>& column) : guard_(), version_(column.current_version_.load()){
+
+	}
+
+	template<class T>
+	size_t VersionedColumn<T>::Snapshot::size() const{
+		return version_->size;
+	}
+
+	template<class T>
+	const T& VersionedColumn<T>::Snapshot::operator[](TID tid) const{
+		return (*(*version_->segments)[tid/segment_size])[tid%segment_size];
+	}
+
+	template<class T>
+	size_t VersionedColumn<T>::Snapshot::getNumberOfSegments() const{
+		return (version_->size+segment_size-1)/segment_size;
+	}
+
+	template<class T>
+	const T* VersionedColumn<T>::Snapshot::getSegment(size_t segment_id) const{
+		return &(*(*version_->segments)[segment_id])[0];
+	}
+
+	template<class T>
+	size_t VersionedColumn<T>::Snapshot::getSegmentSize(size_t segment_id) const{
+		return std::min(segment_size,version_->size-segment_id*segment_size);
+	}
+
+	template<class T>
+	VersionedColumn<T>::VersionedColumn(const std::string& name, AttributeType db_type) : ColumnBaseTyped<T>(name,db_type),
+		current_version_(new Version(0,SegmentDirectoryPtr(new SegmentDirectory()))), write_mutex_(){
+
+	}
+
+	template<class T>
+	VersionedColumn<T>::~VersionedColumn(){
+		//no reader may use a column while it is destroyed, so the last version can be deleted directly
+		delete current_version_.load();
+	}
+
+	template<class T>
+	void VersionedColumn<T>::publish(Version* version){
+		Version* old_version=current_version_.exchange(version);
+		EpochManager::instance().retire(old_version);
+	}
+
+	template<class T>
+	template <typename InputIterator>
+	typename VersionedColumn<T>::SegmentDirectoryPtr VersionedColumn<T>::append(const Version& version, InputIterator first, InputIterator last){
+		SegmentDirectoryPtr segments=version.segments;
+		shared_pointer_namespace::shared_ptr<SegmentDirectory> new_segments;
+		size_t size=version.size;
+		for(InputIterator it=first;it!=last;++it){
+			if(size==segments->size()*segment_size){
+				//the last segment is full, only now the directory has to be copied
+				if(!new_segments){
+					new_segments.reset(new SegmentDirectory(*segments));
+					segments=new_segments;
+				}
+				new_segments->push_back(SegmentPtr(new Segment(segment_size)));
+			}
+			//slots behind the size of the current version are invisible to all readers
+			(*segments->back())[size%segment_size]=*it;
+			++size;
+		}
+		return segments;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::insert(const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(typeid(T)==new_value.type()){
+			return insert(boost::any_cast<T>(new_value));
+		}
+		return false;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::insert(const T& new_value){
+		return insert(&new_value,&new_value+1);
+	}
+
+	template <typename T>
+	template <typename InputIterator>
+	bool VersionedColumn<T>::insert(InputIterator first, InputIterator last){
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		const Version* version=current_version_.load();
+		size_t number_of_values=std::distance(first,last);
+		if(number_of_values==0) return true;
+		SegmentDirectoryPtr segments=append(*version,first,last);
+		publish(new Version(version->size+number_of_values,segments));
+		return true;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::update(TID tid, const boost::any& new_value){
+		if(new_value.empty()) return false;
+		if(typeid(T)!=new_value.type()){
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+			return false;
+		}
+		PositionListPtr tids(new PositionList(1,tid));
+		return update(tids,new_value);
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::update(PositionListPtr tids, const boost::any& new_value){
+		if(!tids) return false;
+		if(new_value.empty() || typeid(T)!=new_value.type()) return false;
+		T value=boost::any_cast<T>(new_value);
+
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		const Version* version=current_version_.load();
+		shared_pointer_namespace::shared_ptr<SegmentDirectory> segments(new SegmentDirectory(*version->segments));
+		std::vector<bool> copied_segments(segments->size(),false);
+		for(size_t i=0;i<tids->size();i++){
+			TID tid=(*tids)[i];
+			if(tid>=version->size) return false;
+			size_t segment_id=tid/segment_size;
+			//copy each modified segment once, readers of older versions keep the original
+			if(!copied_segments[segment_id]){
+				(*segments)[segment_id]=SegmentPtr(new Segment(*(*segments)[segment_id]));
+				copied_segments[segment_id]=true;
+			}
+			(*(*segments)[segment_id])[tid%segment_size]=value;
+		}
+		publish(new Version(version->size,segments));
+		return true;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::remove(TID tid){
+		PositionListPtr tids(new PositionList(1,tid));
+		return remove(tids);
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::remove(PositionListPtr tids){
+		if(!tids)
+			return false;
+		//test whether tid list has at least one element, if not, return with error
+		if(tids->empty())
+			return false;
+
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		const Version* version=current_version_.load();
+		//removing shifts all rows behind the first removed row, so the segments from there on are rebuilt
+		size_t first_segment=(*tids)[0]/segment_size;
+		Version prefix(first_segment*segment_size,
+			SegmentDirectoryPtr(new SegmentDirectory(version->segments->begin(),version->segments->begin()+first_segment)));
+		std::vector<T> values;
+		values.reserve(version->size-prefix.size);
+		size_t next_removed=0;
+		for(TID tid=prefix.size;tid<version->size;tid++){
+			if(next_removed<tids->size() && (*tids)[next_removed]==tid){
+				++next_removed;
+				continue;
+			}
+			values.push_back((*(*version->segments)[tid/segment_size])[tid%segment_size]);
+		}
+		SegmentDirectoryPtr segments=append(prefix,values.begin(),values.end());
+		publish(new Version(prefix.size+values.size(),segments));
+		return true;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::clearContent(){
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		publish(new Version(0,SegmentDirectoryPtr(new SegmentDirectory())));
+		return true;
+	}
+
+	template<class T>
+	const boost::any VersionedColumn<T>::get(TID tid){
+		Snapshot snapshot(*this);
+		if(tid<snapshot.size())
+			return boost::any(snapshot[tid]);
+		else{
+			std::cout << "fatal Error!!! Invalid TID!!! Attribute: " << this->name_ << " TID: " << tid  << std::endl;
+		}
+		return boost::any();
+	}
+
+	template<class T>
+	void VersionedColumn<T>::print() const throw(){
+		Snapshot snapshot(*this);
+		std::cout << "| " << this->name_ << " |" << std::endl;
+		std::cout << "________________________" << std::endl;
+		for(TID i=0;i<snapshot.size();i++){
+			std::cout << "| " << snapshot[i] << " |" << std::endl;
+		}
+	}
+
+	template<class T>
+	size_t VersionedColumn<T>::size() const throw(){
+		Snapshot snapshot(*this);
+		return snapshot.size();
+	}
+
+	template<class T>
+	size_t VersionedColumn<T>::getSizeinBytes() const throw(){
+		Snapshot snapshot(*this);
+		return snapshot.getNumberOfSegments()*segment_size*sizeof(T);
+	}
+
+	template<class T>
+	const ColumnPtr VersionedColumn<T>::copy() const{
+		Snapshot snapshot(*this);
+		VersionedColumn<T>* column=new VersionedColumn<T>(this->name_,this->db_type_);
+		size_t number_of_full_segments=snapshot.size()/segment_size;
+		const Version* version=current_version_.load();
+		//full segments are never written again and can be shared, the partially filled last segment receives appends and is copied
+		Version prefix(number_of_full_segments*segment_size,
+			SegmentDirectoryPtr(new SegmentDirectory(version->segments->begin(),version->segments->begin()+number_of_full_segments)));
+		std::vector<T> tail;
+		for(TID tid=prefix.size;tid<snapshot.size();tid++){
+			tail.push_back(snapshot[tid]);
+		}
+		delete column->current_version_.exchange(new Version(snapshot.size(),column->append(prefix,tail.begin(),tail.end())));
+		return ColumnPtr(column);
+	}
+
+	template<class T>
+	std::vector<T> VersionedColumn<T>::materialize(const Snapshot& snapshot){
+		std::vector<T> values;
+		values.reserve(snapshot.size());
+		for(size_t segment_id=0;segment_id<snapshot.getNumberOfSegments();segment_id++){
+			const T* segment=snapshot.getSegment(segment_id);
+			values.insert(values.end(),segment,segment+snapshot.getSegmentSize(segment_id));
+		}
+		return values;
+	}
+
+	template<class T>
+	const PositionListPtr VersionedColumn<T>::sort(SortOrder order){
+		Snapshot snapshot(*this);
+		std::vector<std::pair<T,TID> > v;
+		v.reserve(snapshot.size());
+		for(TID i=0;i<snapshot.size();i++){
+			v.push_back(std::pair<T,TID>(snapshot[i],i));
+		}
+		if(order==ASCENDING){
+			std::stable_sort(v.begin(),v.end(),std::less_equal<std::pair<T,TID> >());
+		}else if(order==DESCENDING){
+			std::stable_sort(v.begin(),v.end(),std::greater_equal<std::pair<T,TID> >());
+		}else{
+			std::cout << "FATAL ERROR: VersionedColumn<T>::sort(): Unknown Sorting Order!" << std::endl;
+		}
+		PositionListPtr ids(new PositionList());
+		ids->reserve(v.size());
+		for(size_t i=0;i<v.size();i++){
+			ids->push_back(v[i].second);
+		}
+		return ids;
+	}
+
+	template<class T>
+	const PositionListPtr VersionedColumn<T>::selection(const boost::any& value_for_comparison, const ValueComparator comp){
+		if(value_for_comparison.type()!=typeid(T)){
+			std::cout << "Fatal Error!!! Typemismatch for column " << this->name_ << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+		T value=boost::any_cast<T>(value_for_comparison);
+		PositionListPtr result_tids(new PositionList());
+
+		Snapshot snapshot(*this);
+		for(size_t segment_id=0;segment_id<snapshot.getNumberOfSegments();segment_id++){
+			const T* segment=snapshot.getSegment(segment_id);
+			size_t number_of_values=snapshot.getSegmentSize(segment_id);
+			TID offset=segment_id*segment_size;
+			if(comp==EQUAL){
+				for(size_t i=0;i<number_of_values;i++){
+					if(segment[i]==value) result_tids->push_back(offset+i);
+				}
+			}else if(comp==LESSER){
+				for(size_t i=0;i<number_of_values;i++){
+					if(segment[i]<value) result_tids->push_back(offset+i);
+				}
+			}else if(comp==GREATER){
+				for(size_t i=0;i<number_of_values;i++){
+					if(segment[i]>value) result_tids->push_back(offset+i);
+				}
+			}
+		}
+		return result_tids;
+	}
+
+	template<class T>
+	const PositionListPairPtr VersionedColumn<T>::hash_join(ColumnPtr join_column_){
+		typedef boost::unordered_multimap<T,TID,boost::hash<T>, std::equal_to<T> > HashTable;
+
+		if(join_column_->type()!=typeid(T)){
+			std::cout << "Fatal Error!!! Typemismatch for columns " << this->name_  << " and " << join_column_->getName() << std::endl;
+			std::cout << "File: " << __FILE__ << " Line: " << __LINE__ << std::endl;
+			exit(-1);
+		}
+
+		PositionListPairPtr join_tids( new PositionListPair());
+		join_tids->first = PositionListPtr( new PositionList() );
+		join_tids->second = PositionListPtr( new PositionList() );
+
+		//build on a snapshot of this column
+		HashTable hashtable;
+		{
+			Snapshot snapshot(*this);
+			for(TID i=0;i<snapshot.size();i++){
+				hashtable.insert(std::pair<T,TID>(snapshot[i],i));
+			}
+		}
+
+		//probe a snapshot of the join column as well, if it is versioned
+		std::vector<T> probe_values;
+		VersionedColumn<T>* versioned_join_column=dynamic_cast<VersionedColumn<T>*>(join_column_.get());
+		if(versioned_join_column){
+			Snapshot snapshot(*versioned_join_column);
+			probe_values=materialize(snapshot);
+		}else{
+			shared_pointer_namespace::shared_ptr<ColumnBaseTyped<T> > join_column = shared_pointer_namespace::static_pointer_cast<ColumnBaseTyped<T> >(join_column_);
+			probe_values.reserve(join_column->size());
+			for(TID i=0;i<join_column->size();i++){
+				probe_values.push_back((*join_column)[i]);
+			}
+		}
+
+		for(TID i=0;i<probe_values.size();i++){
+			std::pair<typename HashTable::iterator, typename HashTable::iterator> range = hashtable.equal_range(probe_values[i]);
+			for(typename HashTable::iterator it=range.first;it!=range.second;it++){
+				if(it->first==probe_values[i]){
+					join_tids->first->push_back(it->second);
+					join_tids->second->push_back(i);
+				}
+			}
+		}
+		return join_tids;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::store(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		std::vector<T> values;
+		{
+			Snapshot snapshot(*this);
+			values=materialize(snapshot);
+		}
+		//same file format as Column<T>
+		std::ofstream outfile (path.c_str(),std::ios_base::binary | std::ios_base::out);
+		boost::archive::binary_oarchive oa(outfile);
+		oa << values;
+		outfile.flush();
+		outfile.close();
+		return true;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::load(const std::string& path_){
+		std::string path(path_);
+		path += "/";
+		path += this->name_;
+		std::vector<T> values;
+		ColumnInputFile infile (path);
+		boost::archive::binary_iarchive ia(infile);
+		ia >> values;
+		infile.close();
+
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		Version empty_version(0,SegmentDirectoryPtr(new SegmentDirectory()));
+		SegmentDirectoryPtr segments=append(empty_version,values.begin(),values.end());
+		publish(new Version(values.size(),segments));
+		return true;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::isMaterialized() const  throw(){
+		return true;
+	}
+
+	template<class T>
+	bool VersionedColumn<T>::isCompressed() const  throw(){
+		return false;
+	}
+
+	template<class T>
+	T& VersionedColumn<T>::operator[](const TID index){
+		Version* version=current_version_.load();
+		return (*(*version->segments)[index/segment_size])[index%segment_size];
+	}
+
+/***************** End of Implementation Section ******************/
+
+}; //end namespace CogaDB
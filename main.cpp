@@ -4,15 +4,36 @@
 #include <core/column_base_typed.hpp>
 #include <core/column.hpp>
 #include <core/compressed_column.hpp>
+#include <core/versioned_column.hpp>
+#include <core/segmented_column.hpp>
+#include <core/string_heap_column.hpp>
+#include <core/bit_packed_column.hpp>
 
 /*this is the include for the example compressed column with empty implementation*/
 #include <compression/dictionary_compressed_column.hpp>
 #include <compression/delta_coding_compressed_column.hpp>
+#include <compression/main_delta_column.hpp>
+#include <compression/front_coded_dictionary_column.hpp>
+#include <compression/alp_compressed_column.hpp>
 
 #include  "unittest.hpp"
 
 using namespace CoGaDB;
 
+/*a dictionary compressed main with an uncompressed delta buffer*/
+template<typename T>
+using MainDeltaDictionaryColumn = MainDeltaColumn<T, DictionaryCompressedColumn>;
+
+/*the string heap column stores strings only, the unittest expects a column template*/
+template<typename T>
+using StringHeapColumnFor = StringHeapColumn;
+
+template<typename T>
+using FrontCodedDictionaryColumnFor = FrontCodedDictionaryColumn;
+
+template<typename T>
+using BitPackedColumnFor = BitPackedColumn;
+
 int main(){
 	/*Adapt the Column to your implemented method*/
             std::cout <<"Dic: "<< std::endl;
@@ -28,12 +49,109 @@ int main(){
 	//}
 	//std::cout << "Unitests Passed!" << std::endl;
 
+	if(!unittest<AlpCompressedColumn, float>() || !test_alp_compression<float>() || !test_alp_compression<double>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!unittest<BitPackedColumnFor, bool>() || !test_bitmap_predicates()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!test_lookup_array<int>(boost::shared_ptr<ColumnBaseTyped<int> >(new Column<int>("int column",INT)))
+		|| !test_lookup_array<float>(boost::shared_ptr<ColumnBaseTyped<float> >(new AlpCompressedColumn<float>("float column",FLOAT)))
+		|| !test_lookup_array<std::string>(boost::shared_ptr<ColumnBaseTyped<std::string> >(new StringHeapColumn("string column",VARCHAR)))
+		|| !test_lookup_array<int>(boost::shared_ptr<ColumnBaseTyped<int> >(new DictionaryCompressedColumn<int>("int column",INT)))
+		|| !test_lookup_array<std::string>(boost::shared_ptr<ColumnBaseTyped<std::string> >(new DictionaryCompressedColumn<std::string>("string column",VARCHAR)))
+		|| !test_lookup_array<int>(boost::shared_ptr<ColumnBaseTyped<int> >(new DeltaCodingCompressedColumn<int>("int column",INT)))
+		|| !test_simd_gather()
+		|| !test_operator_pipeline()
+		|| !test_predicate_selection<int>(boost::shared_ptr<ColumnBaseTyped<int> >(new Column<int>("int column",INT)))
+		|| !test_predicate_selection<float>(boost::shared_ptr<ColumnBaseTyped<float> >(new AlpCompressedColumn<float>("float column",FLOAT)))
+		|| !test_predicate_selection<std::string>(boost::shared_ptr<ColumnBaseTyped<std::string> >(new StringHeapColumn("string column",VARCHAR)))
+		|| !test_sorted_selection<int>(boost::shared_ptr<ColumnBaseTyped<int> >(new Column<int>("int column",INT)),100000)
+		|| !test_sorted_selection<int>(boost::shared_ptr<ColumnBaseTyped<int> >(new DeltaCodingCompressedColumn<int>("int column",INT)),100)
+		|| !test_sorted_selection_nan<float>(boost::shared_ptr<ColumnBaseTyped<float> >(new Column<float>("float column",FLOAT)))
+		|| !test_sorted_selection_nan<double>(boost::shared_ptr<ColumnBaseTyped<double> >(new Column<double>("double column",FLOAT)))
+		|| !test_secondary_index()
+		|| !test_bloom_filter_join()
+		|| !test_shared_dictionary_join()
+		|| !test_memory_arena()
+		|| !test_managed_column()
+		|| !test_column_loader()
+		|| !test_parallel_compression()
+		|| !test_copy_on_write()
+		|| !test_typed_point_access()
+		|| !test_arithmetic_expression()
+		|| !test_column_statistics()
+		|| !test_cracker_index()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!unittest<VersionedColumn, int>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!unittest<SegmentedColumn, int>() || !test_concurrent_append() || !test_compressed_position_list()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!unittest<MainDeltaDictionaryColumn ,std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!unittest<StringHeapColumnFor ,std::string>() || !test_string_heap_shared_update()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
+	if(!unittest<FrontCodedDictionaryColumnFor ,std::string>()){
+		std::cout << "At least one Unittest Failed!" << std::endl;
+		return -1;
+	}
+	std::cout << "Unitests Passed!" << std::endl;
+
 	if(!unittest<DictionaryCompressedColumn ,std::string>()){
 		std::cout << "At least one Unittest Failed!" << std::endl;	
 		return -1;	
 	}
 	std::cout << "Unitests Passed!" << std::endl;
 
+	{
+		std::vector<std::string> reference_data(100);
+		for(unsigned int i=0;i<reference_data.size();i++){
+			reference_data[i]=get_rand_value<std::string>();
+		}
+		if(!test_dictionary_compaction<std::string>(reference_data)){
+			std::cout << "At least one Unittest Failed!" << std::endl;
+			return -1;
+		}
+		if(!test_front_coded_dictionary(reference_data)){
+			std::cout << "At least one Unittest Failed!" << std::endl;
+			return -1;
+		}
+		if(!test_main_delta_merge<DictionaryCompressedColumn, std::string>(reference_data)){
+			std::cout << "At least one Unittest Failed!" << std::endl;
+			return -1;
+		}
+		if(!test_snapshot_isolation<std::string>(reference_data)){
+			std::cout << "At least one Unittest Failed!" << std::endl;
+			return -1;
+		}
+	}
+
 //	/****** BULK UPDATE TEST ******/
 //	{
 //		std::cout << "BULK UPDATE TEST..."; // << std::endl;
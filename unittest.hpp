@@ -15,11 +15,29 @@
 #define UNITTEST_HPP
 
 #include <string>
+#include <set>
+#include <list>
+#include <limits>
 #include <core/global_definitions.hpp>
 #include <core/base_column.hpp>
 #include <core/column_base_typed.hpp>
 #include <core/column.hpp>
 #include <core/compressed_column.hpp>
+#include <compression/dictionary_compressed_column.hpp>
+#include <compression/delta_coding_compressed_column.hpp>
+#include <compression/main_delta_column.hpp>
+#include <core/versioned_column.hpp>
+#include <core/segmented_column.hpp>
+#include <core/bit_packed_column.hpp>
+#include <core/arithmetic_expression.hpp>
+#include <core/compressed_position_list.hpp>
+#include <core/lookup_array.hpp>
+#include <core/managed_column.hpp>
+#include <core/column_loader.hpp>
+#include <core/physical_operators.hpp>
+#include <compression/front_coded_dictionary_column.hpp>
+#include <compression/alp_compressed_column.hpp>
+#include <thread>
 
 using namespace CoGaDB;
 
@@ -40,6 +58,11 @@ const float get_rand_value() {
 	return float(rand() % 10000) / 100;
 }
 
+template<>
+const bool get_rand_value() {
+	return rand() % 2;
+}
+
 template<>
 const std::string get_rand_value() {
 	std::string characterfield="abcdefghijklmnopqrstuvwxyz";
@@ -58,7 +81,9 @@ void fill_column(boost::shared_ptr<ColumnBaseTyped<T> > col, std::vector<T>& ref
 	}
 
 	for (unsigned int i = 0; i < reference_data.size(); i++) {
-		col->insert(reference_data[i]);
+		//std::vector<bool> returns a proxy, which converts to T and to boost::any alike
+		const T value = reference_data[i];
+		col->insert(value);
 	}
 	std::cout << "Size in Bytes: " << col->getSizeinBytes() << std::endl;
 }
@@ -66,7 +91,7 @@ void fill_column(boost::shared_ptr<ColumnBaseTyped<T> > col, std::vector<T>& ref
 template<class T>
 bool equals(std::vector<T> reference_data, boost::shared_ptr<ColumnBaseTyped<T> > col) {
 	for (unsigned int i = 0; i < reference_data.size(); i++) {
-		T col_value = (*col)[i];
+		T col_value = col->getValue(i);
 		if (reference_data[i] != col_value) {
 			std::cout << "Fatal Error! In Unittest: read invalid data" << std::endl;
 			std::cout << "Column: '" << col->getName() 
@@ -186,6 +211,11 @@ AttributeType getAttributeType<float>(){
     return FLOAT;
 }
 
+template< >
+AttributeType getAttributeType<bool>(){
+    return BOOLEAN;
+}
+
 template< >
 AttributeType getAttributeType<std::string>(){
     return VARCHAR;
@@ -204,12 +234,1678 @@ template<>
 std::string  getAttributeString<float>(){
     return "float column";
 }
+template<>
+std::string getAttributeString<bool>(){
+    return "bool column";
+}
 
 template<>
 std::string  getAttributeString<std::string>(){
     return "string column";
 }
 
+template<class T>
+bool test_dictionary_compaction(std::vector<T> reference_data) {
+	/****** DICTIONARY COMPACTION TEST ******/
+	std::cout << "DICTIONARY COMPACTION TEST: remove rows and compact the dictionary...";
+	boost::shared_ptr<DictionaryCompressedColumn<T> > col (new DictionaryCompressedColumn<T>("compaction column", getAttributeType<T>()));
+	//disable automatic compaction, so dead codes pile up
+	col->setCompactionThreshold(2.0);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		col->insert(reference_data[i]);
+	}
+	while (reference_data.size() > 10) {
+		TID tid = rand() % reference_data.size();
+		reference_data.erase(reference_data.begin()+tid);
+		col->remove(tid);
+	}
+	if (col->getDeadCodeShare() == 0) {
+		std::cerr << "DICTIONARY COMPACTION TEST FAILED! No dead codes after removing rows" << std::endl;
+		return false;
+	}
+
+	col->compact();
+
+	std::set<T> distinct_values(reference_data.begin(), reference_data.end());
+	if (col->getDeadCodeShare() != 0 || col->getDictionary()->getLastKey() != int(distinct_values.size()) || col->column_.width() != 1) {
+		std::cerr << "DICTIONARY COMPACTION TEST FAILED! Codes are not dense after compaction" << std::endl;
+		return false;
+	}
+	if (!equals(reference_data, boost::shared_ptr<ColumnBaseTyped<T> >(col))) {
+		std::cerr << "DICTIONARY COMPACTION TEST FAILED!" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<template<typename> class MainColumnType, class T>
+bool test_main_delta_merge(std::vector<T> reference_data) {
+	/****** MAIN DELTA MERGE TEST ******/
+	std::cout << "MAIN DELTA MERGE TEST: insert rows while the delta buffer is merged in the background...";
+	typedef MainDeltaColumn<T, MainColumnType> MainDeltaColumnType;
+	boost::shared_ptr<MainDeltaColumnType> col (new MainDeltaColumnType("main delta column", getAttributeType<T>(), 16));
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		col->insert(reference_data[i]);
+	}
+	if (!equals(reference_data, boost::shared_ptr<ColumnBaseTyped<T> >(col))) {
+		std::cerr << "MAIN DELTA MERGE TEST FAILED!" << std::endl;
+		return false;
+	}
+	col->merge();
+	if (col->getDeltaSize() != 0 || col->size() != reference_data.size()) {
+		std::cerr << "MAIN DELTA MERGE TEST FAILED! Delta buffer not empty after merge" << std::endl;
+		return false;
+	}
+	if (!equals(reference_data, boost::shared_ptr<ColumnBaseTyped<T> >(col))) {
+		std::cerr << "MAIN DELTA MERGE TEST FAILED!" << std::endl;
+		return false;
+	}
+	//a pinned reader keeps the replaced main alive, it is deleted after the reader left its epoch
+	{
+		EpochManager::Guard guard;
+		const T& first_value = (*col)[0];
+		col->insert(reference_data[0]);
+		col->merge();
+		if (first_value != reference_data[0] || EpochManager::instance().getNumberOfRetiredObjects() == 0) {
+			std::cerr << "MAIN DELTA MERGE TEST FAILED! Replaced main was deleted while a reader was pinned" << std::endl;
+			return false;
+		}
+	}
+	EpochManager::instance().reclaim();
+	if (EpochManager::instance().getNumberOfRetiredObjects() != 0 || col->size() != reference_data.size() + 1) {
+		std::cerr << "MAIN DELTA MERGE TEST FAILED! Replaced main was not deleted" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<class T>
+bool test_snapshot_isolation(std::vector<T> reference_data) {
+	/****** SNAPSHOT ISOLATION TEST ******/
+	std::cout << "SNAPSHOT ISOLATION TEST: scan a snapshot while the column is modified...";
+	boost::shared_ptr<VersionedColumn<T> > col (new VersionedColumn<T>("versioned column", getAttributeType<T>()));
+	col->insert(reference_data.begin(), reference_data.end());
+	{
+		typename VersionedColumn<T>::Snapshot snapshot(*col);
+		col->update(0, get_rand_value<T>());
+		col->remove(1);
+		col->insert(get_rand_value<T>());
+		if (snapshot.size() != reference_data.size()) {
+			std::cerr << "SNAPSHOT ISOLATION TEST FAILED! Snapshot size changed" << std::endl;
+			return false;
+		}
+		for (TID i = 0; i < reference_data.size(); i++) {
+			if (snapshot[i] != reference_data[i]) {
+				std::cerr << "SNAPSHOT ISOLATION TEST FAILED! Snapshot value changed on TID " << i << std::endl;
+				return false;
+			}
+		}
+	}
+	//readers scan concurrently to an inserting thread, every scan has to see a consistent prefix of the insertions
+	bool consistent = true;
+	T value = reference_data[0];
+	col->clearContent();
+	std::thread reader([&col, &consistent, &value]() {
+		for (unsigned int i = 0; i < 100; i++) {
+			typename VersionedColumn<T>::Snapshot snapshot(*col);
+			for (TID tid = 0; tid < snapshot.size(); tid++) {
+				if (snapshot[tid] != value) consistent = false;
+			}
+		}
+	});
+	for (unsigned int i = 0; i < 10000; i++) {
+		col->insert(value);
+	}
+	reader.join();
+	if (!consistent || col->size() != 10000 || col->selection(value, EQUAL)->size() != 10000) {
+		std::cerr << "SNAPSHOT ISOLATION TEST FAILED! Concurrent scan read inconsistent data" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_concurrent_append() {
+	/****** CONCURRENT APPEND TEST ******/
+	std::cout << "CONCURRENT APPEND TEST: append from several threads without locks...";
+	const unsigned int number_of_threads = 4;
+	const unsigned int rows_per_thread = 100000;
+	boost::shared_ptr<SegmentedColumn<int> > col (new SegmentedColumn<int>("segmented column", INT));
+	std::vector<std::thread> writers;
+	for (unsigned int i = 0; i < number_of_threads; i++) {
+		writers.push_back(std::thread([col, i]() {
+			std::vector<int> values(rows_per_thread / 10, i + 1);
+			for (unsigned int j = 0; j < 10; j++) {
+				col->append(values.begin(), values.end());
+			}
+		}));
+	}
+	//every published row has to be completely written while the writers are running
+	bool consistent = true;
+	size_t last_size = 0;
+	while (last_size < number_of_threads * rows_per_thread) {
+		size_t size = col->size();
+		if (size < last_size) consistent = false;
+		for (TID tid = last_size; tid < size; tid++) {
+			//chunks are zero initialized, so a row, which is not written yet, has the value 0
+			if ((*col)[tid] < 1 || (*col)[tid] > int(number_of_threads)) consistent = false;
+		}
+		last_size = size;
+	}
+	for (unsigned int i = 0; i < writers.size(); i++) {
+		writers[i].join();
+	}
+	if (!consistent || col->size() != number_of_threads * rows_per_thread) {
+		std::cerr << "CONCURRENT APPEND TEST FAILED!" << std::endl;
+		return false;
+	}
+	for (unsigned int i = 0; i < number_of_threads; i++) {
+		if (col->selection(int(i + 1), EQUAL)->size() != rows_per_thread) {
+			std::cerr << "CONCURRENT APPEND TEST FAILED! Lost rows of thread " << i << std::endl;
+			return false;
+		}
+	}
+	//removed rows are reserved again by the next appends, which have to complete them before they are visible
+	PositionListPtr removed_tids (new PositionList());
+	for (TID tid = 1000; tid < col->size(); tid++) removed_tids->push_back(tid);
+	col->remove(removed_tids);
+	std::vector<int> values(100, 7);
+	if (col->size() != 1000 || col->append(values.begin(), values.end()) != 1000 || col->size() != 1100 || (*col)[1099] != 7) {
+		std::cerr << "CONCURRENT APPEND TEST FAILED! Wrong rows after remove" << std::endl;
+		return false;
+	}
+	//a load replaces the rows instead of appending them
+	if (!col->store("data/") || !col->load("data/") || !col->load("data/") || col->size() != 1100 || (*col)[1099] != 7) {
+		std::cerr << "CONCURRENT APPEND TEST FAILED! Wrong rows after load" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_string_heap_shared_update() {
+	/****** STRING HEAP SHARED UPDATE TEST ******/
+	std::cout << "STRING HEAP SHARED UPDATE TEST: update many rows to one long string, remove and store them...";
+	boost::shared_ptr<StringHeapColumn> col (new StringHeapColumn("string heap shared update column", VARCHAR));
+	std::vector<std::string> reference_data(1000);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = get_rand_value<std::string>();
+	}
+	col->insert(reference_data.begin(), reference_data.end());
+	//all rows share one copy of the long string, so its bytes must not be counted as dead once per row
+	const std::string long_string(10000, 'x');
+	PositionListPtr tids (new PositionList());
+	for (TID i = 0; i < reference_data.size(); i++) {
+		tids->push_back(i);
+		reference_data[i] = long_string;
+	}
+	col->update(tids, boost::any(long_string));
+	PositionListPtr removed_tids (new PositionList());
+	for (TID i = 0; i < reference_data.size(); i += 2) {
+		removed_tids->push_back(i);
+	}
+	col->remove(removed_tids);
+	for (size_t i = removed_tids->size(); i > 0; i--) {
+		reference_data.erase(reference_data.begin() + (*removed_tids)[i - 1]);
+	}
+	col->update(TID(0), boost::any(std::string("short")));
+	reference_data[0] = "short";
+	col->compactHeap();
+	if (col->size() != reference_data.size() || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(col))
+		|| col->getSizeinBytes() > 2 * long_string.size() + reference_data.size() * 64) {
+		std::cerr << "STRING HEAP SHARED UPDATE TEST FAILED! Shared string was not kept once" << std::endl;
+		return false;
+	}
+	col->store("data/");
+	boost::shared_ptr<StringHeapColumn> loaded_col (new StringHeapColumn("string heap shared update column", VARCHAR));
+	loaded_col->load("data/");
+	loaded_col->update(TID(1), boost::any(std::string("other")));
+	reference_data[1] = "other";
+	loaded_col->compactHeap();
+	if (loaded_col->size() != reference_data.size() || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(loaded_col))
+		|| loaded_col->getSizeinBytes() > 2 * long_string.size() + reference_data.size() * 64) {
+		std::cerr << "STRING HEAP SHARED UPDATE TEST FAILED! Stored column does not share the string" << std::endl;
+		return false;
+	}
+	//a duplicate TID updates its row once, so the string stays live as long as one of the rows references it
+	PositionListPtr duplicate_tids (new PositionList());
+	duplicate_tids->push_back(3);
+	duplicate_tids->push_back(3);
+	duplicate_tids->push_back(4);
+	loaded_col->update(duplicate_tids, boost::any(long_string + "y"));
+	loaded_col->update(TID(3), boost::any(std::string("short")));
+	loaded_col->compactHeap();
+	if (loaded_col->getView(4) != long_string + "y" || loaded_col->getSizeinBytes() > 3 * long_string.size() + reference_data.size() * 64) {
+		std::cerr << "STRING HEAP SHARED UPDATE TEST FAILED! Duplicate TIDs are counted twice" << std::endl;
+		return false;
+	}
+	//the heap maintains indexes and its sortedness like the other columns
+	loaded_col->createIndex(HASH_INDEX);
+	loaded_col->update(TID(2), boost::any(std::string("other")));
+	PositionListPtr other_tids = loaded_col->index_scan(boost::any(std::string("other")), EQUAL);
+	boost::shared_ptr<StringHeapColumn> sorted_col (new StringHeapColumn("string heap sorted column", VARCHAR));
+	sorted_col->insert(std::string("a"));
+	sorted_col->insert(std::string("b"));
+	sorted_col->insert(std::string("b"));
+	if (!other_tids || other_tids->size() != 2 || (*other_tids)[0] != 1 || (*other_tids)[1] != 2 || !sorted_col->isSorted()
+		|| sorted_col->selection(boost::any(std::string("b")), EQUAL)->size() != 2) {
+		std::cerr << "STRING HEAP SHARED UPDATE TEST FAILED! Index or sortedness is not maintained" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_front_coded_dictionary(std::vector<std::string> reference_data) {
+	/****** FRONT CODED DICTIONARY TEST ******/
+	std::cout << "FRONT CODED DICTIONARY TEST: look up strings in the front coded dictionary and its overflow...";
+	boost::shared_ptr<FrontCodedDictionaryColumn> col (new FrontCodedDictionaryColumn("front coded column", VARCHAR));
+	col->insert(reference_data.begin(), reference_data.end());
+	col->rebuildDictionary();
+	//new strings end up in the overflow until the next rebuild
+	std::string new_value("front coded overflow value");
+	col->insert(new_value);
+	reference_data.push_back(new_value);
+	if (col->getNumberOfOverflowValues() != 1 || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(col))) {
+		std::cerr << "FRONT CODED DICTIONARY TEST FAILED!" << std::endl;
+		return false;
+	}
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		const std::string& value = reference_data[i];
+		size_t number_of_equal = std::count(reference_data.begin(), reference_data.end(), value);
+		size_t number_of_lesser = 0;
+		for (unsigned int j = 0; j < reference_data.size(); j++) {
+			if (reference_data[j] < value) number_of_lesser++;
+		}
+		if (col->selection(value, EQUAL)->size() != number_of_equal
+			|| col->selection(value, LESSER)->size() != number_of_lesser
+			|| col->selection(value, GREATER)->size() != reference_data.size() - number_of_equal - number_of_lesser) {
+			std::cerr << "FRONT CODED DICTIONARY TEST FAILED! Wrong selection result for value " << value << std::endl;
+			return false;
+		}
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<class T>
+bool test_alp_compression() {
+	/****** ALP COMPRESSION TEST ******/
+	std::cout << "ALP COMPRESSION TEST: compress decimal values with a few exceptions...";
+	boost::shared_ptr<AlpCompressedColumn<T> > col (new AlpCompressedColumn<T>("alp column", FLOAT));
+	std::vector<T> reference_data(10000);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = T(rand() % 1000) / 100;
+	}
+	//values with too many decimal digits have to be stored as exceptions
+	for (unsigned int i = 0; i < reference_data.size(); i += 97) {
+		reference_data[i] = T(rand() % 100) / 3;
+	}
+	col->insert(reference_data.begin(), reference_data.end());
+	if (!equals(reference_data, boost::shared_ptr<ColumnBaseTyped<T> >(col)) || col->getNumberOfExceptions() == 0) {
+		std::cerr << "ALP COMPRESSION TEST FAILED!" << std::endl;
+		return false;
+	}
+	if (col->getSizeinBytes() * 2 > reference_data.size() * sizeof(T)) {
+		std::cerr << "ALP COMPRESSION TEST FAILED! Column needs " << col->getSizeinBytes() << " bytes" << std::endl;
+		return false;
+	}
+	std::vector<T> decoded_values(reference_data.size() - 100);
+	col->decode(100, TID(reference_data.size()), &decoded_values[0]);
+	if (!std::equal(decoded_values.begin(), decoded_values.end(), reference_data.begin() + 100)) {
+		std::cerr << "ALP COMPRESSION TEST FAILED! Bulk decode returned wrong values" << std::endl;
+		return false;
+	}
+	col->update(1500, boost::any(T(1) / 7));
+	reference_data[1500] = T(1) / 7;
+	col->remove(42);
+	reference_data.erase(reference_data.begin() + 42);
+	if (col->size() != reference_data.size() || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<T> >(col))) {
+		std::cerr << "ALP COMPRESSION TEST FAILED! Wrong values after update and remove" << std::endl;
+		return false;
+	}
+	//a list with an invalid TID is rejected before any row is removed
+	PositionListPtr invalid_tids (new PositionList());
+	invalid_tids->push_back(10);
+	invalid_tids->push_back(TID(reference_data.size()));
+	if (col->remove(invalid_tids) || col->size() != reference_data.size() || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<T> >(col))) {
+		std::cerr << "ALP COMPRESSION TEST FAILED! Remove with an invalid TID modified the column" << std::endl;
+		return false;
+	}
+	T value = reference_data[4711];
+	if (col->selection(value, EQUAL)->size() != size_t(std::count(reference_data.begin(), reference_data.end(), value))) {
+		std::cerr << "ALP COMPRESSION TEST FAILED! Wrong selection result" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_bitmap_predicates() {
+	/****** BITMAP PREDICATE TEST ******/
+	std::cout << "BITMAP PREDICATE TEST: combine predicates on bit packed columns word wise...";
+	boost::shared_ptr<BitPackedColumn> is_active (new BitPackedColumn("is_active", BOOLEAN));
+	boost::shared_ptr<BitPackedColumn> is_deleted (new BitPackedColumn("is_deleted", BOOLEAN));
+	std::vector<bool> active(1000), deleted(1000);
+	for (unsigned int i = 0; i < active.size(); i++) {
+		active[i] = get_rand_value<bool>();
+		deleted[i] = get_rand_value<bool>();
+	}
+	is_active->insert(active.begin(), active.end());
+	is_deleted->insert(deleted.begin(), deleted.end());
+
+	Bitmap active_and_not_deleted = is_active->selectionBitmap(true, EQUAL);
+	active_and_not_deleted &= is_deleted->selectionBitmap(false, EQUAL);
+	Bitmap active_or_deleted = is_active->selectionBitmap(true, EQUAL);
+	active_or_deleted |= Bitmap::fromPositionList(*is_deleted->selection(true, EQUAL), is_deleted->size());
+	PositionListPtr and_tids = active_and_not_deleted.toPositionList();
+	PositionListPtr or_tids = active_or_deleted.toPositionList();
+
+	PositionList expected_and_tids, expected_or_tids;
+	for (TID i = 0; i < active.size(); i++) {
+		if (active[i] && !deleted[i]) expected_and_tids.push_back(i);
+		if (active[i] || deleted[i]) expected_or_tids.push_back(i);
+	}
+	if (*and_tids != expected_and_tids || *or_tids != expected_or_tids || active_or_deleted.count() != expected_or_tids.size()) {
+		std::cerr << "BITMAP PREDICATE TEST FAILED!" << std::endl;
+		return false;
+	}
+	//removing a row moves all later bits across word boundaries
+	is_active->remove(3);
+	active.erase(active.begin() + 3);
+	if (!equals(active, boost::shared_ptr<ColumnBaseTyped<bool> >(is_active))) {
+		std::cerr << "BITMAP PREDICATE TEST FAILED! Wrong values after remove" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_compressed_position_list() {
+	/****** COMPRESSED POSITION LIST TEST ******/
+	std::cout << "COMPRESSED POSITION LIST TEST: store 64 bit TIDs with 32 bits each...";
+	const TID four_billion = TID(1) << 32;
+	PositionList tids;
+	for (TID i = 0; i < 1000; i++) {
+		tids.push_back(i * 3);
+	}
+	for (TID i = 0; i < 1000; i++) {
+		tids.push_back(four_billion + i);
+	}
+	tids.push_back(3 * four_billion + 42);
+	CompressedPositionList compressed_tids(tids);
+	if (compressed_tids.size() != tids.size() || *compressed_tids.toPositionList() != tids) {
+		std::cerr << "COMPRESSED POSITION LIST TEST FAILED!" << std::endl;
+		return false;
+	}
+	for (size_t i = 0; i < tids.size(); i++) {
+		if (compressed_tids[i] != tids[i]) {
+			std::cerr << "COMPRESSED POSITION LIST TEST FAILED! Wrong TID on position " << i << std::endl;
+			return false;
+		}
+	}
+	if (compressed_tids.getSizeinBytes() > tids.size() * sizeof(uint32_t) + 64) {
+		std::cerr << "COMPRESSED POSITION LIST TEST FAILED! Position list needs " << compressed_tids.getSizeinBytes() << " bytes" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<class T>
+bool test_lookup_array(boost::shared_ptr<ColumnBaseTyped<T> > col) {
+	/****** LOOKUP ARRAY TEST ******/
+	std::cout << "LOOKUP ARRAY TEST: flatten and materialize a LookupArray on a LookupArray...";
+	std::vector<T> reference_data(10000);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = get_rand_value<T>();
+		col->insert(reference_data[i]);
+	}
+	PositionListPtr tids (new PositionList());
+	for (TID i = 0; i < reference_data.size(); i += 2) {
+		tids->push_back(i);
+	}
+	PositionListPtr inner_tids (new PositionList());
+	for (unsigned int i = 0; i < 3000; i++) {
+		inner_tids->push_back(rand() % tids->size());
+	}
+	boost::shared_ptr<LookupArray<T> > lookup_array (new LookupArray<T>(col->getName(), col->getType(), col, tids));
+	boost::shared_ptr<LookupArray<T> > stacked_lookup_array (new LookupArray<T>(col->getName(), col->getType(), lookup_array, inner_tids));
+
+	std::vector<T> expected_values(inner_tids->size());
+	for (unsigned int i = 0; i < inner_tids->size(); i++) {
+		expected_values[i] = reference_data[(*tids)[(*inner_tids)[i]]];
+	}
+	boost::shared_ptr<LookupArray<T> > flat_lookup_array = stacked_lookup_array->flatten();
+	if (flat_lookup_array->getSourceColumn() != col || !equals(expected_values, boost::shared_ptr<ColumnBaseTyped<T> >(flat_lookup_array))) {
+		std::cerr << "LOOKUP ARRAY TEST FAILED! Wrong flattened LookupArray" << std::endl;
+		return false;
+	}
+	if (!equals(expected_values, boost::shared_ptr<ColumnBaseTyped<T> >(stacked_lookup_array->materialize()))) {
+		std::cerr << "LOOKUP ARRAY TEST FAILED! Wrong materialized values" << std::endl;
+		return false;
+	}
+	//the view does not write through to the source column
+	if (stacked_lookup_array->update(TID(0), boost::any(reference_data[1])) || stacked_lookup_array->insert(reference_data[1])
+		|| col->size() != reference_data.size() || !equals(reference_data, col)) {
+		std::cerr << "LOOKUP ARRAY TEST FAILED! Modification was written to the source column" << std::endl;
+		return false;
+	}
+	//removing rows changes only the view, store writes the materialized view
+	boost::shared_ptr<LookupArray<T> > view (new LookupArray<T>("lookup array", col->getType(), lookup_array, inner_tids));
+	view->remove(0);
+	expected_values.erase(expected_values.begin());
+	view->store("data/");
+	boost::shared_ptr<LookupArray<T> > loaded_view (new LookupArray<T>("lookup array", col->getType(), col, tids));
+	loaded_view->load("data/");
+	if (inner_tids->size() != expected_values.size() + 1 || !equals(expected_values, boost::shared_ptr<ColumnBaseTyped<T> >(loaded_view))) {
+		std::cerr << "LOOKUP ARRAY TEST FAILED! Wrong values after remove, store and load" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+/*! \brief compares gatherValues() of random rows of values with a plain loop*/
+template<class T>
+bool gathers_like_loop(const std::vector<T>& values, size_t number_of_tids) {
+	std::vector<TID> tids(number_of_tids);
+	for (size_t i = 0; i < tids.size(); i++) tids[i] = rand() % values.size();
+	std::vector<T> output(number_of_tids);
+	gatherValues(values.data(), tids.data(), tids.size(), output.data());
+	for (size_t i = 0; i < tids.size(); i++) {
+		if (output[i] != values[tids[i]]) return false;
+	}
+	return true;
+}
+
+bool test_simd_gather() {
+	/****** SIMD GATHER TEST ******/
+	std::cout << "SIMD GATHER TEST: gather 32 and 64 bit values with AVX2, if the CPU supports it...";
+	std::vector<int> int_values(100000);
+	std::vector<float> float_values(int_values.size());
+	std::vector<double> double_values(int_values.size());
+	std::vector<TID> tid_values(int_values.size());
+	for (size_t i = 0; i < int_values.size(); i++) {
+		int_values[i] = rand();
+		float_values[i] = get_rand_value<float>();
+		double_values[i] = rand() / 3.0;
+		tid_values[i] = (TID(rand()) << 32) | rand();
+	}
+	//the lengths cover the rows, which the AVX2 loops leave to the scalar loop
+	size_t lengths[] = {0, 3, 19, 20, 21, 1001, 10000};
+	for (unsigned int i = 0; i < 7; i++) {
+		if (!gathers_like_loop(int_values, lengths[i]) || !gathers_like_loop(float_values, lengths[i])
+			|| !gathers_like_loop(double_values, lengths[i]) || !gathers_like_loop(tid_values, lengths[i])) {
+			std::cerr << "SIMD GATHER TEST FAILED! Wrong values for " << lengths[i] << " rows" << std::endl;
+			return false;
+		}
+	}
+#if defined(__x86_64__)
+	//the AVX2 loops gather all but the last rows themselves
+	std::vector<TID> tids(1000, 7);
+	std::vector<int> int_output(tids.size());
+	std::vector<TID> tid_output(tids.size());
+	if (hasAVX2() && (gatherValues32(int_values.data(), tids.data(), tids.size(), int_output.data()) < tids.size() - 4 - gather_prefetch_distance
+		|| gatherValues64(tid_values.data(), tids.data(), tids.size(), tid_output.data()) < tids.size() - 4 - gather_prefetch_distance
+		|| int_output[500] != int_values[7] || tid_output[500] != tid_values[7])) {
+		std::cerr << "SIMD GATHER TEST FAILED! AVX2 gather did not gather the rows" << std::endl;
+		return false;
+	}
+#endif
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_operator_pipeline() {
+	/****** OPERATOR PIPELINE TEST ******/
+	std::cout << "OPERATOR PIPELINE TEST: scan, filter, join and project with late materialization...";
+	boost::shared_ptr<Column<int> > order_customer (new Column<int>("order_customer", INT));
+	boost::shared_ptr<AlpCompressedColumn<float> > order_price (new AlpCompressedColumn<float>("order_price", FLOAT));
+	boost::shared_ptr<Column<int> > customer_id (new Column<int>("customer_id", INT));
+	boost::shared_ptr<StringHeapColumn> customer_name (new StringHeapColumn("customer_name", VARCHAR));
+	for (int i = 0; i < 100; i++) {
+		customer_id->insert(i);
+		customer_name->insert(get_rand_value<std::string>());
+	}
+	for (unsigned int i = 0; i < 5000; i++) {
+		order_customer->insert(rand() % 150);
+		order_price->insert(get_rand_value<float>());
+	}
+	ColumnVector orders, customers;
+	orders.push_back(order_customer);
+	orders.push_back(order_price);
+	customers.push_back(customer_id);
+	customers.push_back(customer_name);
+
+	//SELECT customer_name, order_price FROM orders JOIN customers ON order_customer=customer_id WHERE order_price > 50 AND customer_id < 80
+	PhysicalOperatorPtr filtered_orders (new FilterOperator(PhysicalOperatorPtr(new ScanOperator(orders)), "order_price", float(50), GREATER));
+	PhysicalOperatorPtr filtered_customers (new FilterOperator(PhysicalOperatorPtr(new ScanOperator(customers)), "customer_id", int(80), LESSER));
+	PhysicalOperatorPtr join (new JoinOperator(filtered_orders, filtered_customers, "order_customer", "customer_id"));
+	std::vector<std::string> column_names;
+	column_names.push_back("customer_name");
+	column_names.push_back("order_price");
+	IntermediateResultPtr result = ProjectionOperator(join, column_names).execute();
+
+	std::vector<std::pair<std::string, float> > expected_rows;
+	for (TID i = 0; i < order_customer->size(); i++) {
+		int customer = (*order_customer)[i];
+		if ((*order_price)[i] > 50 && customer < 80 && customer < 100) {
+			expected_rows.push_back(std::make_pair((*customer_name)[customer], (*order_price)[i]));
+		}
+	}
+	if (!result || result->size() != expected_rows.size()) {
+		std::cerr << "OPERATOR PIPELINE TEST FAILED! Wrong number of result rows" << std::endl;
+		return false;
+	}
+	boost::shared_ptr<ColumnBaseTyped<std::string> > names = boost::static_pointer_cast<ColumnBaseTyped<std::string> >(result->getView("customer_name"));
+	boost::shared_ptr<ColumnBaseTyped<float> > prices = boost::static_pointer_cast<ColumnBaseTyped<float> >(result->getView("order_price"));
+	std::vector<std::pair<std::string, float> > rows;
+	for (TID i = 0; i < result->size(); i++) {
+		rows.push_back(std::make_pair((*names)[i], (*prices)[i]));
+	}
+	std::sort(rows.begin(), rows.end());
+	std::sort(expected_rows.begin(), expected_rows.end());
+	if (!names->isMaterialized() || rows != expected_rows) {
+		std::cerr << "OPERATOR PIPELINE TEST FAILED! Wrong result rows" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<class T>
+bool test_predicate_selection(boost::shared_ptr<ColumnBaseTyped<T> > col) {
+	/****** PREDICATE SELECTION TEST ******/
+	std::cout << "PREDICATE SELECTION TEST: evaluate (v BETWEEN a AND b AND v<>c) OR v IN (d,e) in one pass...";
+	typedef typename PredicateExpression<T>::PredicateExpressionPtr PredicateExpressionPtr;
+	std::vector<T> reference_data(5000);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = get_rand_value<T>();
+		col->insert(reference_data[i]);
+	}
+	T lower = std::min(reference_data[0], reference_data[1]);
+	T upper = std::max(reference_data[0], reference_data[1]);
+	T excluded = reference_data[2];
+	std::vector<T> in_list;
+	in_list.push_back(reference_data[3]);
+	in_list.push_back(reference_data[4]);
+
+	std::vector<PredicateExpressionPtr> conjunction;
+	conjunction.push_back(makeBetween(lower, upper));
+	conjunction.push_back(makeNotEqual(excluded));
+	std::vector<PredicateExpressionPtr> disjunction;
+	disjunction.push_back(makeConjunction<T>(conjunction));
+	disjunction.push_back(makeIn(in_list));
+	PositionListPtr tids = col->predicate_selection(*makeDisjunction<T>(disjunction));
+
+	PositionList expected_tids;
+	for (TID i = 0; i < reference_data.size(); i++) {
+		const T& v = reference_data[i];
+		if ((!(v < lower) && !(upper < v) && v != excluded) || v == in_list[0] || v == in_list[1]) {
+			expected_tids.push_back(i);
+		}
+	}
+	if (*tids != expected_tids) {
+		std::cerr << "PREDICATE SELECTION TEST FAILED! Expected " << expected_tids.size() << " rows, got " << tids->size() << std::endl;
+		return false;
+	}
+	//a single comparison has to return the same rows as selection()
+	if (*col->predicate_selection(*makeComparison(LESSER, excluded)) != *col->selection(excluded, LESSER)) {
+		std::cerr << "PREDICATE SELECTION TEST FAILED! Comparison differs from selection" << std::endl;
+		return false;
+	}
+	//NaN is neither a value in nor a bound of a range
+	if (std::numeric_limits<T>::has_quiet_NaN) {
+		const T nan = std::numeric_limits<T>::quiet_NaN();
+		unsigned char in_range[3] = {1, 1, 1};
+		makeBetween(lower, upper)->evaluate(&nan, 1, in_range);
+		makeBetween(nan, upper)->evaluate(&lower, 1, in_range + 1);
+		makeBetween(lower, nan)->evaluate(&upper, 1, in_range + 2);
+		if (in_range[0] || in_range[1] || in_range[2] || !col->predicate_selection(*makeBetween(nan, upper))->empty()) {
+			std::cerr << "PREDICATE SELECTION TEST FAILED! NaN is in a range" << std::endl;
+			return false;
+		}
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<class T>
+bool test_sorted_selection(boost::shared_ptr<ColumnBaseTyped<T> > col, unsigned int number_of_rows) {
+	/****** SORTED SELECTION TEST ******/
+	std::cout << "SORTED SELECTION TEST: binary search selection on a column loaded in key order...";
+	std::vector<T> reference_data(number_of_rows);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		//ascending values with duplicates
+		reference_data[i] = T(i / 3);
+		col->insert(reference_data[i]);
+	}
+	if (!col->isSorted()) {
+		std::cerr << "SORTED SELECTION TEST FAILED! Column is not detected as sorted" << std::endl;
+		return false;
+	}
+	PositionListPtr identity = col->sort(ASCENDING);
+	for (TID i = 0; i < identity->size(); i++) {
+		if ((*identity)[i] != i) {
+			std::cerr << "SORTED SELECTION TEST FAILED! Sort of a sorted column is not the identity" << std::endl;
+			return false;
+		}
+	}
+	for (unsigned int run = 0; run < 2; run++) {
+		T value = reference_data[reference_data.size() / 2];
+		ValueComparator comps[] = {EQUAL, LESSER, GREATER};
+		for (unsigned int c = 0; c < 3; c++) {
+			PositionList expected_tids;
+			for (TID i = 0; i < reference_data.size(); i++) {
+				if ((comps[c] == EQUAL && reference_data[i] == value) || (comps[c] == LESSER && reference_data[i] < value)
+					|| (comps[c] == GREATER && value < reference_data[i])) {
+					expected_tids.push_back(i);
+				}
+			}
+			if (*col->selection(value, comps[c]) != expected_tids) {
+				std::cerr << "SORTED SELECTION TEST FAILED! Wrong result for comparator " << comps[c] << std::endl;
+				return false;
+			}
+		}
+		PositionList expected_range;
+		for (TID i = 0; i < reference_data.size(); i++) {
+			if (!(reference_data[i] < T(5)) && !(T(10) < reference_data[i])) expected_range.push_back(i);
+		}
+		if (*col->predicate_selection(*makeBetween(T(5), T(10))) != expected_range) {
+			std::cerr << "SORTED SELECTION TEST FAILED! Wrong result for range predicate" << std::endl;
+			return false;
+		}
+		//an out of order update makes the column unsorted, the second run checks the scan
+		if (run == 0) {
+			col->update(1, boost::any(T(number_of_rows)));
+			reference_data[1] = T(number_of_rows);
+			if (col->isSorted()) {
+				std::cerr << "SORTED SELECTION TEST FAILED! Column is still sorted after an out of order update" << std::endl;
+				return false;
+			}
+		}
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+template<class T>
+bool test_sorted_selection_nan(boost::shared_ptr<ColumnBaseTyped<T> > col) {
+	/****** SORTED SELECTION NAN TEST ******/
+	std::cout << "SORTED SELECTION NAN TEST: NaN makes a floating point column unsorted...";
+	const T values[] = {T(1), std::numeric_limits<T>::quiet_NaN(), T(0)};
+	for (unsigned int i = 0; i < 3; i++) {
+		col->insert(values[i]);
+	}
+	if (col->isSorted()) {
+		std::cerr << "SORTED SELECTION NAN TEST FAILED! Column with NaN is detected as sorted" << std::endl;
+		return false;
+	}
+	PositionList expected_tids(1, 2);
+	if (*col->selection(T(0.5), LESSER) != expected_tids) {
+		std::cerr << "SORTED SELECTION NAN TEST FAILED! Wrong result for comparator " << LESSER << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool check_index_scans(boost::shared_ptr<ColumnBaseTyped<int> > col, const std::vector<int>& reference_data) {
+	for (unsigned int run = 0; run < 10; run++) {
+		int value = reference_data[rand() % reference_data.size()];
+		ValueComparator comps[] = {EQUAL, LESSER, GREATER};
+		for (unsigned int c = 0; c < 3; c++) {
+			PositionList expected_tids;
+			for (TID i = 0; i < reference_data.size(); i++) {
+				if ((comps[c] == EQUAL && reference_data[i] == value) || (comps[c] == LESSER && reference_data[i] < value)
+					|| (comps[c] == GREATER && reference_data[i] > value)) {
+					expected_tids.push_back(i);
+				}
+			}
+			PositionListPtr tids = col->index_scan(value, comps[c]);
+			if (!tids || *tids != expected_tids || *col->selection(value, comps[c]) != expected_tids) {
+				return false;
+			}
+		}
+		PositionList expected_range;
+		for (TID i = 0; i < reference_data.size(); i++) {
+			if (reference_data[i] >= value && reference_data[i] <= value + 10) expected_range.push_back(i);
+		}
+		if (*col->predicate_selection(*makeBetween(value, value + 10)) != expected_range) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_secondary_index() {
+	/****** SECONDARY INDEX TEST ******/
+	std::cout << "SECONDARY INDEX TEST: maintain hash and B+-tree indexes on insert, update, remove and store...";
+	boost::shared_ptr<ColumnBaseTyped<int> > col (new Column<int>("int column", INT));
+	std::vector<int> reference_data(20000);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = rand() % 1000;
+		col->insert(reference_data[i]);
+	}
+	if (!col->createIndex(HASH_INDEX) || !col->createIndex(BPLUS_TREE_INDEX) || !check_index_scans(col, reference_data)) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! Wrong result after index creation" << std::endl;
+		return false;
+	}
+	for (unsigned int i = 0; i < 1000; i++) {
+		reference_data.push_back(rand() % 1000);
+		col->insert(reference_data.back());
+	}
+	for (unsigned int i = 0; i < 1000; i++) {
+		TID tid = rand() % reference_data.size();
+		reference_data[tid] = rand() % 1000;
+		col->update(tid, boost::any(reference_data[tid]));
+	}
+	col->remove(TID(5));
+	reference_data.erase(reference_data.begin() + 5);
+	PositionListPtr removed_tids (new PositionList());
+	for (TID tid = 0; tid < reference_data.size(); tid += 7) {
+		removed_tids->push_back(tid);
+	}
+	col->remove(removed_tids);
+	for (PositionList::reverse_iterator it = removed_tids->rbegin(); it != removed_tids->rend(); ++it) {
+		reference_data.erase(reference_data.begin() + *it);
+	}
+	if (!check_index_scans(col, reference_data)) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! Wrong result after modifications" << std::endl;
+		return false;
+	}
+	//a copy has its own indexes
+	ColumnPtr copy = col->copy();
+	copy->clearContent();
+	if (!check_index_scans(col, reference_data)) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! A copy modified the indexes of the original" << std::endl;
+		return false;
+	}
+	//a new column attaches the stored indexes on load
+	col->store("data/");
+	boost::shared_ptr<ColumnBaseTyped<int> > loaded_col (new Column<int>("int column", INT));
+	loaded_col->load("data/");
+	if (!loaded_col->hasIndex(HASH_INDEX) || !loaded_col->hasIndex(BPLUS_TREE_INDEX) || loaded_col->hasIndex(CRACKER_INDEX)
+		|| !check_index_scans(loaded_col, reference_data)) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! Wrong result after load" << std::endl;
+		return false;
+	}
+	col->dropIndex(HASH_INDEX);
+	col->store("data/");
+	boost::shared_ptr<ColumnBaseTyped<int> > reloaded_col (new Column<int>("int column", INT));
+	reloaded_col->load("data/");
+	if (reloaded_col->hasIndex(HASH_INDEX) || !reloaded_col->hasIndex(BPLUS_TREE_INDEX)) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! Load attached a dropped index" << std::endl;
+		return false;
+	}
+	//all rows of a value share one slot of the hash index, so few distinct values do not make the probe sequences long
+	boost::shared_ptr<Column<int> > low_cardinality_col (new Column<int>("low cardinality column", INT));
+	std::vector<int> low_cardinality_data(200000);
+	for (unsigned int i = 0; i < low_cardinality_data.size(); i++) {
+		low_cardinality_data[i] = i % 2;
+	}
+	low_cardinality_col->insert(low_cardinality_data.begin(), low_cardinality_data.end());
+	low_cardinality_col->createIndex(HASH_INDEX);
+	if (low_cardinality_col->index_scan(boost::any(0), EQUAL)->size() != low_cardinality_data.size() / 2
+		|| low_cardinality_col->index_scan(boost::any(1), EQUAL)->size() != low_cardinality_data.size() / 2) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! Wrong result on a column with two distinct values" << std::endl;
+		return false;
+	}
+	//many removed rows share a value, the rows behind them are renumbered
+	PositionListPtr removed_low_cardinality_tids (new PositionList());
+	for (TID tid = 0; tid < low_cardinality_data.size() / 2; tid += 2) {
+		removed_low_cardinality_tids->push_back(tid);
+	}
+	low_cardinality_col->remove(removed_low_cardinality_tids);
+	PositionListPtr zero_tids = low_cardinality_col->index_scan(boost::any(0), EQUAL);
+	PositionListPtr one_tids = low_cardinality_col->index_scan(boost::any(1), EQUAL);
+	if (zero_tids->size() != low_cardinality_data.size() / 4 || one_tids->size() != low_cardinality_data.size() / 2
+		|| (*one_tids)[0] != 0 || (*zero_tids)[0] != low_cardinality_data.size() / 4 || (*low_cardinality_col)[(*zero_tids)[0]] != 0) {
+		std::cerr << "SECONDARY INDEX TEST FAILED! Wrong result after removing rows with the same value" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_bloom_filter_join() {
+	/****** BLOOM FILTER JOIN TEST ******/
+	std::cout << "BLOOM FILTER JOIN TEST: hash join and semi join push down with a low match rate...";
+	boost::shared_ptr<ColumnBaseTyped<int> > dimension (new Column<int>("dimension key", INT));
+	boost::shared_ptr<ColumnBaseTyped<int> > fact (new Column<int>("fact key", INT));
+	std::vector<int> fact_keys(100000);
+	for (int i = 0; i < 1000; i++) {
+		dimension->insert(i * 40);
+	}
+	for (unsigned int i = 0; i < fact_keys.size(); i++) {
+		fact_keys[i] = rand() % 40000;
+		fact->insert(fact_keys[i]);
+	}
+	PositionList expected_dimension_tids, expected_fact_tids;
+	for (TID i = 0; i < fact_keys.size(); i++) {
+		if (fact_keys[i] % 40 == 0) {
+			expected_dimension_tids.push_back(fact_keys[i] / 40);
+			expected_fact_tids.push_back(i);
+		}
+	}
+	PositionListPairPtr join_tids = dimension->hash_join(fact);
+	if (*join_tids->first != expected_dimension_tids || *join_tids->second != expected_fact_tids) {
+		std::cerr << "BLOOM FILTER JOIN TEST FAILED! Wrong join result" << std::endl;
+		return false;
+	}
+	//the pushed down filter keeps all join partners and drops most other rows
+	PositionListPtr candidates = fact->predicate_selection(*makeBloomFilterPredicate<int>(dimension->createBloomFilter()));
+	if (!std::includes(candidates->begin(), candidates->end(), expected_fact_tids.begin(), expected_fact_tids.end())
+		|| candidates->size() > expected_fact_tids.size() + fact_keys.size() / 20) {
+		std::cerr << "BLOOM FILTER JOIN TEST FAILED! Semi join filter keeps " << candidates->size() << " rows for "
+			<< expected_fact_tids.size() << " join partners" << std::endl;
+		return false;
+	}
+	//the batch test, which uses AVX2, if the CPU supports it, agrees with the test of single keys, also for the keys behind the last full batch
+	BloomFilter filter(500);
+	std::vector<uint64_t> hash_values(1003);
+	for (unsigned int i = 0; i < hash_values.size(); i++) {
+		hash_values[i] = BloomFilter::hash(rand() % 1000);
+		if (i % 2 == 0) filter.insert(hash_values[i]);
+	}
+	std::vector<unsigned char> may_match(hash_values.size());
+	filter.containsBatch(hash_values.data(), hash_values.size(), may_match.data());
+	for (unsigned int i = 0; i < hash_values.size(); i++) {
+		if (may_match[i] != filter.contains(hash_values[i]) || (i % 2 == 0 && !may_match[i])) {
+			std::cerr << "BLOOM FILTER JOIN TEST FAILED! Batch test differs from single key test" << std::endl;
+			return false;
+		}
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_shared_dictionary_join() {
+	/****** SHARED DICTIONARY JOIN TEST ******/
+	std::cout << "SHARED DICTIONARY JOIN TEST: join two dictionary compressed columns on their codes...";
+	DictionaryCompressedColumn<std::string>::DictionaryPtr dictionary (new Dictionary<std::string>());
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > dimension (new DictionaryCompressedColumn<std::string>("dimension name", VARCHAR, dictionary));
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > fact (new DictionaryCompressedColumn<std::string>("fact name", VARCHAR, dictionary));
+	std::vector<std::string> dimension_values, fact_values;
+	for (int i = 0; i < 20; i++) {
+		dimension_values.push_back(std::to_string(i % 15));
+		dimension->insert(dimension_values.back());
+	}
+	for (int i = 0; i < 200; i++) {
+		fact_values.push_back(std::to_string(rand() % 30));
+		fact->insert(fact_values.back());
+	}
+	//the fact column keeps its values, when all dimension rows of a shared code are removed
+	dimension->remove(TID(0));
+	dimension_values.erase(dimension_values.begin());
+	if (!equals(fact_values, boost::shared_ptr<ColumnBaseTyped<std::string> >(fact))) {
+		std::cerr << "SHARED DICTIONARY JOIN TEST FAILED! Removing rows changed the other column" << std::endl;
+		return false;
+	}
+	std::vector<std::pair<TID, TID> > expected_pairs;
+	for (TID i = 0; i < dimension_values.size(); i++) {
+		for (TID j = 0; j < fact_values.size(); j++) {
+			if (dimension_values[i] == fact_values[j]) expected_pairs.push_back(std::make_pair(i, j));
+		}
+	}
+	PositionListPairPtr join_tids[2] = {dimension->hash_join(fact), dimension->nested_loop_join(fact)};
+	for (unsigned int k = 0; k < 2; k++) {
+		std::vector<std::pair<TID, TID> > pairs;
+		for (TID i = 0; i < join_tids[k]->first->size(); i++) {
+			pairs.push_back(std::make_pair((*join_tids[k]->first)[i], (*join_tids[k]->second)[i]));
+		}
+		std::sort(pairs.begin(), pairs.end());
+		if (pairs != expected_pairs) {
+			std::cerr << "SHARED DICTIONARY JOIN TEST FAILED! Wrong join result" << std::endl;
+			return false;
+		}
+	}
+	//the stored dictionary counts the rows of both columns, a loaded column counts only its own rows, so it frees their keys again
+	fact->store("data/");
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > loaded_fact (new DictionaryCompressedColumn<std::string>("fact name", VARCHAR));
+	loaded_fact->load("data/");
+	std::string shared_value;
+	for (TID i = 0; i < fact_values.size() && shared_value.empty(); i++) {
+		if (std::find(dimension_values.begin(), dimension_values.end(), fact_values[i]) != dimension_values.end()) shared_value = fact_values[i];
+	}
+	size_t number_of_distinct_values = loaded_fact->getDictionary()->size();
+	PositionListPtr shared_value_tids = loaded_fact->selection(boost::any(shared_value), EQUAL);
+	loaded_fact->remove(shared_value_tids);
+	if (shared_value.empty() || loaded_fact->getDictionary()->size() != number_of_distinct_values - 1) {
+		std::cerr << "SHARED DICTIONARY JOIN TEST FAILED! Loaded column counts the rows of the other column" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_memory_arena() {
+	/****** MEMORY ARENA TEST ******/
+	std::cout << "MEMORY ARENA TEST: store columns in a huge page arena and release it on clear...";
+	MemoryArenaPtr arena (new MemoryArena());
+	boost::shared_ptr<Column<int> > col (new Column<int>("arena column", INT, arena));
+	std::vector<int> reference_data(100000);
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = rand();
+		col->insert(reference_data[i]);
+	}
+	if (!equals(reference_data, boost::shared_ptr<ColumnBaseTyped<int> >(col)) || arena->getSizeinBytes() < HUGE_PAGE_SIZE
+		|| reinterpret_cast<uintptr_t>(col->getContent().data()) % alignof(int) != 0) {
+		std::cerr << "MEMORY ARENA TEST FAILED! Wrong values in arena" << std::endl;
+		return false;
+	}
+	col->clearContent();
+	if (arena->getSizeinBytes() != 0) {
+		std::cerr << "MEMORY ARENA TEST FAILED! Arena was not released on clear" << std::endl;
+		return false;
+	}
+
+	//the nodes of a map, which are erased, are reused by the next inserts, the arena does not grow
+	MemoryArenaPtr node_arena (new MemoryArena());
+	std::map<int, int, std::less<int>, ColumnAllocator<std::pair<const int, int> > > nodes ((ColumnAllocator<std::pair<const int, int> >(node_arena)));
+	nodes[-1] = 0;
+	size_t node_arena_size = 0;
+	for (unsigned int round = 0; round < 20; round++) {
+		for (int i = 0; i < 100000; i++) nodes[i] = i;
+		for (int i = 0; i < 100000; i++) nodes.erase(i);
+		if (round == 0) node_arena_size = node_arena->getSizeinBytes();
+	}
+	if (nodes.size() != 1 || node_arena->getSizeinBytes() != node_arena_size) {
+		std::cerr << "MEMORY ARENA TEST FAILED! Erased nodes were not reused" << std::endl;
+		return false;
+	}
+
+	//the old buffer of a grown vector serves smaller allocations, instead of staying resident next to the new one
+	MemoryArenaPtr block_arena (new MemoryArena());
+	void* live_block = block_arena->allocate(64, alignof(int));
+	void* large_block = block_arena->allocate(4 * HUGE_PAGE_SIZE, alignof(int));
+	block_arena->deallocate(large_block, 4 * HUGE_PAGE_SIZE);
+	size_t block_arena_size = block_arena->getSizeinBytes();
+	void* small_block = block_arena->allocate(HUGE_PAGE_SIZE, alignof(int));
+	void* split_block = block_arena->allocate(64, alignof(int));
+	if (small_block != large_block || split_block < large_block || split_block >= static_cast<char*>(large_block) + 4 * HUGE_PAGE_SIZE
+		|| block_arena->getSizeinBytes() != block_arena_size) {
+		std::cerr << "MEMORY ARENA TEST FAILED! Free block of a larger size class was not split" << std::endl;
+		return false;
+	}
+	block_arena->deallocate(split_block, 64);
+	block_arena->deallocate(small_block, HUGE_PAGE_SIZE);
+	block_arena->deallocate(live_block, 64);
+
+	MemoryArenaPtr dictionary_arena (new MemoryArena());
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > dictionary_col (new DictionaryCompressedColumn<std::string>("arena dictionary column", VARCHAR, dictionary_arena));
+	std::vector<std::string> string_data(100);
+	for (unsigned int i = 0; i < string_data.size(); i++) {
+		string_data[i] = get_rand_value<std::string>();
+		dictionary_col->insert(string_data[i]);
+	}
+	if (!equals(string_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(dictionary_col)) || dictionary_arena->getSizeinBytes() == 0) {
+		std::cerr << "MEMORY ARENA TEST FAILED! Wrong values in dictionary arena" << std::endl;
+		return false;
+	}
+	dictionary_col->clearContent();
+	if (dictionary_arena->getSizeinBytes() != 0) {
+		std::cerr << "MEMORY ARENA TEST FAILED! Dictionary arena was not released on clear" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_managed_column() {
+	/****** MANAGED COLUMN TEST ******/
+	std::cout << "MANAGED COLUMN TEST: spill least recently used columns over the memory budget and reload them...";
+	MemoryManager manager;
+	std::vector<std::vector<int> > reference_data(3, std::vector<int>(10000));
+	std::vector<boost::shared_ptr<ManagedColumn<int> > > columns;
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < reference_data[i].size(); j++) {
+			reference_data[i][j] = rand();
+		}
+		//the columns have the same name, but spill to different files
+		boost::shared_ptr<Column<int> > col (new Column<int>("managed column", INT));
+		col->insert(reference_data[i].begin(), reference_data[i].end());
+		columns.push_back(boost::shared_ptr<ManagedColumn<int> >(new ManagedColumn<int>(col, "data/", manager)));
+	}
+	size_t footprint = manager.getFootprint(columns[0].get());
+	if (footprint < reference_data[0].size() * sizeof(int) || manager.getResidentSizeinBytes() != 3 * footprint) {
+		std::cerr << "MANAGED COLUMN TEST FAILED! Wrong footprints" << std::endl;
+		return false;
+	}
+	//room for two columns, the least recently used column is spilled
+	manager.setBudget(2 * footprint + footprint / 2);
+	if (columns[0]->isResident() || !columns[1]->isResident() || !columns[2]->isResident() || columns[0]->size() != reference_data[0].size()) {
+		std::cerr << "MANAGED COLUMN TEST FAILED! The least recently used column was not spilled" << std::endl;
+		return false;
+	}
+	//every access reloads a spilled column and spills the least recently used one
+	for (unsigned int i = 0; i < 3; i++) {
+		if (!equals(reference_data[i], boost::shared_ptr<ColumnBaseTyped<int> >(columns[i])) || manager.getResidentSizeinBytes() > manager.getBudget()) {
+			std::cerr << "MANAGED COLUMN TEST FAILED! Wrong values after reload" << std::endl;
+			return false;
+		}
+	}
+	//reading column 0 spills column 1, reading column 1 spills column 2, reading column 2 spills column 0
+	if (manager.getNumberOfSpills() != 4 || columns[0]->isResident() || !columns[1]->isResident() || !columns[2]->isResident()) {
+		std::cerr << "MANAGED COLUMN TEST FAILED! Wrong columns were spilled" << std::endl;
+		return false;
+	}
+
+	//the footprint of a dictionary compressed column includes its dictionary
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > dictionary_col (new DictionaryCompressedColumn<std::string>("managed dictionary column", VARCHAR));
+	for (unsigned int i = 0; i < 100; i++) {
+		dictionary_col->insert(get_rand_value<std::string>());
+	}
+	if (dictionary_col->getSizeinBytes() < dictionary_col->getDictionary()->getSizeinBytes() + 100) {
+		std::cerr << "MANAGED COLUMN TEST FAILED! Footprint misses the dictionary" << std::endl;
+		return false;
+	}
+	//only the columns, which use a dictionary, split its memory, other holders of the dictionary do not
+	size_t dictionary_col_size = dictionary_col->getSizeinBytes();
+	DictionaryCompressedColumn<std::string>::DictionaryPtr dictionary = dictionary_col->getDictionary();
+	ColumnPtr dictionary_col_copy = dictionary_col->copy();
+	if (dictionary_col->getSizeinBytes() != dictionary_col_size - dictionary->getSizeinBytes() + dictionary->getSizeinBytes() / 2) {
+		std::cerr << "MANAGED COLUMN TEST FAILED! Footprint of a dictionary shared with a copy is wrong" << std::endl;
+		return false;
+	}
+	dictionary_col_copy.reset();
+	if (dictionary_col->getSizeinBytes() != dictionary_col_size) {
+		std::cerr << "MANAGED COLUMN TEST FAILED! Footprint counts other holders of the dictionary" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_column_loader() {
+	/****** COLUMN LOADER TEST ******/
+	std::cout << "COLUMN LOADER TEST: load stored columns in parallel...";
+	std::vector<int> int_data(100000);
+	std::vector<std::string> string_data(100);
+	boost::shared_ptr<Column<int> > int_col (new Column<int>("loader int column", INT));
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > string_col (new DictionaryCompressedColumn<std::string>("loader string column", VARCHAR));
+	for (unsigned int i = 0; i < int_data.size(); i++) {
+		int_data[i] = rand();
+		int_col->insert(int_data[i]);
+	}
+	for (unsigned int i = 0; i < string_data.size(); i++) {
+		string_data[i] = get_rand_value<std::string>();
+		string_col->insert(string_data[i]);
+	}
+	int_col->createIndex(HASH_INDEX);
+	int_col->store("data");
+	string_col->store("data");
+	//the file of this column starts with the name of the int column and a '-', but it is not a file of the int column
+	boost::shared_ptr<Column<int> > suffix_col (new Column<int>("loader int column-copy", INT));
+	suffix_col->insert(int_data.begin(), int_data.begin() + 10);
+	suffix_col->store("data");
+
+	boost::shared_ptr<Column<int> > loaded_int_col (new Column<int>("loader int column", INT));
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > loaded_string_col (new DictionaryCompressedColumn<std::string>("loader string column", VARCHAR));
+	loaded_int_col->createIndex(HASH_INDEX);
+	ColumnLoader loader("data");
+	size_t int_col_id = loader.addColumn(loaded_int_col);
+	size_t string_col_id = loader.addColumn(loaded_string_col);
+	boost::shared_ptr<Column<int> > loaded_suffix_col (new Column<int>("loader int column-copy", INT));
+	size_t suffix_col_id = loader.addColumn(loaded_suffix_col);
+	loader.start();
+	//a column can be used as soon as its own files are loaded
+	if (!loader.waitForColumn(string_col_id) || !equals(string_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(loaded_string_col))) {
+		std::cerr << "COLUMN LOADER TEST FAILED! Wrong values in dictionary compressed column" << std::endl;
+		return false;
+	}
+	if (!loader.waitForColumn(int_col_id) || !loader.waitForAll() || !equals(int_data, boost::shared_ptr<ColumnBaseTyped<int> >(loaded_int_col))
+		|| loaded_int_col->index_scan(int_data[42], EQUAL)->empty()) {
+		std::cerr << "COLUMN LOADER TEST FAILED! Wrong values in column" << std::endl;
+		return false;
+	}
+	if (!loader.waitForColumn(suffix_col_id) || loaded_suffix_col->size() != 10 || (*loaded_suffix_col)[9] != int_data[9]) {
+		std::cerr << "COLUMN LOADER TEST FAILED! Wrong values in column, whose name extends the name of another column" << std::endl;
+		return false;
+	}
+	if (PrefetchedFiles::instance().size() != 0) {
+		std::cerr << "COLUMN LOADER TEST FAILED! Prefetched files were not released" << std::endl;
+		return false;
+	}
+	std::cout << (loader.usesIOUring() ? "(io_uring) " : "(threads) ") << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_parallel_compression() {
+	/****** PARALLEL COMPRESSION TEST ******/
+	std::cout << "PARALLEL COMPRESSION TEST: encode bulk inserts block-wise in parallel...";
+	const unsigned int number_of_rows = 5 * parallel_encoding_block_size + 123;
+	std::vector<int> reference_data(number_of_rows);
+	boost::shared_ptr<DictionaryCompressedColumn<int> > dictionary_col (new DictionaryCompressedColumn<int>("parallel dictionary column", INT));
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		//more distinct values than fit into one byte, so the codes are widened during the merge
+		reference_data[i] = rand() % 1000;
+	}
+	dictionary_col->insert(reference_data[0]);
+	dictionary_col->insert(reference_data.begin() + 1, reference_data.begin() + number_of_rows / 2);
+	//input iterators are materialized first
+	std::list<int> second_half(reference_data.begin() + number_of_rows / 2, reference_data.end());
+	dictionary_col->insert(second_half.begin(), second_half.end());
+	if (dictionary_col->size() != number_of_rows || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<int> >(dictionary_col))) {
+		std::cerr << "PARALLEL COMPRESSION TEST FAILED! Wrong values in dictionary compressed column" << std::endl;
+		return false;
+	}
+	//the row counts of the merged keys have to match, so removing all rows of a value frees its key
+	size_t number_of_distinct_values = dictionary_col->getDictionary()->size();
+	PositionListPtr rows = dictionary_col->selection(reference_data[7], EQUAL);
+	for (unsigned int i = rows->size(); i > 0; i--) {
+		dictionary_col->remove((*rows)[i - 1]);
+	}
+	if (dictionary_col->getDictionary()->size() != number_of_distinct_values - 1) {
+		std::cerr << "PARALLEL COMPRESSION TEST FAILED! Wrong row counts in dictionary" << std::endl;
+		return false;
+	}
+
+	std::sort(reference_data.begin(), reference_data.end());
+	boost::shared_ptr<DeltaCodingCompressedColumn<int> > delta_col (new DeltaCodingCompressedColumn<int>("parallel delta column", INT));
+	delta_col->insert(reference_data.begin(), reference_data.end());
+	if (!delta_col->isSorted()) {
+		std::cerr << "PARALLEL COMPRESSION TEST FAILED! Sorted input was not detected" << std::endl;
+		return false;
+	}
+	reference_data.push_back(-5);
+	reference_data.push_back(17);
+	delta_col->insert(reference_data.end() - 2, reference_data.end());
+	const Column<int>::ValueVector& deltas = delta_col->column_.getContent();
+	int value = 0;
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		value += deltas[i];
+		if (value != reference_data[i]) {
+			std::cerr << "PARALLEL COMPRESSION TEST FAILED! Wrong deltas in delta coded column" << std::endl;
+			return false;
+		}
+	}
+	if (delta_col->size() != reference_data.size() || delta_col->isSorted() || delta_col->last_value_ != 17) {
+		std::cerr << "PARALLEL COMPRESSION TEST FAILED! Wrong state of delta coded column" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_copy_on_write() {
+	/****** COPY ON WRITE TEST ******/
+	std::cout << "COPY ON WRITE TEST: share the storage of copied columns until they are modified...";
+	std::vector<int> reference_data(100000);
+	boost::shared_ptr<Column<int> > col (new Column<int>("copy on write column", INT));
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = rand();
+	}
+	col->insert(reference_data.begin(), reference_data.end());
+	boost::shared_ptr<Column<int> > col_copy = boost::static_pointer_cast<Column<int> >(col->copy());
+	const Column<int>& const_col = *col;
+	const Column<int>& const_col_copy = *col_copy;
+	//reading the copy must not duplicate the values
+	if (!equals(reference_data, boost::shared_ptr<ColumnBaseTyped<int> >(col_copy)) || const_col.getContent().data() != const_col_copy.getContent().data()) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Values of the copy are not shared" << std::endl;
+		return false;
+	}
+	col_copy->update(42, boost::any(-1));
+	if (const_col.getContent().data() == const_col_copy.getContent().data() || (*col)[42] != reference_data[42] || (*col_copy)[42] != -1) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Update of the copy changed the original column" << std::endl;
+		return false;
+	}
+	//the arithmetic operations write through operator[], which has to duplicate shared values as well
+	boost::shared_ptr<Column<int> > col_arithmetic_copy = boost::static_pointer_cast<Column<int> >(col->copy());
+	col->minus(boost::any(100));
+	if (col_arithmetic_copy->getValue(0) != reference_data[0] || col->getValue(0) != reference_data[0] - 100) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Arithmetic on the column changed its copy" << std::endl;
+		return false;
+	}
+
+	std::vector<std::string> string_data(1000);
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > dictionary_col (new DictionaryCompressedColumn<std::string>("copy on write dictionary column", VARCHAR));
+	for (unsigned int i = 0; i < string_data.size(); i++) {
+		string_data[i] = get_rand_value<std::string>();
+	}
+	dictionary_col->insert(string_data.begin(), string_data.end());
+	boost::shared_ptr<DictionaryCompressedColumn<std::string> > dictionary_col_copy =
+		boost::static_pointer_cast<DictionaryCompressedColumn<std::string> >(dictionary_col->copy());
+	if (dictionary_col->getDictionary() != dictionary_col_copy->getDictionary()
+		|| !equals(string_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(dictionary_col_copy))) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Dictionary of the copy is not shared" << std::endl;
+		return false;
+	}
+	size_t number_of_distinct_values = dictionary_col->getDictionary()->size();
+	dictionary_col_copy->insert(std::string("only in the copy"));
+	dictionary_col->remove(0);
+	string_data.erase(string_data.begin());
+	if (dictionary_col->getDictionary() == dictionary_col_copy->getDictionary() || dictionary_col_copy->getDictionary()->size() != number_of_distinct_values + 1
+		|| dictionary_col->size() != string_data.size() || !equals(string_data, boost::shared_ptr<ColumnBaseTyped<std::string> >(dictionary_col))
+		|| (*dictionary_col_copy)[dictionary_col_copy->size() - 1] != "only in the copy") {
+		std::cerr << "COPY ON WRITE TEST FAILED! Modifications of the dictionary compressed columns are not private" << std::endl;
+		return false;
+	}
+	boost::shared_ptr<DictionaryCompressedColumn<int> > int_dictionary_col (new DictionaryCompressedColumn<int>("copy on write int dictionary column", INT));
+	for (int i = 0; i < 100; i++) {
+		int_dictionary_col->insert(i);
+	}
+	boost::shared_ptr<DictionaryCompressedColumn<int> > int_dictionary_col_copy =
+		boost::static_pointer_cast<DictionaryCompressedColumn<int> >(int_dictionary_col->copy());
+	int_dictionary_col->add(boost::any(100));
+	if (int_dictionary_col->getDictionary() == int_dictionary_col_copy->getDictionary()
+		|| int_dictionary_col->getValue(0) != 100 || int_dictionary_col_copy->getValue(0) != 0) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Arithmetic on the dictionary compressed column changed its copy" << std::endl;
+		return false;
+	}
+
+	boost::shared_ptr<DeltaCodingCompressedColumn<int> > delta_col (new DeltaCodingCompressedColumn<int>("copy on write delta column", INT));
+	delta_col->insert(reference_data.begin(), reference_data.end());
+	boost::shared_ptr<DeltaCodingCompressedColumn<int> > delta_col_copy =
+		boost::static_pointer_cast<DeltaCodingCompressedColumn<int> >(delta_col->copy());
+	const Column<int>& deltas = delta_col->column_;
+	const Column<int>& deltas_copy = delta_col_copy->column_;
+	if (deltas.getContent().data() != deltas_copy.getContent().data()) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Deltas of the copy are not shared" << std::endl;
+		return false;
+	}
+	delta_col_copy->insert(7);
+	if (delta_col->size() != reference_data.size() || delta_col_copy->size() != reference_data.size() + 1) {
+		std::cerr << "COPY ON WRITE TEST FAILED! Insert into the copy changed the original delta coded column" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_typed_point_access() {
+	/****** TYPED POINT ACCESS TEST ******/
+	std::cout << "TYPED POINT ACCESS TEST: read and modify single rows without boost::any...";
+	std::vector<int> reference_data(1000);
+	boost::shared_ptr<DeltaCodingCompressedColumn<int> > delta_col (new DeltaCodingCompressedColumn<int>("point access delta column", INT));
+	for (unsigned int i = 0; i < reference_data.size(); i++) {
+		reference_data[i] = rand() % 1000 - 500;
+		//boost::any values are delta coded like typed values
+		if (i % 2 == 0) delta_col->insert(reference_data[i]);
+		else delta_col->insert(boost::any(reference_data[i]));
+	}
+	//backward reads restart the decoding, forward reads continue it
+	for (unsigned int i = reference_data.size(); i > 0; i -= 7) {
+		if (delta_col->getValue(i - 1) != reference_data[i - 1] || delta_col->getValue(i / 2) != reference_data[i / 2]) {
+			std::cerr << "TYPED POINT ACCESS TEST FAILED! Wrong value in delta coded column" << std::endl;
+			return false;
+		}
+		if (i < 7) break;
+	}
+	//row 256 has a checkpoint
+	TID positions[] = {0, 256, 500, 999};
+	for (unsigned int i = 0; i < 4; i++) {
+		reference_data[positions[i]] = rand() % 1000;
+		if (!delta_col->update(positions[i], reference_data[positions[i]])) {
+			std::cerr << "TYPED POINT ACCESS TEST FAILED! Could not update delta coded column" << std::endl;
+			return false;
+		}
+	}
+	//the next delta is taken to the updated last value
+	reference_data.push_back(42);
+	delta_col->insert(42);
+	delta_col->remove(0);
+	delta_col->remove(499);
+	delta_col->remove(reference_data.size() - 3);
+	reference_data.erase(reference_data.begin());
+	reference_data.erase(reference_data.begin() + 499);
+	reference_data.erase(reference_data.end() - 1);
+	reference_data.push_back(7);
+	delta_col->insert(7);
+	//the removes invalidate the checkpoints behind them, backward reads use the recomputed checkpoints
+	for (unsigned int i = reference_data.size(); i > 0; i -= 5) {
+		if (delta_col->getValue(i - 1) != reference_data[i - 1] || delta_col->getValue(i / 3) != reference_data[i / 3]) {
+			std::cerr << "TYPED POINT ACCESS TEST FAILED! Wrong value after modifying delta coded column" << std::endl;
+			return false;
+		}
+		if (i < 5) break;
+	}
+	if (delta_col->size() != reference_data.size() || !equals(reference_data, boost::shared_ptr<ColumnBaseTyped<int> >(delta_col))
+		|| delta_col->remove(reference_data.size()) || delta_col->update(reference_data.size(), 1) || !delta_col->get(reference_data.size()).empty()) {
+		std::cerr << "TYPED POINT ACCESS TEST FAILED! Wrong values after modifying delta coded column" << std::endl;
+		return false;
+	}
+	boost::shared_ptr<DeltaCodingCompressedColumn<int> > single_row_col (new DeltaCodingCompressedColumn<int>("single row delta column", INT));
+	single_row_col->insert(5);
+	if (!single_row_col->remove(0) || single_row_col->size() != 0 || !single_row_col->insert(3) || single_row_col->getValue(0) != 3) {
+		std::cerr << "TYPED POINT ACCESS TEST FAILED! Could not remove the only row of delta coded column" << std::endl;
+		return false;
+	}
+
+	boost::shared_ptr<ColumnBaseTyped<std::string> > string_col (new DictionaryCompressedColumn<std::string>("point access string column", VARCHAR));
+	string_col->insert(std::string("first"));
+	string_col->insert(std::string("second"));
+	if (!string_col->update(1, std::string("third")) || string_col->getValue(1) != "third" || string_col->getValue(0) != "first") {
+		std::cerr << "TYPED POINT ACCESS TEST FAILED! Wrong value in dictionary compressed column" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+bool test_arithmetic_expression() {
+	/****** ARITHMETIC EXPRESSION TEST ******/
+	std::cout << "ARITHMETIC EXPRESSION TEST: compute a*b+c-2 over uncompressed and compressed columns...";
+	//more rows than one chunk and not a multiple of the chunk size
+	const unsigned int number_of_rows = 2 * expression_chunk_size + 123;
+	boost::shared_ptr<Column<int> > a (new Column<int>("a", INT));
+	boost::shared_ptr<DeltaCodingCompressedColumn<int> > b (new DeltaCodingCompressedColumn<int>("b", INT));
+	boost::shared_ptr<DictionaryCompressedColumn<int> > c (new DictionaryCompressedColumn<int>("c", INT));
+	std::vector<int> reference_a, reference_b, reference_c;
+	for (unsigned int i = 0; i < number_of_rows; i++) {
+		reference_a.push_back(rand() % 100);
+		reference_b.push_back(rand() % 100 - 50);
+		reference_c.push_back(rand() % 10);
+		a->insert(reference_a.back());
+		b->insert(reference_b.back());
+		c->insert(reference_c.back());
+	}
+	ArithmeticExpression<int>::ArithmeticExpressionPtr product = makeArithmeticExpression<int>(MULTIPLICATION,
+		makeColumnExpression<int>(a), makeColumnExpression<int>(b));
+	ArithmeticExpression<int>::ArithmeticExpressionPtr sum = makeArithmeticExpression<int>(ADDITION, product, makeColumnExpression<int>(c));
+	ArithmeticExpression<int>::ArithmeticExpressionPtr expression = makeArithmeticExpression<int>(SUBTRACTION, sum, makeConstantExpression<int>(2));
+	boost::shared_ptr<Column<int> > result = evaluateExpression(*expression, "a*b+c-2", INT);
+	if (!result || result->size() != number_of_rows) {
+		std::cerr << "ARITHMETIC EXPRESSION TEST FAILED! Result column has the wrong number of rows" << std::endl;
+		return false;
+	}
+	for (unsigned int i = 0; i < number_of_rows; i++) {
+		if (result->getValue(i) != reference_a[i] * reference_b[i] + reference_c[i] - 2) {
+			std::cerr << "ARITHMETIC EXPRESSION TEST FAILED! Wrong value in row " << i << std::endl;
+			return false;
+		}
+	}
+	//the input columns are not modified
+	if (!equals(reference_a, boost::shared_ptr<ColumnBaseTyped<int> >(a)) || !equals(reference_b, boost::shared_ptr<ColumnBaseTyped<int> >(b))
+		|| !equals(reference_c, boost::shared_ptr<ColumnBaseTyped<int> >(c))) {
+		std::cerr << "ARITHMETIC EXPRESSION TEST FAILED! Input column was modified" << std::endl;
+		return false;
+	}
+	//a bare column is copied, a constant has no number of rows, columns of different sizes are rejected
+	boost::shared_ptr<Column<int> > copy = evaluateExpression(*makeColumnExpression<int>(b), "b", INT);
+	boost::shared_ptr<Column<int> > short_col (new Column<int>("short", INT));
+	short_col->insert(1);
+	if (!copy || !equals(reference_b, boost::shared_ptr<ColumnBaseTyped<int> >(copy))
+		|| evaluateExpression(*makeConstantExpression<int>(1), "constant", INT)
+		|| makeArithmeticExpression<int>(ADDITION, makeColumnExpression<int>(a), makeColumnExpression<int>(short_col))) {
+		std::cerr << "ARITHMETIC EXPRESSION TEST FAILED! Wrong result for degenerate expression" << std::endl;
+		return false;
+	}
+	boost::shared_ptr<Column<float> > x (new Column<float>("x", FLOAT));
+	for (unsigned int i = 1; i <= 100; i++) x->insert(float(i));
+	boost::shared_ptr<Column<float> > quotient = evaluateExpression(*makeArithmeticExpression<float>(DIVISION,
+		makeColumnExpression<float>(x), makeConstantExpression<float>(4.0f)), "x/4", FLOAT);
+	if (!quotient || quotient->size() != 100 || quotient->getValue(9) != 2.5f) {
+		std::cerr << "ARITHMETIC EXPRESSION TEST FAILED! Wrong quotient" << std::endl;
+		return false;
+	}
+	//an integer division by zero or of the smallest int by -1 is rejected instead of terminating the program
+	boost::shared_ptr<Column<int> > divisor (new Column<int>("divisor", INT));
+	boost::shared_ptr<Column<int> > dividend (new Column<int>("dividend", INT));
+	for (unsigned int i = 0; i < 3000; i++) {
+		divisor->insert(i == 2500 ? 0 : int(i % 7) + 1);
+		dividend->insert(i == 2000 ? std::numeric_limits<int>::min() : int(i));
+	}
+	ArithmeticExpression<int>::ArithmeticExpressionPtr division = makeArithmeticExpression<int>(DIVISION, makeColumnExpression<int>(dividend),
+		makeColumnExpression<int>(divisor));
+	boost::shared_ptr<Column<int> > integer_quotient = evaluateExpression(*makeArithmeticExpression<int>(DIVISION, makeColumnExpression<int>(dividend),
+		makeConstantExpression<int>(-3)), "dividend/-3", INT);
+	if (evaluateExpression(*division, "dividend/divisor", INT) || evaluateExpression(*makeArithmeticExpression<int>(DIVISION,
+		makeColumnExpression<int>(dividend), makeConstantExpression<int>(-1)), "dividend/-1", INT)
+		|| !integer_quotient || integer_quotient->getValue(2999) != -999 || integer_quotient->getValue(2000) != std::numeric_limits<int>::min() / -3) {
+		std::cerr << "ARITHMETIC EXPRESSION TEST FAILED! Integer division by zero was not rejected" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+/*! \brief returns the pairs of join_tids sorted, so join results of different algorithms can be compared*/
+std::vector<std::pair<TID, TID> > getSortedPairs(PositionListPairPtr join_tids) {
+	std::vector<std::pair<TID, TID> > pairs;
+	for (TID i = 0; i < join_tids->first->size(); i++) {
+		pairs.push_back(std::make_pair((*join_tids->first)[i], (*join_tids->second)[i]));
+	}
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+bool test_column_statistics() {
+	/****** COLUMN STATISTICS TEST ******/
+	std::cout << "COLUMN STATISTICS TEST: estimate distinct values and selectivities and choose join algorithms...";
+	//more rows than the parallel scan needs
+	boost::shared_ptr<Column<int> > col (new Column<int>("statistics column", INT));
+	for (unsigned int i = 0; i < 3 * parallel_selection_block_size; i++) {
+		col->insert(rand() % 1000);
+	}
+	ColumnStatistics<int>::ColumnStatisticsPtr statistics = col->getStatistics();
+	size_t distinct_values = statistics->getNumberOfDistinctValues();
+	if (statistics->getNumberOfRows() != col->size() || statistics->getMinimum() != 0 || statistics->getMaximum() != 999
+		|| distinct_values < 900 || distinct_values > 1100 || statistics->getHistogram().size() != number_of_histogram_buckets
+		|| !std::is_sorted(statistics->getHistogram().begin(), statistics->getHistogram().end())) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong statistics" << std::endl;
+		return false;
+	}
+	double selectivity = statistics->estimateSelectivity(*makeComparison(LESSER, 250));
+	if (selectivity < 0.2 || selectivity > 0.3 || col->getStatistics() != statistics) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong selectivity estimate " << selectivity << std::endl;
+		return false;
+	}
+	//parallel scans return the rows in the same order as the serial scan
+	PositionListPtr serial_tids = col->ColumnBaseTyped<int>::predicate_selection(*makeComparison(LESSER, 250));
+	if (*col->selection(int(250), LESSER) != *serial_tids || *col->parallel_selection(int(250), LESSER, 4) != *serial_tids) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Parallel selection differs from serial selection" << std::endl;
+		return false;
+	}
+	//compressed columns, which decode without shared state, scan in parallel too
+	boost::shared_ptr<DictionaryCompressedColumn<int> > dictionary_col (new DictionaryCompressedColumn<int>("parallel dictionary column", INT));
+	for (TID i = 0; i < col->size(); i++) {
+		dictionary_col->insert(col->getValue(i));
+	}
+	if (*dictionary_col->parallel_selection(int(250), LESSER, 4) != *serial_tids) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Parallel selection of a compressed column differs from serial selection" << std::endl;
+		return false;
+	}
+	col->insert(5000);
+	if (col->getStatistics() == statistics || col->getStatistics()->getMaximum() != 5000) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Statistics were not invalidated by an insert" << std::endl;
+		return false;
+	}
+
+	//the statistics of a main delta column are maintained by the merges
+	boost::shared_ptr<MainDeltaColumn<int, DictionaryCompressedColumn> > main_delta_col (new MainDeltaColumn<int, DictionaryCompressedColumn>("main delta statistics column", INT, 100));
+	for (int i = 0; i < 1000; i++) {
+		main_delta_col->insert(i % 300 - 100);
+		if (i == 500) main_delta_col->getStatistics();
+	}
+	main_delta_col->merge();
+	statistics = main_delta_col->getStatistics();
+	distinct_values = statistics->getNumberOfDistinctValues();
+	if (statistics->getNumberOfRows() != 1000 || statistics->getMinimum() != -100 || statistics->getMaximum() != 199
+		|| distinct_values < 270 || distinct_values > 330) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong statistics of main delta column" << std::endl;
+		return false;
+	}
+
+	boost::shared_ptr<Column<int> > small_col (new Column<int>("small join column", INT));
+	boost::shared_ptr<Column<int> > sorted_col (new Column<int>("sorted join column", INT));
+	boost::shared_ptr<Column<int> > unsorted_col (new Column<int>("unsorted join column", INT));
+	for (int i = 0; i < 3; i++) small_col->insert(rand() % 100);
+	for (int i = 0; i < 20000; i++) {
+		sorted_col->insert(i / 4);
+		unsorted_col->insert(rand() % 5000);
+	}
+	if (small_col->chooseJoinAlgorithm(*unsorted_col) != NESTED_LOOP_JOIN || sorted_col->chooseJoinAlgorithm(*sorted_col) != SORT_MERGE_JOIN
+		|| sorted_col->chooseJoinAlgorithm(*unsorted_col) != HASH_JOIN) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong join algorithm" << std::endl;
+		return false;
+	}
+	std::vector<std::pair<TID, TID> > expected_pairs = getSortedPairs(sorted_col->hash_join(unsorted_col));
+	if (getSortedPairs(sorted_col->sort_merge_join(unsorted_col)) != expected_pairs || getSortedPairs(sorted_col->join(unsorted_col)) != expected_pairs
+		|| getSortedPairs(unsorted_col->join(sorted_col)) != getSortedPairs(unsorted_col->hash_join(sorted_col))
+		|| getSortedPairs(sorted_col->join(sorted_col)) != getSortedPairs(sorted_col->hash_join(sorted_col))
+		|| getSortedPairs(small_col->join(unsorted_col)) != getSortedPairs(small_col->hash_join(unsorted_col))) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong join result" << std::endl;
+		return false;
+	}
+	//a hash join builds on the larger column, if the smaller column has much more distinct values, so most probe rows are filtered out
+	boost::shared_ptr<Column<int> > low_cardinality_join_col (new Column<int>("low cardinality join column", INT));
+	boost::shared_ptr<Column<int> > unique_join_col (new Column<int>("unique join column", INT));
+	for (int i = 0; i < 100000; i++) low_cardinality_join_col->insert(i % 10);
+	for (int i = 0; i < 50000; i++) unique_join_col->insert(i);
+	if (!unique_join_col->isHashJoinBuildSide(*low_cardinality_join_col)) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong hash join build side without statistics" << std::endl;
+		return false;
+	}
+	low_cardinality_join_col->getStatistics();
+	unique_join_col->getStatistics();
+	if (!low_cardinality_join_col->isHashJoinBuildSide(*unique_join_col)
+		|| getSortedPairs(unique_join_col->join(low_cardinality_join_col)) != getSortedPairs(unique_join_col->hash_join(low_cardinality_join_col))) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong hash join build side with statistics" << std::endl;
+		return false;
+	}
+	//scans with more estimated matches use more threads
+	unsigned int few_matches_threads = col->estimateNumberOfSelectionThreads(*makeComparison(LESSER, 10));
+	unsigned int many_matches_threads = col->estimateNumberOfSelectionThreads(*makeComparison(LESSER, 1000));
+	if (small_col->estimateNumberOfSelectionThreads(*makeComparison(LESSER, 10)) != 1 || few_matches_threads < 1
+		|| many_matches_threads < few_matches_threads || many_matches_threads > getNumberOfAvailableThreads()) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Wrong number of selection threads" << std::endl;
+		return false;
+	}
+	//columns with disjoint value ranges are not joined
+	boost::shared_ptr<Column<int> > disjoint_col (new Column<int>("disjoint join column", INT));
+	for (int i = 0; i < 20000; i++) disjoint_col->insert(10000 + rand() % 5000);
+	unsorted_col->getStatistics();
+	disjoint_col->getStatistics();
+	if (!disjoint_col->join(unsorted_col)->first->empty()) {
+		std::cerr << "COLUMN STATISTICS TEST FAILED! Join of disjoint columns is not empty" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
+/*! \brief returns the rows of col with a value between lower and upper by a full scan*/
+PositionList scanRange(boost::shared_ptr<ColumnBaseTyped<int> > col, int lower, int upper) {
+	PositionList tids;
+	for (TID i = 0; i < col->size(); i++) {
+		if (lower <= col->getValue(i) && col->getValue(i) <= upper) tids.push_back(i);
+	}
+	return tids;
+}
+
+bool test_cracker_index() {
+	/****** CRACKER INDEX TEST ******/
+	std::cout << "CRACKER INDEX TEST: crack the index with range selections and keep it while the column changes...";
+	CrackerIndex<int> index;
+	std::vector<std::pair<int, TID> > entries;
+	for (TID i = 0; i < 1000; i++) {
+		entries.push_back(std::make_pair(rand() % 100, i));
+		index.insert(entries.back().first, i);
+	}
+	for (unsigned int query = 0; query < 100; query++) {
+		int lower = rand() % 100;
+		int upper = lower + rand() % 20;
+		//modify the cracked index between the lookups
+		if (query % 10 == 5) {
+			entries.push_back(std::make_pair(rand() % 100, entries.size()));
+			index.insert(entries.back().first, entries.back().second);
+			size_t removed = rand() % entries.size();
+			index.remove(entries[removed].first, entries[removed].second);
+			entries.erase(entries.begin() + removed);
+		}
+		PositionList expected_tids;
+		for (size_t i = 0; i < entries.size(); i++) {
+			if (lower <= entries[i].first && entries[i].first <= upper) expected_tids.push_back(entries[i].second);
+		}
+		std::sort(expected_tids.begin(), expected_tids.end());
+		if (*index.lookup(&lower, true, &upper, true) != expected_tids || index.size() != entries.size()) {
+			std::cerr << "CRACKER INDEX TEST FAILED! Wrong rows for range " << lower << " - " << upper << std::endl;
+			return false;
+		}
+	}
+	int bound = 50;
+	if (index.getNumberOfPieces() < 50 || index.lookup(&bound, false, &bound, false)->size() != 0) {
+		std::cerr << "CRACKER INDEX TEST FAILED! The lookups did not crack the index" << std::endl;
+		return false;
+	}
+
+	boost::shared_ptr<Column<int> > col (new Column<int>("cracked column", INT));
+	for (unsigned int i = 0; i < 5000; i++) col->insert(rand() % 1000);
+	if (!col->createIndex(CRACKER_INDEX) || !col->hasIndex(CRACKER_INDEX)) {
+		std::cerr << "CRACKER INDEX TEST FAILED! Could not create index" << std::endl;
+		return false;
+	}
+	for (unsigned int query = 0; query < 50; query++) {
+		int lower = rand() % 1000;
+		int upper = lower + rand() % 100;
+		if (query % 10 == 5) {
+			col->insert(rand() % 1000);
+			col->update(TID(rand() % col->size()), rand() % 1000);
+			col->remove(TID(rand() % col->size()));
+		}
+		PositionList expected_tids = scanRange(col, lower, upper);
+		PositionListPtr between_tids = col->predicate_selection(*makeBetween(lower, upper));
+		PositionListPtr lesser_tids = col->selection(lower, LESSER);
+		if (*between_tids != expected_tids || *lesser_tids != scanRange(col, std::numeric_limits<int>::min(), lower - 1)
+			|| *col->selection(upper, EQUAL) != scanRange(col, upper, upper)) {
+			std::cerr << "CRACKER INDEX TEST FAILED! Wrong selection on cracked column" << std::endl;
+			return false;
+		}
+	}
+	//removing many rows at once compacts the pieces, keeps the cracks and renumbers the remaining rows, [0,10) needs no new crack
+	CrackerIndex<int> batch_index;
+	std::vector<int> batch_values(2000);
+	for (TID i = 0; i < batch_values.size(); i++) {
+		batch_values[i] = rand() % 100;
+		batch_index.insert(batch_values[i], i);
+	}
+	for (int lower = 0; lower < 100; lower += 7) {
+		int upper = lower + 3;
+		batch_index.lookup(&lower, true, &upper, false);
+	}
+	size_t number_of_pieces = batch_index.getNumberOfPieces();
+	PositionList removed_tids;
+	std::vector<int> removed_values, remaining_values;
+	for (TID i = 0; i < batch_values.size(); i++) {
+		if (i % 3 == 0) {
+			removed_tids.push_back(i);
+			removed_values.push_back(batch_values[i]);
+		} else {
+			remaining_values.push_back(batch_values[i]);
+		}
+	}
+	batch_index.removeRows(removed_values, removed_tids);
+	for (int lower = 0; lower < 100; lower += 5) {
+		int upper = lower + 10;
+		PositionList expected_tids;
+		for (TID i = 0; i < remaining_values.size(); i++) {
+			if (lower <= remaining_values[i] && remaining_values[i] < upper) expected_tids.push_back(i);
+		}
+		if (*batch_index.lookup(&lower, true, &upper, false) != expected_tids) {
+			std::cerr << "CRACKER INDEX TEST FAILED! Wrong rows after removing many rows" << std::endl;
+			return false;
+		}
+		if (lower == 0 && (batch_index.getNumberOfPieces() != number_of_pieces || batch_index.size() != remaining_values.size())) {
+			std::cerr << "CRACKER INDEX TEST FAILED! Removing many rows changed the cracks" << std::endl;
+			return false;
+		}
+	}
+	PositionListPtr column_removed_tids (new PositionList());
+	for (TID i = 0; i < col->size(); i += 1 + rand() % 5) column_removed_tids->push_back(i);
+	col->remove(column_removed_tids);
+	if (*col->predicate_selection(*makeBetween(200, 600)) != scanRange(col, 200, 600)
+		|| *col->selection(100, LESSER) != scanRange(col, std::numeric_limits<int>::min(), 99)) {
+		std::cerr << "CRACKER INDEX TEST FAILED! Wrong selection after removing many rows" << std::endl;
+		return false;
+	}
+	std::cout << "SUCCESS"<< std::endl;
+	return true;
+}
+
 template<template<typename> class ColumnType, typename ValueType>
 bool unittest() {
 